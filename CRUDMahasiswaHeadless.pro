@@ -0,0 +1,13 @@
+# Headless build for Linux servers: core library, command line tool and tests.
+#   qmake CRUDMahasiswaHeadless.pro && make && make check
+# The GUI application (macOS) is still tutorialCRUDMahasiswa.pro.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    core \
+    cli \
+    tests
+
+cli.depends = core
+tests.depends = core
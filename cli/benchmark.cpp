@@ -0,0 +1,435 @@
+#include "benchmark.h"
+#include "syntheticstudents.h"
+#include "helpers/databasemanager.h"
+#include "helpers/perfcounters.h"
+#include "models/tablemodel.h"
+#include "modules/CSVExporter/csvexporter.h"
+#include "modules/PDFExporter/pdfexporter.h"
+#include <QSortFilterProxyModel>
+#include <QTemporaryDir>
+#include <QScopedPointer>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QThread>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <algorithm>
+
+namespace {
+// Rows per insertStudentsBatch call, same as the CSV importer default
+constexpr qsizetype INSERT_BATCH = 50000;
+}
+
+Benchmark::Benchmark()
+    : m_rowCounts({1000, 10000, 100000})
+    , m_iterations(3)
+    , m_pdfMaxRows(20000)
+{
+    for (int threads = 1; threads < QThread::idealThreadCount(); threads *= 2) {
+        m_layoutThreads.append(threads);
+    }
+    m_layoutThreads.append(QThread::idealThreadCount());
+}
+
+QStringList Benchmark::caseNames()
+{
+    return QStringList() << "insert" << "select" << "select-streamed"
+                         << "model-load" << "model-scroll" << "model-filter" << "model-sort"
+                         << "csv-export" << "pdf-render" << "pdf-layout-threads" << "pdf-text-cache";
+}
+
+void Benchmark::setRowCounts(const QList<qint64> &rowCounts)
+{
+    m_rowCounts = rowCounts;
+}
+
+void Benchmark::setIterations(int iterations)
+{
+    m_iterations = qMax(1, iterations);
+}
+
+void Benchmark::setCases(const QStringList &cases)
+{
+    m_cases = cases;
+}
+
+void Benchmark::setPdfMaxRows(qint64 rows)
+{
+    m_pdfMaxRows = qMax<qint64>(1, rows);
+}
+
+void Benchmark::setLayoutThreads(const QList<int> &threads)
+{
+    m_layoutThreads = threads;
+}
+
+bool Benchmark::run()
+{
+    m_results.clear();
+    m_lastError.clear();
+
+    for (const QString &name : std::as_const(m_cases)) {
+        if (!caseNames().contains(name)) {
+            m_lastError = "Unknown benchmark case: " + name;
+            return false;
+        }
+    }
+
+    for (qint64 rowCount : std::as_const(m_rowCounts)) {
+        if (!runRowCount(rowCount)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QList<Benchmark::Result> Benchmark::results() const
+{
+    return m_results;
+}
+
+bool Benchmark::writeJson(const QString &filePath) const
+{
+    QJsonArray results;
+    for (const Result &result : m_results) {
+        QJsonObject object;
+        object["case"] = result.name;
+        object["rows"] = result.rows;
+        object["iterations"] = result.iterations;
+        object["minMs"] = result.minMs;
+        object["medianMs"] = result.medianMs;
+        object["rowsPerSecond"] = result.rowsPerSecond;
+        object["threads"] = result.threads;
+        object["textCache"] = result.textCache;
+        object["bytes"] = result.bytes;
+        object["mbPerSecond"] = result.mbPerSecond;
+        object["pages"] = result.pages;
+        object["pagesPerSecond"] = result.pagesPerSecond;
+        object["peakRssBytes"] = result.peakRssBytes;
+        object["success"] = result.success;
+        results.append(object);
+    }
+
+    // Enough about the build and machine to tell two runs apart
+    QJsonObject root;
+    root["tool"] = "crudmahasiswa-cli bench";
+    root["version"] = APP_VERSION;
+    root["qtVersion"] = qVersion();
+    root["buildAbi"] = QSysInfo::buildAbi();
+    root["os"] = QSysInfo::prettyProductName();
+    root["cpuThreads"] = QThread::idealThreadCount();
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["results"] = results;
+
+    return writeOutput(filePath, QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
+
+bool Benchmark::writeCsv(const QString &filePath) const
+{
+    QByteArray csv = "case,rows,iterations,min_ms,median_ms,rows_per_second,threads,text_cache,"
+                     "bytes,mb_per_second,pages,pages_per_second,peak_rss_bytes,success\n";
+    for (const Result &result : m_results) {
+        csv += result.name.toUtf8() + ','
+             + QByteArray::number(result.rows) + ','
+             + QByteArray::number(result.iterations) + ','
+             + QByteArray::number(result.minMs, 'f', 3) + ','
+             + QByteArray::number(result.medianMs, 'f', 3) + ','
+             + QByteArray::number(result.rowsPerSecond, 'f', 0) + ','
+             + QByteArray::number(result.threads) + ','
+             + QByteArray::number(result.textCache) + ','
+             + QByteArray::number(result.bytes) + ','
+             + QByteArray::number(result.mbPerSecond, 'f', 2) + ','
+             + QByteArray::number(result.pages) + ','
+             + QByteArray::number(result.pagesPerSecond, 'f', 1) + ','
+             + QByteArray::number(result.peakRssBytes) + ','
+             + (result.success ? "1" : "0") + '\n';
+    }
+
+    return writeOutput(filePath, csv);
+}
+
+QString Benchmark::getLastError() const
+{
+    return m_lastError;
+}
+
+void Benchmark::measure(const QString &name, qint64 rows,
+                        const std::function<void()> &setup,
+                        const std::function<bool()> &body,
+                        const std::function<void(Result &)> &annotate)
+{
+    Result result;
+    result.name = name;
+    result.rows = rows;
+    result.iterations = m_iterations;
+
+    QVector<double> times;
+    times.reserve(m_iterations);
+
+    // Without a reset (non-Linux) this is the peak of the whole run so far
+    PerfCounters::resetPeakResidentMemory();
+
+    for (int i = 0; i < m_iterations; ++i) {
+        if (setup) {
+            setup();
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        const bool ok = body();
+        times.append(timer.nsecsElapsed() / 1e6);
+
+        result.success = result.success && ok;
+    }
+
+    std::sort(times.begin(), times.end());
+    result.minMs = times.first();
+    result.medianMs = times.size() % 2 ? times[times.size() / 2]
+                                       : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2;
+    result.rowsPerSecond = result.medianMs > 0 ? rows * 1000.0 / result.medianMs : 0;
+    result.peakRssBytes = PerfCounters::peakResidentMemoryBytes();
+
+    if (annotate) {
+        annotate(result);
+    }
+
+    QTextStream out(stderr);
+    out << "bench: " << name;
+    if (result.threads > 0) {
+        out << " threads=" << result.threads;
+    }
+    if (result.textCache >= 0) {
+        out << " text-cache=" << result.textCache;
+    }
+    out << " " << rows << " rows: median " << QString::number(result.medianMs, 'f', 1) << " ms, min "
+        << QString::number(result.minMs, 'f', 1) << " ms (" << qRound64(result.rowsPerSecond) << " rows/s";
+    if (result.bytes > 0) {
+        out << ", " << QString::number(result.mbPerSecond, 'f', 1) << " MB/s";
+    }
+    if (result.pages > 0) {
+        out << ", " << QString::number(result.pagesPerSecond, 'f', 1) << " pages/s";
+    }
+    if (result.peakRssBytes >= 0) {
+        out << ", peak RSS " << result.peakRssBytes / (1024 * 1024) << " MB";
+    }
+    out << ")" << (result.success ? "" : " FAILED") << Qt::endl;
+
+    m_results.append(result);
+}
+
+void Benchmark::setOutput(Result &result, qint64 bytes, int pages)
+{
+    result.bytes = bytes;
+    result.pages = pages;
+    if (result.medianMs > 0) {
+        result.mbPerSecond = bytes / (1024.0 * 1024.0) * 1000.0 / result.medianMs;
+        result.pagesPerSecond = pages * 1000.0 / result.medianMs;
+    }
+}
+
+bool Benchmark::runRowCount(qint64 rowCount)
+{
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        m_lastError = "Cannot create a temporary directory";
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<StudentsDataStruct> rows = SyntheticStudents().generate(rowCount);
+    QTextStream(stderr) << "bench: generated " << rowCount << " rows in " << timer.elapsed() << " ms" << Qt::endl;
+
+    const QString dbPath = dir.filePath("bench.db");
+    const QStringList columns = QStringList() << "id" << "nama" << "npm" << "kelas";
+    QScopedPointer<DatabaseManager> db;
+
+    auto freshDatabase = [&]() {
+        db.reset(); // closes the default connection before the file goes
+        QFile::remove(dbPath);
+        QFile::remove(dbPath + "-journal");
+        db.reset(new DatabaseManager(dbPath));
+    };
+
+    // One transaction, batches like the CSV importer
+    auto insertAll = [&]() {
+        if (!db->beginTransaction()) {
+            return false;
+        }
+        for (qsizetype i = 0; i < rows.size(); i += INSERT_BATCH) {
+            if (!db->insertStudentsBatch("mahasiswa", rows.mid(i, INSERT_BATCH))) {
+                db->rollbackTransaction();
+                return false;
+            }
+        }
+        return db->commitTransaction();
+    };
+
+    if (isSelected("insert")) {
+        measure("insert", rowCount, freshDatabase, insertAll);
+    } else {
+        freshDatabase();
+        insertAll();
+    }
+
+    if (!db->isDatabaseOpen()) {
+        m_lastError = "Cannot open the benchmark database " + dbPath;
+        return false;
+    }
+
+    QList<StudentsDataStruct> selected;
+    auto selectAll = [&]() {
+        selected = db->selectRecords("mahasiswa", columns);
+        return selected.size() == rowCount;
+    };
+
+    if (isSelected("select")) {
+        measure("select", rowCount, nullptr, selectAll);
+    } else {
+        selectAll();
+    }
+
+    if (isSelected("select-streamed")) {
+        measure("select-streamed", rowCount, nullptr, [&]() {
+            qint64 count = 0;
+            const bool ok = db->selectRecordsStreamed("mahasiswa", "", QVariantMap {},
+                [&count](const StudentsDataStruct &) {
+                    ++count;
+                    return true;
+                });
+            return ok && count == rowCount;
+        });
+    }
+
+    // Same setup as the main window: TableModel behind a QSortFilterProxyModel
+    TableModel model;
+    model.setColumns(QStringList() << "Nama" << "NPM" << "Kelas");
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    auto loadModel = [&]() {
+        model.setTableData(selected);
+        return model.rowCount() == rowCount;
+    };
+
+    if (isSelected("model-load")) {
+        measure("model-load", rowCount, [&]() { model.setTableData({}); }, loadModel);
+    } else {
+        loadModel();
+    }
+
+    if (isSelected("model-scroll")) {
+        // Every cell once through the proxy, as a view scrolled top to bottom reads them
+        measure("model-scroll", rowCount, nullptr, [&]() {
+            qsizetype characters = 0;
+            const int columnCount = proxy.columnCount();
+            for (int row = 0; row < proxy.rowCount(); ++row) {
+                for (int column = 0; column < columnCount; ++column) {
+                    characters += proxy.data(proxy.index(row, column)).toString().size();
+                }
+            }
+            return characters > 0;
+        });
+    }
+
+    if (isSelected("model-filter")) {
+        measure("model-filter", rowCount,
+                [&]() { proxy.setFilterRegularExpression(QString()); },
+                [&]() {
+                    proxy.setFilterRegularExpression("Sari");
+                    return proxy.rowCount() <= rowCount;
+                });
+        proxy.setFilterRegularExpression(QString());
+    }
+
+    if (isSelected("model-sort")) {
+        measure("model-sort", rowCount,
+                [&]() { proxy.sort(-1); },
+                [&]() {
+                    proxy.sort(0, Qt::AscendingOrder);
+                    return proxy.rowCount() == rowCount;
+                });
+        proxy.sort(-1);
+    }
+
+    if (isSelected("csv-export")) {
+        CSVExporter exporter;
+        exporter.setDelimiter(";");
+        exporter.setFilePath(dir.filePath("bench.csv"));
+
+        measure("csv-export", rowCount, nullptr,
+                [&]() { return exporter.exportRows(selected, StudentsRowAdapter(), columns); },
+                [&](Result &result) { setOutput(result, QFileInfo(dir.filePath("bench.csv")).size(), 0); });
+    }
+
+    // Capped, a PDF of millions of rows says nothing the smaller one does not
+    const qint64 pdfRows = qMin(rowCount, m_pdfMaxRows);
+    const QList<StudentsDataStruct> pdfData = selected.mid(0, pdfRows);
+    const QString pdfPath = dir.filePath("bench.pdf");
+
+    auto measurePdf = [&](const QString &name, int threads, int textCache) {
+        PDFExporter exporter;
+        exporter.setTitle("Benchmark");
+        exporter.setTableHeaders(columns);
+        exporter.setTableRows(pdfData, StudentsRowAdapter());
+        exporter.setRenderBackend(PDFExporter::PainterBackend);
+        exporter.setLayoutThreadCount(threads);
+        exporter.setTextCacheSize(textCache);
+
+        measure(name, pdfRows, nullptr,
+                [&]() { return exporter.exportToPdf(pdfPath); },
+                [&](Result &result) {
+                    result.threads = threads;
+                    result.textCache = textCache;
+                    setOutput(result, QFileInfo(pdfPath).size(), exporter.lastExportPageCount());
+                });
+    };
+
+    if (isSelected("pdf-render")) {
+        measurePdf("pdf-render", 0, 4096);
+    }
+
+    if (isSelected("pdf-layout-threads")) {
+        for (int threads : std::as_const(m_layoutThreads)) {
+            measurePdf("pdf-layout-threads", threads, 4096);
+        }
+    }
+
+    if (isSelected("pdf-text-cache")) {
+        measurePdf("pdf-text-cache", 0, 4096);
+        measurePdf("pdf-text-cache", 0, 0);
+    }
+
+    return true;
+}
+
+bool Benchmark::isSelected(const QString &name) const
+{
+    return m_cases.isEmpty() || m_cases.contains(name);
+}
+
+bool Benchmark::writeOutput(const QString &filePath, const QByteArray &data) const
+{
+    if (filePath.isEmpty() || filePath == "-") {
+        QFile out;
+        if (!out.open(stdout, QIODevice::WriteOnly) || out.write(data) != data.size()) {
+            m_lastError = "Cannot write to stdout";
+            return false;
+        }
+        return true;
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        m_lastError = "Cannot write " + filePath + ": " + file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include <functional>
+
+// Benchmarks of the core code on synthetic data (see SyntheticStudents), run
+// by "crudmahasiswa-cli bench". Every case runs on a fresh database in a
+// temporary directory for each row count; results are written as JSON or
+// CSV so runs of two builds can be compared.
+//
+// Cases: insert, select, select-streamed, model-load, model-scroll,
+// model-filter, model-sort, csv-export, pdf-render, pdf-layout-threads
+// (pdf-render at 1, 2, 4, ... layout threads) and pdf-text-cache (on/off)
+class Benchmark
+{
+public:
+    struct Result
+    {
+        QString name;
+        qint64 rows = 0;
+        int iterations = 0;
+        double minMs = 0;
+        double medianMs = 0;
+        double rowsPerSecond = 0; // from the median
+        int threads = 0;          // layout threads of the pdf cases, 0 = not applicable
+        int textCache = -1;       // text cache entries of the pdf cases, -1 = not applicable
+        qint64 bytes = 0;         // output file size, 0 = no file
+        double mbPerSecond = 0;   // bytes over the median
+        int pages = 0;
+        double pagesPerSecond = 0;
+        qint64 peakRssBytes = -1; // peak resident memory during the case, -1 = unknown
+        bool success = true;
+    };
+
+    Benchmark();
+
+    static QStringList caseNames();
+
+    void setRowCounts(const QList<qint64> &rowCounts); // default: 1000, 10000, 100000
+    void setIterations(int iterations);                // default: 3
+    void setCases(const QStringList &cases);           // empty = all
+    void setPdfMaxRows(qint64 rows);                   // pdf-render is capped, default: 20000
+    void setLayoutThreads(const QList<int> &threads);  // pdf-layout-threads, default: 1, 2, 4, ... cores
+
+    bool run();
+
+    QList<Result> results() const;
+
+    // filePath "-" writes to stdout
+    bool writeJson(const QString &filePath) const;
+    bool writeCsv(const QString &filePath) const;
+
+    QString getLastError() const;
+
+private:
+    // setup runs before every iteration and is not timed, body is.
+    // annotate fills the case specific fields before the result is reported.
+    void measure(const QString &name, qint64 rows,
+                 const std::function<void()> &setup,
+                 const std::function<bool()> &body,
+                 const std::function<void(Result &)> &annotate = nullptr);
+    static void setOutput(Result &result, qint64 bytes, int pages);
+    bool runRowCount(qint64 rowCount);
+    bool isSelected(const QString &name) const;
+    bool writeOutput(const QString &filePath, const QByteArray &data) const;
+
+    QList<qint64> m_rowCounts;
+    int m_iterations;
+    QStringList m_cases;
+    qint64 m_pdfMaxRows;
+    QList<int> m_layoutThreads;
+    QList<Result> m_results;
+    mutable QString m_lastError;
+};
+
+#endif // BENCHMARK_H
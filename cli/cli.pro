@@ -0,0 +1,29 @@
+TEMPLATE = app
+TARGET = crudmahasiswa-cli
+
+QT -= widgets
+
+CONFIG += c++17 console release
+CONFIG -= app_bundle
+
+VERSION += 1.0
+
+DEFINES += APP_NAME=\\\"CRUDMahasiswa\\\"
+DEFINES += APP_VERSION=\\\"$$VERSION\\\"
+
+include(../core/corelib.pri)
+
+SOURCES += \
+    benchmark.cpp \
+    clicommands.cpp \
+    main.cpp \
+    syntheticstudents.cpp
+
+HEADERS += \
+    benchmark.h \
+    clicommands.h \
+    syntheticstudents.h
+
+# Default rules for deployment.
+unix: target.path = /opt/crudmahasiswa/bin
+!isEmpty(target.path): INSTALLS += target
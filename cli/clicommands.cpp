@@ -0,0 +1,373 @@
+#include "clicommands.h"
+#include "modules/CSVExporter/csvexporter.h"
+#include "modules/CSVImporter/csvimporter.h"
+#include "modules/PDFExporter/pdfexporter.h"
+#include "modules/PDFExporter/reportbatchjob.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QEventLoop>
+
+namespace {
+double perSecond(qint64 count, qint64 ms)
+{
+    return ms > 0 ? count * 1000.0 / ms : 0.0;
+}
+}
+
+CliCommands::CliCommands(const QString &databasePath)
+    : m_databasePath(databasePath)
+    , m_out(stdout)
+    , m_err(stderr)
+{
+}
+
+QString CliCommands::defaultDatabasePath()
+{
+    return QString("%1/%2/%3").arg(QDir::homePath(), AppEnv::APP_HOMEDIR_NAME, AppEnv::APP_DATABASE_NAME);
+}
+
+bool CliCommands::openDatabase()
+{
+    if (!m_db.isNull()) {
+        return m_db->isDatabaseOpen();
+    }
+
+    // Same layout as the GUI: the directory is created on first use
+    QDir().mkpath(QFileInfo(m_databasePath).absolutePath());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    m_db.reset(new DatabaseManager(m_databasePath));
+    if (!m_db->isDatabaseOpen()) {
+        m_err << "error: cannot open database " << m_databasePath << Qt::endl;
+        return false;
+    }
+
+    m_err << "open: " << m_databasePath << " in " << timer.elapsed() << " ms" << Qt::endl;
+    return true;
+}
+
+int CliCommands::importCsv(const QString &filePath, const QString &delimiter,
+                           DatabaseManager::ConflictPolicy policy, int threads)
+{
+    if (!openDatabase()) {
+        return 1;
+    }
+
+    CSVImporter importer;
+    importer.setDelimiter(delimiter);
+    importer.setFilePath(filePath);
+    importer.setConflictPolicy(policy);
+    importer.setThreadCount(threads);
+
+    const bool success = importer.importData(m_db.get(), "mahasiswa");
+    const CSVImporter::ImportStats stats = importer.getLastStats();
+
+    for (const QString &rejected : importer.getRejectedRows()) {
+        m_err << "rejected: " << rejected << Qt::endl;
+    }
+
+    m_err << "import: " << stats.rowsRead << " rows read, " << stats.rowsInserted << " written, "
+          << stats.rowsSkipped << " skipped, " << stats.rowsRejected << " rejected in "
+          << stats.elapsedMs << " ms (parse " << stats.parseMs << " ms, insert " << stats.insertMs
+          << " ms, " << qRound64(perSecond(stats.rowsRead, stats.elapsedMs)) << " rows/s)" << Qt::endl;
+
+    if (!success) {
+        m_err << "error: " << importer.getLastError() << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int CliCommands::exportCsv(const QString &filePath, const QString &delimiter,
+                           qint64 maxRowsPerPart, qint64 maxBytesPerPart, int threads)
+{
+    if (!openDatabase()) {
+        return 1;
+    }
+
+    QStringList columns;
+    columns << "id" << "nama" << "npm" << "kelas";
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QList<StudentsDataStruct> rows = m_db->selectRecords("mahasiswa", columns, "", QVariantMap {});
+    const qint64 selectMs = timer.elapsed();
+
+    CSVExporter exporter;
+    exporter.setDelimiter(delimiter);
+    exporter.setFilePath(filePath);
+
+    const bool split = maxRowsPerPart > 0 || maxBytesPerPart > 0;
+    bool success = false;
+    if (split) {
+        exporter.setMaxRowsPerPart(maxRowsPerPart);
+        exporter.setMaxBytesPerPart(maxBytesPerPart);
+        exporter.setThreadCount(threads);
+        success = exporter.exportRowsToParts(rows, StudentsRowAdapter(), columns);
+    } else {
+        success = exporter.exportRows(rows, StudentsRowAdapter(), columns);
+    }
+    const qint64 elapsed = timer.elapsed();
+
+    m_err << "export-csv: " << rows.size() << " rows to " << filePath << " in " << elapsed
+          << " ms (select " << selectMs << " ms, write " << elapsed - selectMs << " ms, "
+          << qRound64(perSecond(rows.size(), elapsed)) << " rows/s)" << Qt::endl;
+
+    if (split && success) {
+        for (const QString &part : exporter.getLastPartFiles()) {
+            m_err << "part: " << part << Qt::endl;
+        }
+        m_err << "manifest: " << exporter.getLastManifestPath() << Qt::endl;
+    }
+
+    if (!success) {
+        m_err << "error: " << exporter.getLastError() << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int CliCommands::exportChanges(const QString &filePath, const QString &delimiter, const QString &exportName)
+{
+    if (!openDatabase()) {
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 sinceSeq = -1;
+    if (!m_db->exportWatermark(exportName, sinceSeq)) {
+        m_err << "error: cannot read the watermark of " << exportName << Qt::endl;
+        return 1;
+    }
+
+    CSVExporter exporter;
+    exporter.setDelimiter(delimiter);
+    exporter.setFilePath(filePath);
+
+    const bool success = exporter.exportChanges(m_db.get(), exportName);
+
+    qint64 upToSeq = -1;
+    m_db->exportWatermark(exportName, upToSeq);
+
+    m_err << "export-changes: " << exportName << " since seq " << sinceSeq << " now at seq "
+          << upToSeq << " to " << filePath << " in " << timer.elapsed()
+          << " ms" << Qt::endl;
+
+    if (!success) {
+        m_err << "error: " << exporter.getLastError() << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int CliCommands::exportPdf(const QString &filePath, const QString &title)
+{
+    if (!openDatabase()) {
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    PDFExporter exporter;
+    exporter.setTitle(title);
+    exporter.setTableHeaders(QStringList() << "id" << "nama" << "npm" << "kelas");
+
+    if (!exporter.openExport(filePath)) {
+        m_err << "error: cannot create " << filePath << Qt::endl;
+        return 1;
+    }
+
+    // Rows go from the cursor straight onto the page, memory stays flat
+    bool written = true;
+    const bool read = m_db->selectRecordsStreamed("mahasiswa", "", QVariantMap {},
+        [&](const StudentsDataStruct &student) {
+            written = exporter.writeRow(student, StudentsRowAdapter());
+            return written;
+        });
+
+    if (!read || !written) {
+        exporter.cancelExport();
+        m_err << "error: failed to write " << filePath << Qt::endl;
+        return 1;
+    }
+
+    if (!exporter.closeExport()) {
+        m_err << "error: failed to write " << filePath << Qt::endl;
+        return 1;
+    }
+
+    const qint64 elapsed = timer.elapsed();
+    m_err << "export-pdf: " << exporter.lastExportRowCount() << " rows on " << exporter.lastExportPageCount()
+          << " pages to " << filePath << " in " << elapsed << " ms ("
+          << qRound64(perSecond(exporter.lastExportPageCount(), elapsed)) << " pages/s)" << Qt::endl;
+    return 0;
+}
+
+int CliCommands::exportHtml(const QString &filePath, const QString &title, const QString &rowTemplatePath)
+{
+    QStringList columns;
+    columns << "id" << "nama" << "npm" << "kelas";
+
+    PDFExporter exporter;
+    exporter.setTitle(title);
+    exporter.setTableHeaders(columns);
+
+    if (!rowTemplatePath.isEmpty()) {
+        QFile templateFile(rowTemplatePath);
+        if (!templateFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            m_err << "error: cannot read " << rowTemplatePath << ": " << templateFile.errorString() << Qt::endl;
+            return 1;
+        }
+        if (!exporter.setRowTemplate(QString::fromUtf8(templateFile.readAll()))) {
+            m_err << "error: invalid row template " << rowTemplatePath << Qt::endl;
+            return 1;
+        }
+    }
+
+    if (!openDatabase()) {
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QList<StudentsDataStruct> rows = m_db->selectRecords("mahasiswa", columns, "", QVariantMap {});
+    const qint64 selectMs = timer.elapsed();
+
+    exporter.setTableRows(rows, StudentsRowAdapter());
+    if (!exporter.exportToHtml(filePath)) {
+        m_err << "error: failed to write " << filePath << Qt::endl;
+        return 1;
+    }
+
+    const qint64 elapsed = timer.elapsed();
+    m_err << "export-html: " << rows.size() << " rows to " << filePath << " in " << elapsed
+          << " ms (select " << selectMs << " ms, write " << elapsed - selectMs << " ms, "
+          << qRound64(perSecond(rows.size(), elapsed)) << " rows/s)" << Qt::endl;
+    return 0;
+}
+
+int CliCommands::exportPdfBatch(const QString &directory, int threads)
+{
+    if (!openDatabase()) {
+        return 1;
+    }
+
+    QList<StudentsGroupStruct> groups;
+    if (!m_db->selectGroupSummary("mahasiswa", groups)) {
+        m_err << "error: cannot read the kelas list" << Qt::endl;
+        return 1;
+    }
+
+    QDir().mkpath(directory);
+
+    ReportBatchJob job;
+    job.setDatabasePath(m_databasePath);
+    job.setThreadCount(threads);
+
+    QEventLoop loop;
+    bool success = false;
+
+    QObject::connect(&job, &ReportBatchJob::fileFinished, &loop,
+                     [this](const ReportBatchFile &file, int done, int total) {
+                         m_err << "[" << done << "/" << total << "] " << QFileInfo(file.filePath).fileName()
+                               << ": " << file.rows << " rows, " << file.pages << " pages, "
+                               << file.elapsedMs << " ms" << (file.success ? QString() : " FAILED: " + file.error)
+                               << Qt::endl;
+                     });
+    QObject::connect(&job, &ReportBatchJob::finished, &loop,
+                     [&loop, &success](bool ok, bool cancelled) {
+                         Q_UNUSED(cancelled)
+                         success = ok;
+                         loop.quit();
+                     });
+
+    if (!job.start(groups, directory)) {
+        m_err << "error: " << job.getLastError() << Qt::endl;
+        return 1;
+    }
+    loop.exec();
+
+    const QList<ReportBatchFile> files = job.results();
+    int pages = 0;
+    for (const ReportBatchFile &file : files) {
+        pages += file.pages;
+    }
+
+    m_err << "export-pdf-batch: " << files.size() << " files, " << pages << " pages in " << job.elapsedMs()
+          << " ms (" << QString::number(perSecond(files.size(), job.elapsedMs()), 'f', 1) << " files/s), summary "
+          << job.summaryFilePath() << Qt::endl;
+
+    if (!success) {
+        m_err << "error: " << job.getLastError() << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int CliCommands::query(const QString &condition, qint64 limit)
+{
+    if (!openDatabase()) {
+        return 1;
+    }
+
+    QString sql = condition;
+    if (limit > 0) {
+        sql = QString("%1 LIMIT %2").arg(sql.isEmpty() ? QString("1") : sql).arg(limit);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Tab separated, one row per line, for piping into other tools
+    qint64 rows = 0;
+    const bool success = m_db->selectRecordsStreamed("mahasiswa", sql, QVariantMap {},
+        [&](const StudentsDataStruct &student) {
+            m_out << student.id << '\t' << student.nama << '\t' << student.npm << '\t' << student.kelas << '\n';
+            ++rows;
+            return true;
+        });
+    m_out.flush();
+
+    m_err << "query: " << rows << " rows in " << timer.elapsed() << " ms" << Qt::endl;
+
+    if (!success) {
+        m_err << "error: query failed" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int CliCommands::groupSummary()
+{
+    if (!openDatabase()) {
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<StudentsGroupStruct> groups;
+    if (!m_db->selectGroupSummary("mahasiswa", groups)) {
+        m_err << "error: query failed" << Qt::endl;
+        return 1;
+    }
+
+    qint64 total = 0;
+    for (const StudentsGroupStruct &group : groups) {
+        m_out << group.kelas << '\t' << group.count << '\n';
+        total += group.count;
+    }
+    m_out.flush();
+
+    m_err << "summary: " << groups.size() << " kelas, " << total << " mahasiswa in " << timer.elapsed() << " ms" << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef CLICOMMANDS_H
+#define CLICOMMANDS_H
+
+#include <QString>
+#include <QScopedPointer>
+#include <QTextStream>
+#include "helpers/Environments.h"
+#include "helpers/databasemanager.h"
+
+// Subcommands of crudmahasiswa-cli. Each one returns the exit code of the
+// process; results (query rows) go to stdout, progress and timing to stderr
+// so they can be piped separately.
+class CliCommands
+{
+public:
+    explicit CliCommands(const QString &databasePath);
+
+    // Default database of the GUI application (~/.crudMahasiswa/dataMahasiswa.db)
+    static QString defaultDatabasePath();
+
+    int importCsv(const QString &filePath, const QString &delimiter,
+                  DatabaseManager::ConflictPolicy policy, int threads);
+    // maxRowsPerPart/maxBytesPerPart > 0 split the file into numbered parts plus a manifest
+    int exportCsv(const QString &filePath, const QString &delimiter,
+                  qint64 maxRowsPerPart = 0, qint64 maxBytesPerPart = 0, int threads = 0);
+    // Rows changed since the previous run of exportName (first run: every row)
+    int exportChanges(const QString &filePath, const QString &delimiter, const QString &exportName);
+    int exportPdf(const QString &filePath, const QString &title);
+    int exportPdfBatch(const QString &directory, int threads);
+    // rowTemplatePath: file with the HtmlRowTemplate of one row (empty = one cell per column)
+    int exportHtml(const QString &filePath, const QString &title, const QString &rowTemplatePath);
+
+    // condition: SQL after WHERE (empty = all rows), limit <= 0 = no limit
+    int query(const QString &condition, qint64 limit);
+    int groupSummary();
+
+private:
+    bool openDatabase();
+
+    QString m_databasePath;
+    QScopedPointer<DatabaseManager> m_db;
+    QTextStream m_out;
+    QTextStream m_err;
+};
+
+#endif // CLICOMMANDS_H
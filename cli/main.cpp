@@ -0,0 +1,232 @@
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <memory>
+#include "clicommands.h"
+#include "benchmark.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+
+// Headless entry point for servers:
+//   crudmahasiswa-cli import <file.csv> [--on-conflict skip|update|abort]
+//   crudmahasiswa-cli export-csv <file.csv> [--max-rows-per-part <n>] [--max-bytes-per-part <n>]
+//                         [--threads <n>]
+//   crudmahasiswa-cli export-changes <file.csv> [--export-name <name>]
+//   crudmahasiswa-cli export-pdf <file.pdf> [--title <title>]
+//   crudmahasiswa-cli export-pdf-batch <directory>
+//   crudmahasiswa-cli export-html <file.html> [--title <title>] [--row-template <file>]
+//   crudmahasiswa-cli query [--where <condition>] [--limit <n>]
+//   crudmahasiswa-cli summary
+//   crudmahasiswa-cli bench [--rows 1000,100000] [--cases insert,select] [--layout-threads 1,2,4]
+//                         [--format json|csv] [--output <file>]
+
+namespace {
+bool needsFonts(const QString &command)
+{
+    return command.startsWith("export-pdf") || command == "bench";
+}
+
+// Writes the recorded spans when main() returns, whichever command ran
+struct TraceDump
+{
+    QString filePath;
+
+    ~TraceDump()
+    {
+        QString error;
+        if (!filePath.isEmpty() && !Tracer::writeChromeTrace(filePath, &error)) {
+            QTextStream(stderr) << "error: cannot write trace " << filePath << ": " << error << Qt::endl;
+        }
+    }
+};
+}
+
+int main(int argc, char *argv[])
+{
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("command", "import, export-csv, export-changes, export-pdf, export-pdf-batch, "
+                                            "export-html, query, summary or bench");
+    parser.addPositionalArgument("path", "Input file, output file or output directory of the command");
+
+    QCommandLineOption dbOption("db", "SQLite database (default: " + CliCommands::defaultDatabasePath() + ")",
+                                "file", CliCommands::defaultDatabasePath());
+    QCommandLineOption delimiterOption("delimiter", "CSV delimiter (default: ;)", "delimiter", ";");
+    QCommandLineOption conflictOption("on-conflict", "Existing nama on import: skip, update or abort (default: skip)",
+                                      "policy", "skip");
+    QCommandLineOption threadsOption("threads", "Worker threads (default: 0 = one per core)", "count", "0");
+    QCommandLineOption partRowsOption("max-rows-per-part", "Split export-csv into parts of at most this many rows "
+                                      "(default: 0 = one file)", "rows", "0");
+    QCommandLineOption partBytesOption("max-bytes-per-part", "Split export-csv into parts of at most this many bytes "
+                                       "(default: 0 = one file)", "bytes", "0");
+    QCommandLineOption exportNameOption("export-name", "Watermark of export-changes, one per consumer (default: csv-changes)",
+                                        "name", "csv-changes");
+    QCommandLineOption titleOption("title", "Report title", "title", "Laporan Mahasiswa");
+    QCommandLineOption rowTemplateOption("row-template", "export-html row template file, placeholders {{0}}.. "
+                                         "{{zebra}} {{row}} (default: one cell per column)", "file");
+    QCommandLineOption whereOption("where", "SQL condition for query, e.g. \"kelas = 'TI-1A'\"", "condition");
+    QCommandLineOption limitOption("limit", "Maximum rows for query", "rows", "0");
+    QCommandLineOption rowsOption("rows", "Row counts for bench, comma separated (default: 1000,10000,100000)",
+                                  "counts", "1000,10000,100000");
+    QCommandLineOption iterationsOption("iterations", "Runs of every bench case (default: 3)", "count", "3");
+    QCommandLineOption casesOption("cases", "Bench cases, comma separated (default: all of "
+                                   + Benchmark::caseNames().join(',') + ")", "cases");
+    QCommandLineOption pdfRowsOption("pdf-max-rows", "Row cap of the pdf-render bench case (default: 20000)", "rows", "20000");
+    QCommandLineOption layoutThreadsOption("layout-threads", "Thread counts of the pdf-layout-threads bench case, "
+                                           "comma separated (default: 1,2,4,... up to one per core)", "counts");
+    QCommandLineOption formatOption("format", "Bench output: json or csv (default: json)", "format", "json");
+    QCommandLineOption outputOption("output", "Bench output file (default: - = stdout)", "file", "-");
+    QCommandLineOption traceOption("trace", "Record spans and write them as Chrome trace JSON (Perfetto)", "file");
+    QCommandLineOption logOption("log", "Also write log messages to a file, from a background thread "
+                                 "(levels: QT_LOGGING_RULES, e.g. \"crud.*.debug=true\")", "file");
+    parser.addOptions({dbOption, delimiterOption, conflictOption, threadsOption, partRowsOption, partBytesOption,
+                       exportNameOption, titleOption, rowTemplateOption, whereOption, limitOption, rowsOption,
+                       iterationsOption, casesOption, pdfRowsOption, layoutThreadsOption, formatOption,
+                       outputOption, traceOption, logOption});
+
+    // The command decides the application type, so parse once before creating it
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i) {
+        arguments << QString::fromLocal8Bit(argv[i]);
+    }
+    parser.parse(arguments);
+    const QString command = parser.positionalArguments().value(0);
+
+    // PDF reports shape text, which needs a QGuiApplication (fonts come from
+    // the platform plugin). Without a display the offscreen plugin is enough,
+    // every other command runs on a plain QCoreApplication.
+    std::unique_ptr<QCoreApplication> app;
+    if (needsFonts(command)) {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        app.reset(new QGuiApplication(argc, argv));
+    } else {
+        app.reset(new QCoreApplication(argc, argv));
+    }
+    QCoreApplication::setApplicationName("crudmahasiswa-cli");
+    QCoreApplication::setApplicationVersion(APP_VERSION);
+    parser.setApplicationDescription(QString("%1 command line tool").arg(APP_NAME));
+
+    // Reports errors and handles --help/--version
+    parser.process(*app);
+
+    TraceDump traceDump;
+    if (parser.isSet(traceOption)) {
+        traceDump.filePath = parser.value(traceOption);
+        Tracer::setEnabled(true);
+    }
+
+    // Flushed by AppLog's post routine when the application is destroyed
+    QString logError;
+    if (parser.isSet(logOption) && !AppLog::installFileSink(parser.value(logOption), &logError)) {
+        QTextStream(stderr) << "error: cannot open log " << parser.value(logOption) << ": " << logError << Qt::endl;
+        return 1;
+    }
+
+    const QStringList args = parser.positionalArguments();
+    QTextStream err(stderr);
+
+    if (args.isEmpty()) {
+        parser.showHelp(2);
+    }
+
+    const QString path = args.value(1);
+    const int threads = parser.value(threadsOption).toInt();
+
+    CliCommands commands(parser.value(dbOption));
+
+    if (command == "import" && !path.isEmpty()) {
+        const QString policyName = parser.value(conflictOption);
+        DatabaseManager::ConflictPolicy policy = DatabaseManager::SkipOnConflict;
+        if (policyName == "update") {
+            policy = DatabaseManager::UpdateOnConflict;
+        } else if (policyName == "abort") {
+            policy = DatabaseManager::AbortOnConflict;
+        } else if (policyName != "skip") {
+            err << "error: unknown conflict policy " << policyName << Qt::endl;
+            return 2;
+        }
+        return commands.importCsv(path, parser.value(delimiterOption), policy, threads);
+    }
+
+    if (command == "export-csv" && !path.isEmpty()) {
+        return commands.exportCsv(path, parser.value(delimiterOption), parser.value(partRowsOption).toLongLong(),
+                                  parser.value(partBytesOption).toLongLong(), threads);
+    }
+
+    if (command == "export-changes" && !path.isEmpty()) {
+        return commands.exportChanges(path, parser.value(delimiterOption), parser.value(exportNameOption));
+    }
+
+    if (command == "export-pdf" && !path.isEmpty()) {
+        return commands.exportPdf(path, parser.value(titleOption));
+    }
+
+    if (command == "export-pdf-batch" && !path.isEmpty()) {
+        return commands.exportPdfBatch(path, threads);
+    }
+
+    if (command == "export-html" && !path.isEmpty()) {
+        return commands.exportHtml(path, parser.value(titleOption), parser.value(rowTemplateOption));
+    }
+
+    if (command == "query") {
+        return commands.query(parser.value(whereOption), parser.value(limitOption).toLongLong());
+    }
+
+    if (command == "summary") {
+        return commands.groupSummary();
+    }
+
+    if (command == "bench") {
+        QList<qint64> rowCounts;
+        for (const QString &count : parser.value(rowsOption).split(',', Qt::SkipEmptyParts)) {
+            bool ok = false;
+            rowCounts.append(count.trimmed().toLongLong(&ok));
+            if (!ok || rowCounts.last() <= 0) {
+                err << "error: invalid row count " << count << Qt::endl;
+                return 2;
+            }
+        }
+
+        QList<int> layoutThreads;
+        for (const QString &count : parser.value(layoutThreadsOption).split(',', Qt::SkipEmptyParts)) {
+            bool ok = false;
+            layoutThreads.append(count.trimmed().toInt(&ok));
+            if (!ok || layoutThreads.last() <= 0) {
+                err << "error: invalid thread count " << count << Qt::endl;
+                return 2;
+            }
+        }
+
+        const QString format = parser.value(formatOption);
+        if (format != "json" && format != "csv") {
+            err << "error: unknown output format " << format << Qt::endl;
+            return 2;
+        }
+
+        Benchmark benchmark;
+        benchmark.setRowCounts(rowCounts);
+        benchmark.setIterations(parser.value(iterationsOption).toInt());
+        benchmark.setCases(parser.value(casesOption).split(',', Qt::SkipEmptyParts));
+        benchmark.setPdfMaxRows(parser.value(pdfRowsOption).toLongLong());
+        if (!layoutThreads.isEmpty()) {
+            benchmark.setLayoutThreads(layoutThreads);
+        }
+
+        const bool success = benchmark.run()
+            && (format == "csv" ? benchmark.writeCsv(parser.value(outputOption))
+                                : benchmark.writeJson(parser.value(outputOption)));
+        if (!success) {
+            err << "error: " << benchmark.getLastError() << Qt::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    err << "error: unknown command or missing path: " << args.join(' ') << Qt::endl;
+    parser.showHelp(2);
+}
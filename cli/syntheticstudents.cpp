@@ -0,0 +1,54 @@
+#include "syntheticstudents.h"
+#include <QRandomGenerator>
+#include <iterator>
+
+namespace {
+const char *const FIRST_NAMES[] = {
+    "Adi", "Ayu", "Bagus", "Bayu", "Citra", "Dewi", "Dimas", "Eka", "Fajar", "Fitri",
+    "Gilang", "Hana", "Indah", "Joko", "Kurnia", "Lestari", "Maya", "Nanda", "Putra", "Rina",
+    "Rizki", "Sari", "Taufik", "Wahyu"
+};
+
+const char *const LAST_NAMES[] = {
+    "Pratama", "Saputra", "Wijaya", "Kusuma", "Hidayat", "Nugroho", "Santoso", "Permata",
+    "Lestari", "Setiawan", "Ramadhan", "Utami", "Gunawan", "Maharani", "Siregar", "Yusuf"
+};
+
+constexpr int YEARS = 4;
+constexpr int SECTIONS = 8; // A..H
+}
+
+SyntheticStudents::SyntheticStudents(quint32 seed)
+    : m_seed(seed)
+{
+}
+
+QVector<StudentsDataStruct> SyntheticStudents::generate(qsizetype count) const
+{
+    QRandomGenerator random(m_seed);
+
+    QVector<StudentsDataStruct> rows;
+    rows.reserve(count);
+
+    for (qsizetype i = 0; i < count; ++i) {
+        const char *first = FIRST_NAMES[random.bounded(int(std::size(FIRST_NAMES)))];
+        const char *last = LAST_NAMES[random.bounded(int(std::size(LAST_NAMES)))];
+        const int year = 1 + random.bounded(YEARS);
+        const char section = char('A' + random.bounded(SECTIONS));
+
+        StudentsDataStruct student;
+        student.id = int(i + 1);
+        // The row number keeps nama unique whatever the names drawn
+        student.nama = QString("%1 %2 %3").arg(QLatin1String(first), QLatin1String(last)).arg(i + 1);
+        student.npm = QString::number(2020000000LL + random.bounded(0, 99999999));
+        student.kelas = QString("TI-%1%2").arg(year).arg(QLatin1Char(section));
+        rows.append(student);
+    }
+
+    return rows;
+}
+
+int SyntheticStudents::kelasCount()
+{
+    return YEARS * SECTIONS;
+}
@@ -0,0 +1,24 @@
+#ifndef SYNTHETICSTUDENTS_H
+#define SYNTHETICSTUDENTS_H
+
+#include <QVector>
+#include "helpers/Environments.h"
+
+// Deterministic mahasiswa rows for benchmarks: the same seed and count always
+// give the same rows, so results of two builds are comparable. nama is unique
+// (the table has a UNIQUE constraint), npm is 10 digits and kelas is one of
+// 32 classes (TI-1A .. TI-4H), spread like real data.
+class SyntheticStudents
+{
+public:
+    explicit SyntheticStudents(quint32 seed = 20240901);
+
+    QVector<StudentsDataStruct> generate(qsizetype count) const;
+
+    static int kelasCount();
+
+private:
+    quint32 m_seed;
+};
+
+#endif // SYNTHETICSTUDENTS_H
@@ -0,0 +1,50 @@
+# Platform-neutral core: database, table model, CSV import/export and PDF
+# reports. No QtWidgets here, so it builds on headless Linux servers.
+# Built as a static library by core.pro (used by the CLI), the GUI application
+# compiles the same sources directly.
+
+QT += core gui sql concurrent
+
+INCLUDEPATH += $$PWD/..
+
+# Log levels removed at compile time (qCDebug/qCInfo become no-ops):
+#   CRUD_LOG_STRIP = debug   debug only (default for release builds)
+#   CRUD_LOG_STRIP = info    debug and info
+#   CRUD_LOG_STRIP = none    keep everything
+# e.g. qmake CRUD_LOG_STRIP=none CONFIG+=release
+isEmpty(CRUD_LOG_STRIP) {
+    CONFIG(release, debug|release): CRUD_LOG_STRIP = debug
+    else: CRUD_LOG_STRIP = none
+}
+equals(CRUD_LOG_STRIP, debug)|equals(CRUD_LOG_STRIP, info): DEFINES += QT_NO_DEBUG_OUTPUT
+equals(CRUD_LOG_STRIP, info): DEFINES += QT_NO_INFO_OUTPUT
+
+# PerfCounters::residentMemoryBytes()
+win32: LIBS += -lpsapi
+
+include(../modules/CSVExporter/CSVExporter.pri)
+include(../modules/CSVImporter/CSVImporter.pri)
+include(../modules/PDFExporter/PDFExporter.pri)
+
+SOURCES += \
+    $$PWD/../helpers/databasemanager.cpp \
+    $$PWD/../helpers/logging.cpp \
+    $$PWD/../helpers/perfcounters.cpp \
+    $$PWD/../helpers/querystats.cpp \
+    $$PWD/../helpers/stallwatchdog.cpp \
+    $$PWD/../helpers/startupprofile.cpp \
+    $$PWD/../helpers/tracer.cpp \
+    $$PWD/../models/studentsloadjob.cpp \
+    $$PWD/../models/tablemodel.cpp
+
+HEADERS += \
+    $$PWD/../helpers/Environments.h \
+    $$PWD/../helpers/databasemanager.h \
+    $$PWD/../helpers/logging.h \
+    $$PWD/../helpers/perfcounters.h \
+    $$PWD/../helpers/querystats.h \
+    $$PWD/../helpers/stallwatchdog.h \
+    $$PWD/../helpers/startupprofile.h \
+    $$PWD/../helpers/tracer.h \
+    $$PWD/../models/studentsloadjob.h \
+    $$PWD/../models/tablemodel.h
@@ -0,0 +1,8 @@
+TEMPLATE = lib
+TARGET = crudmahasiswacore
+
+QT -= widgets
+
+CONFIG += c++17 staticlib release
+
+include(core.pri)
@@ -0,0 +1,15 @@
+# Link against the static library built by core.pro (see CRUDMahasiswaHeadless.pro)
+
+QT += core gui sql concurrent
+
+INCLUDEPATH += \
+    $$PWD/.. \
+    $$PWD/../modules/CSVExporter \
+    $$PWD/../modules/CSVImporter \
+    $$PWD/../modules/PDFExporter
+
+# Build directory of core.pro, wherever the including project sits in the tree
+CORE_LIB_DIR = $$shadowed($$PWD)
+
+LIBS += -L$$CORE_LIB_DIR -lcrudmahasiswacore
+unix: PRE_TARGETDEPS += $$CORE_LIB_DIR/libcrudmahasiswacore.a
@@ -1,5 +1,6 @@
 #include "aboutdialog.h"
 #include "ui_aboutdialog.h"
+#include "helpers/pixmapcache.h"
 
 AboutDialog::AboutDialog(QWidget *parent)
     : QDialog(parent)
@@ -9,6 +10,10 @@ AboutDialog::AboutDialog(QWidget *parent)
 
     ui->lblAppTitle->setText(QString(APP_NAME));
     ui->lblAppVersion->setText(QString("Version %1").arg(APP_VERSION));
+
+    // Logo 512px diperkecil sekali lewat cache, bukan border-image yang diskalakan setiap paint
+    ui->lblAppIcon->setPixmap(PixmapCache::instance().pixmap(PixmapCache::APP_LOGO, ui->lblAppIcon->maximumSize(),
+                                                             devicePixelRatioF()));
 }
 
 AboutDialog::~AboutDialog()
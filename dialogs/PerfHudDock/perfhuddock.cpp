@@ -0,0 +1,147 @@
+#include "perfhuddock.h"
+#include "helpers/perfcounters.h"
+#include "helpers/querystats.h"
+#include <QFormLayout>
+#include <QLocale>
+
+namespace {
+// Cukup jarang sehingga HUD sendiri tidak terlihat di profil
+constexpr int REFRESH_INTERVAL_MS = 1000;
+
+QLabel *addValueRow(QFormLayout *layout, const QString &name)
+{
+    QLabel *value = new QLabel("-");
+    value->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addRow(name, value);
+    return value;
+}
+
+QString formatMs(double ms)
+{
+    return ms < 0 ? QString("-") : QString("%1 ms").arg(ms, 0, 'f', ms < 10 ? 2 : 1);
+}
+
+QString formatBytes(qint64 bytes)
+{
+    return bytes < 0 ? QString("-") : QLocale().formattedDataSize(bytes);
+}
+}
+
+PerfHudDock::PerfHudDock(QWidget *parent)
+    : QDockWidget("HUD Performa", parent)
+{
+    setObjectName("perfHudDock");
+    setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
+
+    QWidget *content = new QWidget(this);
+    QFormLayout *layout = new QFormLayout(content);
+    layout->setLabelAlignment(Qt::AlignRight);
+
+    m_queryLabel = addValueRow(layout, "Query terakhir");
+    m_modelRowsLabel = addValueRow(layout, "Baris model");
+    m_modelMemoryLabel = addValueRow(layout, "Memori model");
+    m_filterLabel = addValueRow(layout, "Filter");
+    m_sortLabel = addValueRow(layout, "Sort");
+    m_exportLabel = addValueRow(layout, "Export terakhir");
+    m_eventLoopLabel = addValueRow(layout, "Latensi event loop");
+    m_rssLabel = addValueRow(layout, "RSS proses");
+
+    m_queryLabel->setWordWrap(true);
+    m_exportLabel->setWordWrap(true);
+
+    setWidget(content);
+
+    m_refreshTimer.setInterval(REFRESH_INTERVAL_MS);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &PerfHudDock::refresh);
+}
+
+void PerfHudDock::setModel(TableModel *model)
+{
+    m_model = model;
+}
+
+void PerfHudDock::setStallWatchdog(StallWatchdog *watchdog)
+{
+    m_stallWatchdog = watchdog;
+}
+
+void PerfHudDock::recordFilterLatency(double ms, int visibleRows)
+{
+    m_filterMs = ms;
+    m_filterRows = visibleRows;
+}
+
+void PerfHudDock::recordSortLatency(double ms)
+{
+    m_sortMs = ms;
+}
+
+void PerfHudDock::refresh()
+{
+    const QueryStats::LastQuery query = QueryStats::instance().lastQuery();
+    if (query.function.isEmpty()) {
+        m_queryLabel->setText("-");
+        m_queryLabel->setToolTip(QString());
+    } else {
+        m_queryLabel->setText(QString("%1, %2 baris%3\n%4")
+                                  .arg(formatMs(query.durationMs))
+                                  .arg(query.rows)
+                                  .arg(query.success ? "" : " (gagal)")
+                                  .arg(query.function));
+        m_queryLabel->setToolTip(query.shape);
+    }
+
+    if (m_model) {
+        m_modelRowsLabel->setText(QLocale().toString(m_model->rowCount()));
+        m_modelMemoryLabel->setText("~" + formatBytes(m_model->estimatedMemoryBytes()));
+    } else {
+        m_modelRowsLabel->setText("-");
+        m_modelMemoryLabel->setText("-");
+    }
+
+    m_filterLabel->setText(m_filterMs < 0 ? QString("-")
+                                          : QString("%1, %2 baris tampil").arg(formatMs(m_filterMs)).arg(m_filterRows));
+    m_sortLabel->setText(formatMs(m_sortMs));
+
+    const PerfCounters::ExportSample exportSample = PerfCounters::lastExport();
+    if (!exportSample.time.isValid()) {
+        m_exportLabel->setText("-");
+    } else {
+        // Export di bawah 1 ms dihitung 1 ms agar throughput tetap terhingga
+        const double seconds = qMax<qint64>(1, exportSample.elapsedMs) / 1000.0;
+        QString text = QString("%1: %2 baris dalam %3 ms\n%4 baris/s")
+                           .arg(exportSample.kind.toUpper())
+                           .arg(exportSample.rows)
+                           .arg(exportSample.elapsedMs)
+                           .arg(qint64(exportSample.rows / seconds));
+        if (exportSample.bytes > 0) {
+            text += QString(", %1/s").arg(formatBytes(qint64(exportSample.bytes / seconds)));
+        }
+        m_exportLabel->setText(text);
+        m_exportLabel->setToolTip(exportSample.time.toString("HH:mm:ss"));
+    }
+
+    if (m_stallWatchdog && m_stallWatchdog->isRunning()) {
+        m_eventLoopLabel->setText(QString("%1 (%2 macet, terlama %3 ms)")
+                                      .arg(formatMs(m_stallWatchdog->lastLatencyMs()))
+                                      .arg(m_stallWatchdog->stallCount())
+                                      .arg(m_stallWatchdog->longestStallMs()));
+    } else {
+        m_eventLoopLabel->setText("watchdog mati");
+    }
+
+    m_rssLabel->setText(formatBytes(PerfCounters::residentMemoryBytes()));
+}
+
+void PerfHudDock::showEvent(QShowEvent *event)
+{
+    QDockWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void PerfHudDock::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer.stop();
+    QDockWidget::hideEvent(event);
+}
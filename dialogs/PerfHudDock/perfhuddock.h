@@ -0,0 +1,58 @@
+#ifndef PERFHUDDOCK_H
+#define PERFHUDDOCK_H
+
+#include <QDockWidget>
+#include <QLabel>
+#include <QPointer>
+#include <QTimer>
+#include "helpers/stallwatchdog.h"
+#include "models/tablemodel.h"
+
+// HUD performa di dalam MainWindow: query terakhir, isi model, latensi
+// filter/sort, throughput export, latensi event loop dan RSS proses.
+// Hanya membaca penghitung yang sudah ada (QueryStats, PerfCounters,
+// StallWatchdog) sekali per detik dan hanya selama dock terlihat.
+class PerfHudDock : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PerfHudDock(QWidget *parent = nullptr);
+
+    void setModel(TableModel *model);
+
+    // nullptr atau watchdog yang tidak berjalan = latensi event loop tidak tersedia
+    void setStallWatchdog(StallWatchdog *watchdog);
+
+    // Diisi MainWindow setelah filter/sort selesai
+    void recordFilterLatency(double ms, int visibleRows);
+    void recordSortLatency(double ms);
+
+public slots:
+    void refresh();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    QPointer<TableModel> m_model;
+    StallWatchdog *m_stallWatchdog = nullptr;
+
+    double m_filterMs = -1;
+    int m_filterRows = 0;
+    double m_sortMs = -1;
+
+    QLabel *m_queryLabel;
+    QLabel *m_modelRowsLabel;
+    QLabel *m_modelMemoryLabel;
+    QLabel *m_filterLabel;
+    QLabel *m_sortLabel;
+    QLabel *m_exportLabel;
+    QLabel *m_eventLoopLabel;
+    QLabel *m_rssLabel;
+
+    QTimer m_refreshTimer;
+};
+
+#endif // PERFHUDDOCK_H
@@ -0,0 +1,184 @@
+#include "querystatsdialog.h"
+#include "helpers/querystats.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTabWidget>
+#include <QSet>
+#include <cmath>
+
+namespace {
+// SCAN tanpa index = seluruh tabel dibaca
+bool isFullScan(const QStringList &plan)
+{
+    for (const QString &line : plan) {
+        if (line.startsWith("SCAN ") && !line.contains("INDEX")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QTableWidgetItem *numberItem(double value, int decimals = 0)
+{
+    // Disimpan sebagai angka agar kolom diurutkan secara numerik
+    const double scale = std::pow(10.0, decimals);
+    QTableWidgetItem *item = new QTableWidgetItem();
+    item->setData(Qt::DisplayRole, decimals > 0 ? QVariant(std::round(value * scale) / scale) : QVariant(qint64(value)));
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QTableWidget *createTable(const QStringList &headers, QWidget *parent)
+{
+    QTableWidget *table = new QTableWidget(0, headers.size(), parent);
+    table->setHorizontalHeaderLabels(headers);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->verticalHeader()->hide();
+    table->horizontalHeader()->setStretchLastSection(true);
+    return table;
+}
+}
+
+QueryStatsDialog::QueryStatsDialog(QWidget *parent)
+    : QDialog(parent)
+    , m_shapeTable(createTable(QStringList() << "Statement" << "Fungsi" << "Panggilan" << "Baris" << "Total ms"
+                                             << "p50 ms" << "p95 ms" << "p99 ms" << "Maks ms" << "Lambat" << "Error", this))
+    , m_slowTable(createTable(QStringList() << "Waktu" << "Fungsi" << "ms" << "Baris" << "Bind"
+                                            << "Full scan" << "SQL" << "Query plan", this))
+    , m_thresholdSpin(new QDoubleSpinBox(this))
+    , m_logPathLabel(new QLabel(this))
+{
+    setWindowTitle("Statistik Query");
+
+    m_thresholdSpin->setRange(0, 60000);
+    m_thresholdSpin->setDecimals(0);
+    m_thresholdSpin->setSuffix(" ms");
+    m_thresholdSpin->setSpecialValueText("Mati");
+    m_thresholdSpin->setValue(QueryStats::instance().slowQueryThresholdMs());
+    connect(m_thresholdSpin, &QDoubleSpinBox::valueChanged, this, [](double value) {
+        QueryStats::instance().setSlowQueryThresholdMs(value);
+    });
+
+    QPushButton *refreshButton = new QPushButton("Refresh", this);
+    QPushButton *resetButton = new QPushButton("Reset", this);
+    connect(refreshButton, &QPushButton::clicked, this, &QueryStatsDialog::refresh);
+    connect(resetButton, &QPushButton::clicked, this, &QueryStatsDialog::resetStats);
+
+    QHBoxLayout *toolLayout = new QHBoxLayout();
+    toolLayout->addWidget(new QLabel("Batas query lambat:", this));
+    toolLayout->addWidget(m_thresholdSpin);
+    toolLayout->addStretch();
+    toolLayout->addWidget(refreshButton);
+    toolLayout->addWidget(resetButton);
+
+    QTabWidget *tabs = new QTabWidget(this);
+    tabs->addTab(m_shapeTable, "Per Statement");
+    tabs->addTab(m_slowTable, "Query Lambat");
+
+    const QString logPath = QueryStats::instance().slowQueryLogPath();
+    m_logPathLabel->setText(logPath.isEmpty() ? "Query lambat tidak ditulis ke file"
+                                              : "Query lambat juga ditulis ke " + logPath);
+    m_logPathLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(toolLayout);
+    mainLayout->addWidget(tabs);
+    mainLayout->addWidget(m_logPathLabel);
+
+    m_refreshTimer.setInterval(2000);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &QueryStatsDialog::refresh);
+
+    resize(1100, 600);
+}
+
+void QueryStatsDialog::refresh()
+{
+    const QList<QueryStats::ShapeStats> shapes = QueryStats::instance().shapeStats();
+    const QList<QueryStats::SlowQuery> slowQueries = QueryStats::instance().slowQueries();
+
+    // Shape yang pernah full scan, dari daftar query lambat
+    QSet<QString> fullScanShapes;
+    for (const QueryStats::SlowQuery &slow : slowQueries) {
+        if (isFullScan(slow.plan)) {
+            fullScanShapes.insert(QueryStats::normalizeSql(slow.sql));
+        }
+    }
+
+    m_shapeTable->setSortingEnabled(false);
+    m_shapeTable->setRowCount(shapes.size());
+    for (int row = 0; row < shapes.size(); ++row) {
+        const QueryStats::ShapeStats &stats = shapes.at(row);
+
+        QTableWidgetItem *shapeItem = new QTableWidgetItem(stats.shape);
+        shapeItem->setToolTip(stats.shape);
+        m_shapeTable->setItem(row, 0, shapeItem);
+        m_shapeTable->setItem(row, 1, new QTableWidgetItem(stats.function));
+        m_shapeTable->setItem(row, 2, numberItem(stats.calls));
+        m_shapeTable->setItem(row, 3, numberItem(stats.rows));
+        m_shapeTable->setItem(row, 4, numberItem(stats.totalMs, 1));
+        m_shapeTable->setItem(row, 5, numberItem(stats.p50Ms, 2));
+        m_shapeTable->setItem(row, 6, numberItem(stats.p95Ms, 2));
+        m_shapeTable->setItem(row, 7, numberItem(stats.p99Ms, 2));
+        m_shapeTable->setItem(row, 8, numberItem(stats.maxMs, 2));
+        m_shapeTable->setItem(row, 9, numberItem(stats.slowCalls));
+        m_shapeTable->setItem(row, 10, numberItem(stats.errors));
+
+        if (fullScanShapes.contains(stats.shape)) {
+            for (int column = 0; column < m_shapeTable->columnCount(); ++column) {
+                m_shapeTable->item(row, column)->setForeground(QColor("#ff9e64"));
+            }
+        }
+    }
+    m_shapeTable->setSortingEnabled(true);
+
+    // Terbaru di atas
+    m_slowTable->setSortingEnabled(false);
+    m_slowTable->setRowCount(slowQueries.size());
+    for (int i = 0; i < slowQueries.size(); ++i) {
+        const QueryStats::SlowQuery &slow = slowQueries.at(slowQueries.size() - 1 - i);
+        const bool fullScan = isFullScan(slow.plan);
+
+        QTableWidgetItem *sqlItem = new QTableWidgetItem(slow.sql.simplified());
+        sqlItem->setToolTip(slow.sql);
+        QTableWidgetItem *planItem = new QTableWidgetItem(slow.plan.join(" | "));
+        planItem->setToolTip(slow.plan.join("\n"));
+
+        m_slowTable->setItem(i, 0, new QTableWidgetItem(slow.time.toString("HH:mm:ss.zzz")));
+        m_slowTable->setItem(i, 1, new QTableWidgetItem(slow.function));
+        m_slowTable->setItem(i, 2, numberItem(slow.durationMs, 1));
+        m_slowTable->setItem(i, 3, numberItem(slow.rows));
+        m_slowTable->setItem(i, 4, numberItem(slow.bindCount));
+        m_slowTable->setItem(i, 5, new QTableWidgetItem(fullScan ? "Ya" : ""));
+        m_slowTable->setItem(i, 6, sqlItem);
+        m_slowTable->setItem(i, 7, planItem);
+
+        if (fullScan) {
+            for (int column = 0; column < m_slowTable->columnCount(); ++column) {
+                m_slowTable->item(i, column)->setForeground(QColor("#ff9e64"));
+            }
+        }
+    }
+    m_slowTable->setSortingEnabled(true);
+}
+
+void QueryStatsDialog::resetStats()
+{
+    QueryStats::instance().reset();
+    refresh();
+}
+
+void QueryStatsDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void QueryStatsDialog::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer.stop();
+    QDialog::hideEvent(event);
+}
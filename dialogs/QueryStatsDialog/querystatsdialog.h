@@ -0,0 +1,37 @@
+#ifndef QUERYSTATSDIALOG_H
+#define QUERYSTATSDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QTimer>
+
+// Jendela debug untuk QueryStats: latensi per bentuk statement dan daftar
+// query lambat beserta query plan-nya. Baris dengan full scan diberi warna.
+class QueryStatsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit QueryStatsDialog(QWidget *parent = nullptr);
+
+public slots:
+    void refresh();
+
+private slots:
+    void resetStats();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    QTableWidget *m_shapeTable;
+    QTableWidget *m_slowTable;
+    QDoubleSpinBox *m_thresholdSpin;
+    QLabel *m_logPathLabel;
+    QTimer m_refreshTimer;
+};
+
+#endif // QUERYSTATSDIALOG_H
@@ -14,4 +14,47 @@ struct StudentsDataStruct{
     QString kelas;
 };
 
+// Satu kelompok laporan per kelas, jumlahnya dihitung oleh SQLite (GROUP BY kelas)
+struct StudentsGroupStruct{
+    QString kelas;
+    qint64 count;
+};
+
+// Satu entri change log (tabel mahasiswa_changes), sudah diringkas per mahasiswa
+struct StudentChangeStruct{
+    enum ChangeType { Inserted, Updated, Deleted };
+
+    qint64 seq;                 // sequence terakhir yang menyentuh mahasiswa ini
+    ChangeType type;
+    StudentsDataStruct student; // untuk Deleted hanya id yang terisi
+};
+
+// Row adapter untuk exporter (CSVExporter::exportRows, PDFExporter::setTableRows).
+// Menulis field langsung ke writer milik exporter dengan urutan kolom id, nama, npm, kelas
+// tanpa konversi ke QStringList per baris.
+struct StudentsRowAdapter{
+    template <typename Writer>
+    void operator()(const StudentsDataStruct &student, Writer &writer) const {
+        writer.writeField(student.id);
+        writer.writeField(student.nama);
+        writer.writeField(student.npm);
+        writer.writeField(student.kelas);
+    }
+};
+
+// Row adapter untuk export incremental: kolom change, id, nama, npm, kelas
+struct StudentChangesRowAdapter{
+    template <typename Writer>
+    void operator()(const StudentChangeStruct &change, Writer &writer) const {
+        if (change.type == StudentChangeStruct::Inserted) {
+            writer.writeField(QStringLiteral("insert"));
+        } else if (change.type == StudentChangeStruct::Updated) {
+            writer.writeField(QStringLiteral("update"));
+        } else {
+            writer.writeField(QStringLiteral("delete"));
+        }
+        StudentsRowAdapter()(change.student, writer);
+    }
+};
+
 #endif // ENVIRONMENTS_H
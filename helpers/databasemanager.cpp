@@ -1,4 +1,7 @@
 #include "databasemanager.h"
+#include "helpers/logging.h"
+#include "helpers/querystats.h"
+#include "helpers/tracer.h"
 #include <QDebug>
 #include <QFile>
 
@@ -10,12 +13,29 @@ DatabaseManager::DatabaseManager(const QString &databasePath, QObject *parent)
     }
 }
 
+DatabaseManager::DatabaseManager(const QString &databasePath, const QString &connectionName,
+                                 bool readOnly, QObject *parent)
+    : QObject(parent), m_databasePath(databasePath), m_connectionName(connectionName), m_readOnly(readOnly)
+{
+    if (openDatabase() && !m_readOnly) {
+        createTablesIfNotExist();
+    }
+}
+
 DatabaseManager::~DatabaseManager()
 {
-    if (m_db.isOpen()) {
-        m_db.close();
-        QSqlDatabase::removeDatabase("qt_sql_default_connection"); // Hapus koneksi default
+    if (m_connectionName.isEmpty()) {
+        if (m_db.isOpen()) {
+            m_db.close();
+            QSqlDatabase::removeDatabase("qt_sql_default_connection"); // Hapus koneksi default
+        }
+        return;
     }
+
+    // Koneksi bernama: lepaskan handle dulu agar removeDatabase tidak mengeluh "still in use"
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
 }
 
 bool DatabaseManager::openDatabase()
@@ -23,18 +43,27 @@ bool DatabaseManager::openDatabase()
     bool isNewDatabase = !QFile::exists(m_databasePath);
 
     // Tambahkan koneksi ke database SQLite
-    m_db = QSqlDatabase::addDatabase("QSQLITE");
+    if (m_connectionName.isEmpty()) {
+        m_db = QSqlDatabase::addDatabase("QSQLITE");
+    } else {
+        m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    }
     m_db.setDatabaseName(m_databasePath);
 
+    if (m_readOnly) {
+        // Beberapa pembaca sekaligus, tunggu sebentar kalau ada penulis
+        m_db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+    }
+
     if (!m_db.open()) {
-        qCritical() << "Gagal membuka database:" << m_db.lastError().text();
+        qCCritical(lcDb) << "Gagal membuka database:" << m_db.lastError().text();
         return false;
     }
 
     if (isNewDatabase) {
-        qDebug() << "Basis data baru dibuat di:" << m_databasePath;
+        qCInfo(lcDb) << "Basis data baru dibuat di:" << m_databasePath;
     } else {
-        qDebug() << "Koneksi ke basis data berhasil dibuka.";
+        qCDebug(lcDb) << "Koneksi ke basis data berhasil dibuka.";
     }
 
     return true;
@@ -55,7 +84,46 @@ void DatabaseManager::createTablesIfNotExist()
     if (!query.exec(createUsersTable)) {
         logError("createTablesIfNotExist (users)", query.lastError());
     } else {
-        qDebug() << "Tabel 'users' dipastikan ada.";
+        qCDebug(lcDb) << "Tabel 'users' dipastikan ada.";
+    }
+
+    // Change log untuk export incremental, diisi oleh trigger
+    QStringList changeTrackingSql;
+    changeTrackingSql << "CREATE TABLE IF NOT EXISTS mahasiswa_changes ("
+                         "seq INTEGER PRIMARY KEY AUTOINCREMENT, "
+                         "student_id INTEGER NOT NULL, "
+                         "op TEXT NOT NULL"
+                         ")"
+                      << "CREATE TABLE IF NOT EXISTS export_state ("
+                         "name TEXT PRIMARY KEY, "
+                         "last_seq INTEGER NOT NULL"
+                         ")"
+                      // Versi awal trigger mencatat tanpa syarat, change log tumbuh walau tidak ada export
+                      << "DROP TRIGGER IF EXISTS mahasiswa_track_insert"
+                      << "DROP TRIGGER IF EXISTS mahasiswa_track_update"
+                      << "DROP TRIGGER IF EXISTS mahasiswa_track_delete"
+                      // Hanya dicatat selama ada export terdaftar (lihat CSVExporter::exportChanges)
+                      << "CREATE TRIGGER IF NOT EXISTS mahasiswa_log_insert AFTER INSERT ON mahasiswa "
+                         "WHEN EXISTS (SELECT 1 FROM export_state) "
+                         "BEGIN INSERT INTO mahasiswa_changes (student_id, op) VALUES (NEW.id, 'I'); END"
+                      << "CREATE TRIGGER IF NOT EXISTS mahasiswa_log_update AFTER UPDATE ON mahasiswa "
+                         "WHEN EXISTS (SELECT 1 FROM export_state) "
+                         "BEGIN INSERT INTO mahasiswa_changes (student_id, op) VALUES (NEW.id, 'U'); END"
+                      << "CREATE TRIGGER IF NOT EXISTS mahasiswa_log_delete AFTER DELETE ON mahasiswa "
+                         "WHEN EXISTS (SELECT 1 FROM export_state) "
+                         "BEGIN INSERT INTO mahasiswa_changes (student_id, op) VALUES (OLD.id, 'D'); END"
+                      // Sisa log dari trigger lama yang tidak akan pernah dibaca
+                      << "DELETE FROM mahasiswa_changes WHERE NOT EXISTS (SELECT 1 FROM export_state)";
+
+    for (const QString &sql : changeTrackingSql) {
+        if (!query.exec(sql)) {
+            logError("createTablesIfNotExist (change tracking)", query.lastError());
+        }
+    }
+
+    // Index untuk laporan per kelas: GROUP BY kelas dan ORDER BY kelas, nama tanpa sort terpisah
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_mahasiswa_kelas_nama ON mahasiswa (kelas, nama)")) {
+        logError("createTablesIfNotExist (index kelas)", query.lastError());
     }
 
     // Tambahkan lebih banyak tabel di sini jika diperlukan
@@ -66,10 +134,17 @@ bool DatabaseManager::isDatabaseOpen() const
     return m_db.isOpen();
 }
 
+QString DatabaseManager::databasePath() const
+{
+    return m_databasePath;
+}
+
 // Implementasi fungsi CRUD:
 
 qint64 DatabaseManager::insertRecord(const QString &tableName, const QVariantMap &data)
 {
+    TRACE_SPAN("db", "DatabaseManager::insertRecord");
+
     if (!m_db.isOpen() || data.isEmpty()) return -1;
 
     QStringList columns = data.keys();
@@ -89,19 +164,126 @@ qint64 DatabaseManager::insertRecord(const QString &tableName, const QVariantMap
         query.bindValue(QString(":%1").arg(key), data.value(key));
     }
 
+    QueryTimer timer(m_db, query, "insertRecord");
     if (!query.exec()) {
+        timer.setFailed();
         logError("insertRecord", query.lastError());
         return -1;
     }
+    timer.addRows(query.numRowsAffected());
 
     return query.lastInsertId().toLongLong();
 }
 
+bool DatabaseManager::insertStudentsBatch(const QString &tableName,
+                                          const QVector<StudentsDataStruct> &rows,
+                                          ConflictPolicy policy,
+                                          qint64 *affectedRows)
+{
+    TRACE_SPAN("db", "DatabaseManager::insertStudentsBatch");
+
+    if (affectedRows) *affectedRows = 0;
+    if (!m_db.isOpen()) return false;
+    if (rows.isEmpty()) return true;
+
+    QString sql;
+    switch (policy) {
+    case SkipOnConflict:
+        sql = QString("INSERT OR IGNORE INTO %1 (nama, npm, kelas) VALUES (?, ?, ?)").arg(tableName);
+        break;
+    case UpdateOnConflict:
+        sql = QString("INSERT INTO %1 (nama, npm, kelas) VALUES (?, ?, ?) "
+                      "ON CONFLICT(nama) DO UPDATE SET npm = excluded.npm, kelas = excluded.kelas").arg(tableName);
+        break;
+    case AbortOnConflict:
+    default:
+        sql = QString("INSERT INTO %1 (nama, npm, kelas) VALUES (?, ?, ?)").arg(tableName);
+        break;
+    }
+
+    // Statement di-prepare sekali, lalu hanya binding ulang per baris
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.prepare(sql)) {
+        logError("insertStudentsBatch (prepare)", query.lastError());
+        return false;
+    }
+
+    // Satu entri statistik untuk seluruh batch, bukan per baris
+    QueryTimer timer(m_db, sql, "insertStudentsBatch");
+    qint64 affected = 0;
+    for (const StudentsDataStruct &row : rows) {
+        query.bindValue(0, row.nama);
+        query.bindValue(1, row.npm);
+        query.bindValue(2, row.kelas);
+
+        if (!query.exec()) {
+            timer.setFailed();
+            logError("insertStudentsBatch", query.lastError());
+            if (affectedRows) *affectedRows = affected;
+            return false;
+        }
+
+        affected += query.numRowsAffected();
+    }
+    timer.addRows(affected);
+
+    if (affectedRows) *affectedRows = affected;
+    return true;
+}
+
+bool DatabaseManager::beginTransaction()
+{
+    TRACE_SPAN("db", "DatabaseManager::beginTransaction");
+
+    if (!m_db.isOpen()) return false;
+
+    QueryTimer timer(m_db, QStringLiteral("BEGIN"), "beginTransaction");
+    if (!m_db.transaction()) {
+        timer.setFailed();
+        logError("beginTransaction", m_db.lastError());
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::commitTransaction()
+{
+    TRACE_SPAN("db", "DatabaseManager::commitTransaction");
+
+    if (!m_db.isOpen()) return false;
+
+    QueryTimer timer(m_db, QStringLiteral("COMMIT"), "commitTransaction");
+    if (!m_db.commit()) {
+        timer.setFailed();
+        logError("commitTransaction", m_db.lastError());
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::rollbackTransaction()
+{
+    TRACE_SPAN("db", "DatabaseManager::rollbackTransaction");
+
+    if (!m_db.isOpen()) return false;
+
+    QueryTimer timer(m_db, QStringLiteral("ROLLBACK"), "rollbackTransaction");
+    if (!m_db.rollback()) {
+        timer.setFailed();
+        logError("rollbackTransaction", m_db.lastError());
+        return false;
+    }
+    return true;
+}
+
 QList<StudentsDataStruct> DatabaseManager::selectRecords(const QString &tableName,
                                                   const QStringList &columns, // <--- TERIMA PARAMETER INI
                                                   const QString &condition,
                                                   const QVariantMap &bindValues)
 {
+    TRACE_SPAN("db", "DatabaseManager::selectRecords");
+
     QList<StudentsDataStruct> rowData;
     // QList<QVariantMap> results;
     if (!m_db.isOpen()) return rowData;
@@ -119,7 +301,9 @@ QList<StudentsDataStruct> DatabaseManager::selectRecords(const QString &tableNam
 
     query.prepare(sqlCount);
 
+    QueryTimer countTimer(m_db, query, "selectRecords");
     if (!query.exec()){
+        countTimer.setFailed();
         logError("(select count) error : ", query.lastError());
         return rowData;
     }
@@ -129,6 +313,7 @@ QList<StudentsDataStruct> DatabaseManager::selectRecords(const QString &tableNam
         jmlRecord = query.record().value(0).toInt();
         // qDebug() << Q_FUNC_INFO << "jumlah recordnya adalah : " << jmlRecord;
     }
+    countTimer.finish();
 
 
     // Bangun query SQL: SELECT [kolom] FROM [tabel] WHERE [kondisi]
@@ -146,7 +331,9 @@ QList<StudentsDataStruct> DatabaseManager::selectRecords(const QString &tableNam
         query.bindValue(key, bindValues.value(key));
     }
 
+    QueryTimer timer(m_db, query, "selectRecords");
     if (!query.exec()) {
+        timer.setFailed();
         logError("selectRecords", query.lastError());
         return rowData;
     }
@@ -154,6 +341,7 @@ QList<StudentsDataStruct> DatabaseManager::selectRecords(const QString &tableNam
     if (jmlRecord > 0){
         // Ambil hasil
         while (query.next()) {
+            timer.addRows();
             // QVariantMap row;
             StudentsDataStruct studentData;
             QSqlRecord record = query.record();
@@ -178,8 +366,180 @@ QList<StudentsDataStruct> DatabaseManager::selectRecords(const QString &tableNam
     return rowData;
 }
 
+bool DatabaseManager::selectRecordsStreamed(const QString &tableName,
+                                            const QString &condition,
+                                            const QVariantMap &bindValues,
+                                            const std::function<bool(const StudentsDataStruct &)> &callback)
+{
+    TRACE_SPAN("db", "DatabaseManager::selectRecordsStreamed");
+
+    if (!m_db.isOpen()) return false;
+
+    QString sql = QString("SELECT id, nama, npm, kelas FROM %1").arg(tableName);
+    if (!condition.isEmpty()) {
+        sql += " WHERE " + condition;
+    }
+
+    QSqlQuery query(m_db);
+    // Forward-only: driver tidak menyimpan baris yang sudah dilewati
+    query.setForwardOnly(true);
+    query.prepare(sql);
+
+    // Binding values untuk mencegah SQL Injection
+    foreach (const QString &key, bindValues.keys()) {
+        query.bindValue(key, bindValues.value(key));
+    }
+
+    QueryTimer timer(m_db, query, "selectRecordsStreamed");
+    if (!query.exec()) {
+        timer.setFailed();
+        logError("selectRecordsStreamed", query.lastError());
+        return false;
+    }
+
+    // Satu struct dipakai ulang untuk semua baris
+    StudentsDataStruct studentData;
+    while (query.next()) {
+        timer.addRows();
+        studentData.id = query.value(0).toInt();
+        studentData.nama = query.value(1).toString();
+        studentData.npm = query.value(2).toString();
+        studentData.kelas = query.value(3).toString();
+
+        if (!callback(studentData)) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool DatabaseManager::selectRecordsPage(const QString &tableName, qint64 afterId, int limit,
+                                        QList<StudentsDataStruct> &rows)
+{
+    TRACE_SPAN("db", "DatabaseManager::selectRecordsPage");
+
+    rows.clear();
+    if (!m_db.isOpen()) return false;
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(QString("SELECT id, nama, npm, kelas FROM %1 WHERE id > :afterId ORDER BY id LIMIT :limit").arg(tableName));
+    query.bindValue(":afterId", afterId);
+    query.bindValue(":limit", limit);
+
+    QueryTimer timer(m_db, query, "selectRecordsPage");
+    if (!query.exec()) {
+        timer.setFailed();
+        logError("selectRecordsPage", query.lastError());
+        return false;
+    }
+
+    rows.reserve(limit);
+    while (query.next()) {
+        timer.addRows();
+        StudentsDataStruct studentData;
+        studentData.id = query.value(0).toInt();
+        studentData.nama = query.value(1).toString();
+        studentData.npm = query.value(2).toString();
+        studentData.kelas = query.value(3).toString();
+        rows.append(studentData);
+    }
+
+    return true;
+}
+
+bool DatabaseManager::selectGroupSummary(const QString &tableName, QList<StudentsGroupStruct> &groups)
+{
+    TRACE_SPAN("db", "DatabaseManager::selectGroupSummary");
+
+    groups.clear();
+    if (!m_db.isOpen()) return false;
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+
+    const QString sql = QString("SELECT kelas, COUNT(*) FROM %1 GROUP BY kelas ORDER BY kelas").arg(tableName);
+    QueryTimer timer(m_db, sql, "selectGroupSummary");
+    if (!query.exec(sql)) {
+        timer.setFailed();
+        logError("selectGroupSummary", query.lastError());
+        return false;
+    }
+
+    while (query.next()) {
+        timer.addRows();
+        groups.append({query.value(0).toString(), query.value(1).toLongLong()});
+    }
+
+    return true;
+}
+
+bool DatabaseManager::selectRecordsGrouped(const QString &tableName,
+                                           const std::function<bool(const StudentsGroupStruct &)> &onGroup,
+                                           const std::function<bool(const StudentsDataStruct &)> &onRow,
+                                           const QString &kelas)
+{
+    TRACE_SPAN("db", "DatabaseManager::selectRecordsGrouped");
+
+    if (!m_db.isOpen()) return false;
+
+    // Jumlah per kelas ikut di setiap baris (join ke hasil GROUP BY),
+    // jadi header kelompok bisa ditulis sebelum barisnya tanpa query tambahan
+    const QString filter = kelas.isEmpty() ? QString() : QString(" WHERE kelas = :kelas");
+    const QString sql = QString("SELECT m.id, m.nama, m.npm, m.kelas, g.jumlah FROM %1 m "
+                                "JOIN (SELECT kelas, COUNT(*) AS jumlah FROM %1%2 GROUP BY kelas) g "
+                                "ON g.kelas IS m.kelas%3 "
+                                "ORDER BY m.kelas, m.nama")
+                            .arg(tableName, filter, kelas.isEmpty() ? QString() : QString(" AND m.kelas = :kelasRow"));
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    if (!kelas.isEmpty()) {
+        query.bindValue(":kelas", kelas);
+        query.bindValue(":kelasRow", kelas);
+    }
+
+    QueryTimer timer(m_db, query, "selectRecordsGrouped");
+    if (!query.exec()) {
+        timer.setFailed();
+        logError("selectRecordsGrouped", query.lastError());
+        return false;
+    }
+
+    StudentsDataStruct studentData;
+    StudentsGroupStruct group;
+    bool firstRow = true;
+
+    while (query.next()) {
+        timer.addRows();
+        studentData.id = query.value(0).toInt();
+        studentData.nama = query.value(1).toString();
+        studentData.npm = query.value(2).toString();
+        studentData.kelas = query.value(3).toString();
+
+        if (firstRow || studentData.kelas != group.kelas) {
+            firstRow = false;
+            group.kelas = studentData.kelas;
+            group.count = query.value(4).toLongLong();
+            if (!onGroup(group)) {
+                break;
+            }
+        }
+
+        if (!onRow(studentData)) {
+            break;
+        }
+    }
+
+    return true;
+}
+
 QVector<QStringList> DatabaseManager::selectRecordsToVector(const QString &tableName, const QStringList &columns, const QString &condition, const QVariantMap &bindValues)
 {
+    TRACE_SPAN("db", "DatabaseManager::selectRecordsToVector");
+
     QVector<QStringList> rowData;
     // QList<QVariantMap> results;
     if (!m_db.isOpen()) return rowData;
@@ -195,7 +555,9 @@ QVector<QStringList> DatabaseManager::selectRecordsToVector(const QString &table
     // buat query sql hanya untuk select count, jadi hasilnya sebagai patokan QList reserve (alokasi sekali aja).
     QString sqlCount = QString("SELECT COUNT(id) FROM %1").arg(tableName);
     query.prepare(sqlCount);
+    QueryTimer countTimer(m_db, query, "selectRecordsToVector");
     if (!query.exec()){
+        countTimer.setFailed();
         logError("(select count) error : ", query.lastError());
         return rowData;
     }
@@ -204,8 +566,9 @@ QVector<QStringList> DatabaseManager::selectRecordsToVector(const QString &table
     if (query.next()){
         jmlRecord = query.record().value(0).toInt();
         rowData.reserve(jmlRecord);
-        qDebug() << Q_FUNC_INFO << "jumlah recordnya adalah : " << jmlRecord;
+        qCDebug(lcDb) << Q_FUNC_INFO << "jumlah recordnya adalah : " << jmlRecord;
     }
+    countTimer.finish();
 
     // Bangun query SQL: SELECT [kolom] FROM [tabel] WHERE [kondisi]
     QString sql = QString("SELECT %1 FROM %2").arg(columnList).arg(tableName);
@@ -220,7 +583,9 @@ QVector<QStringList> DatabaseManager::selectRecordsToVector(const QString &table
         query.bindValue(key, bindValues.value(key));
     }
 
+    QueryTimer timer(m_db, query, "selectRecordsToVector");
     if (!query.exec()) {
+        timer.setFailed();
         logError("selectRecords", query.lastError());
         return rowData;
     }
@@ -228,6 +593,7 @@ QVector<QStringList> DatabaseManager::selectRecordsToVector(const QString &table
     if (jmlRecord > 0){
         // Ambil hasil
         while (query.next()) {
+            timer.addRows();
             // QVariantMap row;
             StudentsDataStruct studentData;
             QSqlRecord record = query.record();
@@ -258,6 +624,8 @@ bool DatabaseManager::updateRecord(const QString &tableName,
                                    const QString &condition,
                                    const QVariantMap &bindValues)
 {
+    TRACE_SPAN("db", "DatabaseManager::updateRecord");
+
     if (!m_db.isOpen() || data.isEmpty() || condition.isEmpty()) return false;
 
     QStringList setClauses;
@@ -266,7 +634,7 @@ bool DatabaseManager::updateRecord(const QString &tableName,
     }
 
     QString sql = QString("UPDATE %1 SET %2 WHERE %3").arg(tableName).arg(setClauses.join(", ")).arg(condition);
-    qDebug() << Q_FUNC_INFO << sql;
+    qCDebug(lcDb) << Q_FUNC_INFO << sql;
 
     QSqlQuery query(m_db);
     query.prepare(sql);
@@ -281,11 +649,14 @@ bool DatabaseManager::updateRecord(const QString &tableName,
         query.bindValue(key, bindValues.value(key));
     }
 
+    QueryTimer timer(m_db, query, "updateRecord");
     if (!query.exec()) {
-        qDebug() << Q_FUNC_INFO << query.lastQuery();
+        timer.setFailed();
+        qCWarning(lcDb) << Q_FUNC_INFO << query.lastQuery();
         logError("updateRecord", query.lastError());
         return false;
     }
+    timer.addRows(query.numRowsAffected());
 
     return query.numRowsAffected() > 0;
 }
@@ -294,6 +665,8 @@ bool DatabaseManager::deleteRecord(const QString &tableName,
                                    const QString &condition,
                                    const QVariantMap &bindValues)
 {
+    TRACE_SPAN("db", "DatabaseManager::deleteRecord");
+
     if (!m_db.isOpen() || condition.isEmpty()) return false;
 
     QString sql = QString("DELETE FROM %1 WHERE %2").arg(tableName).arg(condition);
@@ -306,19 +679,189 @@ bool DatabaseManager::deleteRecord(const QString &tableName,
         query.bindValue(key, bindValues.value(key));
     }
 
+    QueryTimer timer(m_db, query, "deleteRecord");
     if (!query.exec()) {
+        timer.setFailed();
         logError("deleteRecord", query.lastError());
         return false;
     }
+    timer.addRows(query.numRowsAffected());
 
     return query.numRowsAffected() > 0;
 }
 
+bool DatabaseManager::selectChangesSince(const QString &tableName,
+                                         qint64 sinceSeq,
+                                         QList<StudentChangeStruct> &changes,
+                                         qint64 &upToSeq)
+{
+    TRACE_SPAN("db", "DatabaseManager::selectChangesSince");
+
+    changes.clear();
+    upToSeq = 0;
+    if (!m_db.isOpen()) return false;
+
+    const QString changesTable = tableName + "_changes";
+
+    // Snapshot yang konsisten: watermark dan perubahan dibaca di transaksi yang sama
+    if (!beginTransaction()) return false;
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+
+    // AUTOINCREMENT menyimpan sequence tertinggi di sqlite_sequence, tetap ada setelah change log di-prune
+    query.prepare("SELECT COALESCE(MAX(seq), 0) FROM sqlite_sequence WHERE name = :name");
+    query.bindValue(":name", changesTable);
+    QueryTimer maxSeqTimer(m_db, query, "selectChangesSince");
+    if (!query.exec()) {
+        maxSeqTimer.setFailed();
+        logError("selectChangesSince (max seq)", query.lastError());
+        rollbackTransaction();
+        return false;
+    }
+    if (query.next()) {
+        upToSeq = query.value(0).toLongLong();
+    }
+    upToSeq = qMax(upToSeq, sinceSeq);
+    maxSeqTimer.finish();
+
+    if (sinceSeq < 0) {
+        // Belum pernah export: kirim semua baris sebagai insert
+        query.prepare(QString("SELECT id, nama, npm, kelas FROM %1 ORDER BY id").arg(tableName));
+        QueryTimer timer(m_db, query, "selectChangesSince");
+        if (!query.exec()) {
+            timer.setFailed();
+            logError("selectChangesSince (full)", query.lastError());
+            rollbackTransaction();
+            return false;
+        }
+
+        while (query.next()) {
+            timer.addRows();
+            StudentChangeStruct change;
+            change.seq = upToSeq;
+            change.type = StudentChangeStruct::Inserted;
+            change.student.id = query.value(0).toInt();
+            change.student.nama = query.value(1).toString();
+            change.student.npm = query.value(2).toString();
+            change.student.kelas = query.value(3).toString();
+            changes.push_back(change);
+        }
+
+        timer.finish();
+        commitTransaction();
+        return true;
+    }
+
+    // Satu entri per mahasiswa: operasi pertama di jendela menentukan insert/update,
+    // baris yang sudah tidak ada menjadi delete
+    QString sql = QString("SELECT g.last_seq, f.op, g.student_id, m.id, m.nama, m.npm, m.kelas "
+                          "FROM (SELECT student_id, MIN(seq) AS first_seq, MAX(seq) AS last_seq "
+                          "      FROM %1 WHERE seq > :since_seq AND seq <= :up_to_seq GROUP BY student_id) g "
+                          "JOIN %1 f ON f.seq = g.first_seq "
+                          "LEFT JOIN %2 m ON m.id = g.student_id "
+                          "ORDER BY g.last_seq").arg(changesTable).arg(tableName);
+
+    query.prepare(sql);
+    query.bindValue(":since_seq", sinceSeq);
+    query.bindValue(":up_to_seq", upToSeq);
+
+    QueryTimer timer(m_db, query, "selectChangesSince");
+    if (!query.exec()) {
+        timer.setFailed();
+        logError("selectChangesSince", query.lastError());
+        rollbackTransaction();
+        return false;
+    }
+
+    while (query.next()) {
+        timer.addRows();
+        StudentChangeStruct change;
+        change.seq = query.value(0).toLongLong();
+        change.student.id = query.value(2).toInt();
+
+        if (query.value(3).isNull()) {
+            change.type = StudentChangeStruct::Deleted;
+        } else {
+            change.type = (query.value(1).toString() == "I") ? StudentChangeStruct::Inserted
+                                                             : StudentChangeStruct::Updated;
+            change.student.nama = query.value(4).toString();
+            change.student.npm = query.value(5).toString();
+            change.student.kelas = query.value(6).toString();
+        }
+        changes.push_back(change);
+    }
+    timer.finish();
+
+    commitTransaction();
+    return true;
+}
+
+bool DatabaseManager::exportWatermark(const QString &exportName, qint64 &seq)
+{
+    TRACE_SPAN("db", "DatabaseManager::exportWatermark");
+
+    seq = -1;
+    if (!m_db.isOpen()) return false;
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT last_seq FROM export_state WHERE name = :name");
+    query.bindValue(":name", exportName);
+
+    QueryTimer timer(m_db, query, "exportWatermark");
+    if (!query.exec()) {
+        timer.setFailed();
+        logError("exportWatermark", query.lastError());
+        return false;
+    }
+
+    // Tidak ada baris: export ini belum pernah berjalan
+    if (query.next()) {
+        seq = query.value(0).toLongLong();
+    }
+
+    return true;
+}
+
+bool DatabaseManager::setExportWatermark(const QString &exportName, qint64 seq, const QString &tableName)
+{
+    TRACE_SPAN("db", "DatabaseManager::setExportWatermark");
+
+    if (!m_db.isOpen()) return false;
+
+    QSqlQuery query(m_db);
+    query.prepare("INSERT INTO export_state (name, last_seq) VALUES (:name, :seq) "
+                  "ON CONFLICT(name) DO UPDATE SET last_seq = excluded.last_seq");
+    query.bindValue(":name", exportName);
+    query.bindValue(":seq", seq);
+
+    {
+        QueryTimer timer(m_db, query, "setExportWatermark");
+        if (!query.exec()) {
+            timer.setFailed();
+            logError("setExportWatermark", query.lastError());
+            return false;
+        }
+    }
+
+    // Change log yang sudah dilewati semua export tidak diperlukan lagi
+    const QString sqlPrune = QString("DELETE FROM %1_changes WHERE seq <= (SELECT MIN(last_seq) FROM export_state)").arg(tableName);
+    QueryTimer pruneTimer(m_db, sqlPrune, "setExportWatermark");
+    if (!query.exec(sqlPrune)) {
+        pruneTimer.setFailed();
+        logError("setExportWatermark (prune)", query.lastError());
+    } else {
+        pruneTimer.addRows(query.numRowsAffected());
+    }
+
+    return true;
+}
+
 void DatabaseManager::logError(const QString &function, const QSqlError &error)
 {
-    qWarning() << "DatabaseManager Error (" << function << "):"
-               << "Type:" << error.type()
-               << "Text:" << error.text()
-               << "Driver Text:" << error.driverText()
-               << "Database Text:" << error.databaseText();
+    qCWarning(lcDb) << "DatabaseManager Error (" << function << "):"
+                    << "Type:" << error.type()
+                    << "Text:" << error.text()
+                    << "Driver Text:" << error.driverText()
+                    << "Database Text:" << error.databaseText();
 }
@@ -8,28 +8,83 @@
 #include <QList>
 #include <QSqlRecord>
 #include <QSqlError>
+#include <functional>
 #include <helpers/Environments.h>
 
 class DatabaseManager : public QObject
 {
     Q_OBJECT
 public:
+    // Perilaku saat baris baru bentrok dengan constraint UNIQUE (kolom nama)
+    enum ConflictPolicy {
+        AbortOnConflict,   // gagalkan batch (dan rollback transaksi)
+        SkipOnConflict,    // lewati baris yang bentrok (INSERT OR IGNORE)
+        UpdateOnConflict   // perbarui npm/kelas milik baris yang sudah ada (UPSERT)
+    };
+
     explicit DatabaseManager(const QString &databasePath, QObject *parent = nullptr);
+
+    // Koneksi tambahan dengan nama sendiri, mis. satu per worker thread.
+    // QSqlDatabase hanya boleh dipakai di thread yang membuatnya, jadi buat
+    // (dan hapus) objek ini di thread yang memakainya. readOnly membuka file
+    // tanpa izin tulis dan tanpa membuat tabel.
+    DatabaseManager(const QString &databasePath, const QString &connectionName,
+                    bool readOnly, QObject *parent = nullptr);
     ~DatabaseManager();
 
     bool isDatabaseOpen() const;
+    QString databasePath() const;
 
     // --- Fungsi CRUD Universal ---
 
     // INSERT (Mengembalikan ID baris yang dimasukkan, atau -1 jika gagal)
     qint64 insertRecord(const QString &tableName, const QVariantMap &data);
 
+    // INSERT banyak mahasiswa sekaligus dengan satu prepared statement.
+    // Tidak membuka transaksi sendiri, bungkus dengan beginTransaction()/commitTransaction()
+    // agar SQLite tidak melakukan commit (fsync) per baris.
+    // affectedRows diisi jumlah baris yang benar-benar tersimpan (baris yang dilewati tidak dihitung).
+    bool insertStudentsBatch(const QString &tableName,
+                             const QVector<StudentsDataStruct> &rows,
+                             ConflictPolicy policy = AbortOnConflict,
+                             qint64 *affectedRows = nullptr);
+
+    // --- Transaksi ---
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
+
     // SELECT (Mengembalikan daftar peta hasil)
     QList<StudentsDataStruct> selectRecords(const QString &tableName,
                                      const QStringList &columns, // <--- TERIMA PARAMETER INI
                                      const QString &condition = "",
                                      const QVariantMap &bindValues = QVariantMap());
 
+    // SELECT dengan cursor forward-only: setiap baris langsung diberikan ke callback
+    // tanpa menampung seluruh hasil di memori. Callback mengembalikan false untuk berhenti.
+    bool selectRecordsStreamed(const QString &tableName,
+                               const QString &condition,
+                               const QVariantMap &bindValues,
+                               const std::function<bool(const StudentsDataStruct &)> &callback);
+
+    // Satu halaman mahasiswa urut id (keyset paging: id > afterId, paling banyak limit baris).
+    // Memakai primary key, jadi setiap halaman sama cepatnya di tabel sebesar apa pun.
+    // Halaman berikutnya dimulai dari id baris terakhir; kurang dari limit berarti sudah habis.
+    bool selectRecordsPage(const QString &tableName, qint64 afterId, int limit,
+                           QList<StudentsDataStruct> &rows);
+
+    // Jumlah mahasiswa per kelas (GROUP BY di SQLite, memakai index kelas), urut berdasarkan kelas
+    bool selectGroupSummary(const QString &tableName, QList<StudentsGroupStruct> &groups);
+
+    // Semua mahasiswa urut per kelas lalu nama, dibaca dengan cursor forward-only.
+    // onGroup dipanggil setiap kali kelas berganti (sebelum baris pertama kelas itu)
+    // dengan jumlah anggota kelas dari SQL. Callback mengembalikan false untuk berhenti.
+    // kelas kosong berarti hanya kelas itu yang dibaca.
+    bool selectRecordsGrouped(const QString &tableName,
+                              const std::function<bool(const StudentsGroupStruct &)> &onGroup,
+                              const std::function<bool(const StudentsDataStruct &)> &onRow,
+                              const QString &kelas = QString());
+
     QVector<QStringList> selectRecordsToVector(const QString &tableName,
                                                const QStringList &columns, // <--- TERIMA PARAMETER INI
                                                const QString &condition = "",
@@ -46,9 +101,34 @@ public:
                       const QString &condition,
                       const QVariantMap &bindValues = QVariantMap());
 
+    // --- Change tracking ---
+    // Trigger pada tabel mahasiswa mencatat setiap INSERT/UPDATE/DELETE ke mahasiswa_changes
+    // dengan sequence yang selalu naik (AUTOINCREMENT, tidak dipakai ulang setelah prune).
+    // Hanya aktif selama export_state berisi minimal satu export, jadi log tidak tumbuh tanpa pembaca.
+
+    // Perubahan setelah sinceSeq, diringkas satu entri per mahasiswa dan diurutkan berdasarkan seq.
+    // sinceSeq < 0 berarti belum pernah export: semua baris dikembalikan sebagai Inserted.
+    // upToSeq diisi sequence terakhir yang pernah dibuat (sqlite_sequence), tidak pernah lebih
+    // kecil dari sinceSeq walaupun change log sudah kosong setelah prune.
+    bool selectChangesSince(const QString &tableName,
+                            qint64 sinceSeq,
+                            QList<StudentChangeStruct> &changes,
+                            qint64 &upToSeq);
+
+    // Watermark export (tabel export_state) ke seq, -1 jika export ini belum pernah berhasil.
+    // false kalau query gagal (mis. SQLITE_BUSY), seq tidak bisa dipakai.
+    bool exportWatermark(const QString &exportName, qint64 &seq);
+
+    // Simpan watermark lalu buang change log (<tableName>_changes) yang sudah dilewati semua export.
+    // seq = -1 mendaftarkan export sebelum snapshot pertamanya agar perubahan mulai dicatat.
+    bool setExportWatermark(const QString &exportName, qint64 seq,
+                            const QString &tableName = "mahasiswa");
+
 private:
     QSqlDatabase m_db;
     QString m_databasePath;
+    QString m_connectionName; // kosong = koneksi default
+    bool m_readOnly = false;
 
     bool openDatabase();
     void createTablesIfNotExist();
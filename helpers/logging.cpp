@@ -0,0 +1,228 @@
+#include "logging.h"
+#include "helpers/Environments.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <cstdio>
+
+Q_LOGGING_CATEGORY(lcDb, "crud.db", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcModel, "crud.model", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcCsv, "crud.csv", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcPdf, "crud.pdf", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcUi, "crud.ui", QtInfoMsg)
+
+namespace AppLog {
+
+namespace {
+
+// Batas antrean; pesan sesudahnya dibuang dan hanya dihitung
+constexpr int MAX_PENDING_LINES = 10000;
+// File dirotasi ke <nama>.1 setelah sebesar ini
+constexpr qint64 MAX_FILE_SIZE = 5 * 1024 * 1024;
+
+// Diformat di thread penulis, thread pemanggil hanya menyalin
+struct PendingLine
+{
+    qint64 msecs;
+    QtMsgType type;
+    QByteArray category;
+    QString message;
+};
+
+struct FileSink
+{
+    QMutex mutex;
+    QWaitCondition wake;
+    QVector<PendingLine> pending;
+    qint64 dropped = 0;
+    bool stopping = false;
+
+    // Hanya disentuh thread penulis selama sink terpasang
+    QFile file;
+
+    QThread *thread = nullptr;
+    QtMessageHandler previousHandler = nullptr;
+};
+
+FileSink &sink()
+{
+    static FileSink instance;
+    return instance;
+}
+
+const char *levelName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg: return "debug";
+    case QtInfoMsg: return "info";
+    case QtWarningMsg: return "warning";
+    case QtCriticalMsg: return "critical";
+    case QtFatalMsg: return "fatal";
+    }
+    return "?";
+}
+
+bool rotateIfNeeded(QFile &file)
+{
+    if (QFileInfo(file.fileName()).size() < MAX_FILE_SIZE) {
+        return true;
+    }
+
+    const QString filePath = file.fileName();
+    const bool wasOpen = file.isOpen();
+    file.close();
+    QFile::remove(filePath + ".1");
+    QFile::rename(filePath, filePath + ".1");
+
+    return !wasOpen || file.open(QIODevice::WriteOnly | QIODevice::Append);
+}
+
+void writerLoop()
+{
+    FileSink &s = sink();
+    QVector<PendingLine> batch;
+    QByteArray out;
+
+    for (;;) {
+        qint64 dropped = 0;
+        bool stopping = false;
+        {
+            QMutexLocker locker(&s.mutex);
+            while (s.pending.isEmpty() && !s.stopping) {
+                s.wake.wait(&s.mutex);
+            }
+            batch.swap(s.pending);
+            dropped = s.dropped;
+            s.dropped = 0;
+            stopping = s.stopping && s.pending.isEmpty();
+        }
+
+        out.clear();
+        for (const PendingLine &line : std::as_const(batch)) {
+            out += QDateTime::fromMSecsSinceEpoch(line.msecs).toString(Qt::ISODateWithMs).toUtf8();
+            out += ' ';
+            out += levelName(line.type);
+            out += ' ';
+            out += line.category;
+            out += ": ";
+            out += line.message.toUtf8();
+            out += '\n';
+        }
+        if (dropped > 0) {
+            out += QDateTime::currentDateTime().toString(Qt::ISODateWithMs).toUtf8()
+                 + " warning crud.log: " + QByteArray::number(dropped) + " pesan log dibuang (antrean penuh)\n";
+        }
+        batch.clear();
+
+        if (!out.isEmpty() && s.file.isOpen()) {
+            s.file.write(out);
+            s.file.flush();
+            rotateIfNeeded(s.file);
+        }
+
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    FileSink &s = sink();
+
+    {
+        QMutexLocker locker(&s.mutex);
+        if (s.pending.size() < MAX_PENDING_LINES) {
+            s.pending.append({QDateTime::currentMSecsSinceEpoch(), type,
+                              QByteArray(context.category ? context.category : "default"), message});
+        } else {
+            ++s.dropped;
+        }
+    }
+    s.wake.wakeOne();
+
+    if (type == QtDebugMsg || type == QtInfoMsg) {
+        return;
+    }
+
+    QtMessageHandler previous = s.previousHandler;
+    if (type == QtFatalMsg) {
+        // Handler sebelumnya akan abort, pastikan isi antrean sudah di disk
+        shutdown();
+    }
+
+    if (previous) {
+        previous(type, context, message);
+    } else {
+        fprintf(stderr, "%s\n", qPrintable(qFormatLogMessage(type, context, message)));
+    }
+}
+
+} // namespace
+
+QString defaultLogFilePath()
+{
+    return QString("%1/%2/logs/crudMahasiswa.log").arg(QDir::homePath()).arg(AppEnv::APP_HOMEDIR_NAME);
+}
+
+bool installFileSink(const QString &filePath, QString *error)
+{
+    FileSink &s = sink();
+    if (s.thread) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    s.file.setFileName(filePath);
+    rotateIfNeeded(s.file);
+    if (!s.file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (error) {
+            *error = s.file.errorString();
+        }
+        return false;
+    }
+
+    s.stopping = false;
+    s.thread = QThread::create(writerLoop);
+    s.thread->setObjectName("log-writer");
+    s.thread->start(QThread::LowPriority);
+
+    s.previousHandler = qInstallMessageHandler(messageHandler);
+
+    if (QCoreApplication::instance()) {
+        qAddPostRoutine(shutdown);
+    }
+
+    return true;
+}
+
+void shutdown()
+{
+    FileSink &s = sink();
+    if (!s.thread) {
+        return;
+    }
+
+    qInstallMessageHandler(s.previousHandler);
+
+    {
+        QMutexLocker locker(&s.mutex);
+        s.stopping = true;
+    }
+    s.wake.wakeOne();
+
+    s.thread->wait();
+    delete s.thread;
+    s.thread = nullptr;
+
+    s.file.close();
+}
+
+} // namespace AppLog
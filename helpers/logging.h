@@ -0,0 +1,38 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+#include <QString>
+
+// Kategori log per subsistem, dipakai dengan qCDebug/qCInfo/qCWarning:
+//
+//   qCDebug(lcDb) << "jumlah record:" << jmlRecord;
+//
+// Argumen << hanya dievaluasi kalau kategori dan levelnya aktif. Default
+// level info, debug dinyalakan lewat QT_LOGGING_RULES, misalnya
+// QT_LOGGING_RULES="crud.db.debug=true" atau "crud.*.debug=true".
+// Level debug/info bisa dibuang saat kompilasi, lihat CRUD_LOG_STRIP di core.pri.
+Q_DECLARE_LOGGING_CATEGORY(lcDb)    // crud.db
+Q_DECLARE_LOGGING_CATEGORY(lcModel) // crud.model
+Q_DECLARE_LOGGING_CATEGORY(lcCsv)   // crud.csv
+Q_DECLARE_LOGGING_CATEGORY(lcPdf)   // crud.pdf
+Q_DECLARE_LOGGING_CATEGORY(lcUi)    // crud.ui
+
+namespace AppLog {
+
+// ~/.crudMahasiswa/logs/crudMahasiswa.log
+QString defaultLogFilePath();
+
+// Pasang message handler yang menulis semua log ke file dari thread terpisah.
+// Thread pemanggil hanya memasukkan pesan ke antrean (dibuang kalau antrean
+// penuh), jadi log tidak pernah menunggu disk. Warning ke atas tetap
+// diteruskan ke handler sebelumnya (stderr).
+bool installFileSink(const QString &filePath, QString *error = nullptr);
+
+// Tulis sisa antrean lalu hentikan thread penulis. Dipanggil otomatis saat
+// QCoreApplication dihancurkan.
+void shutdown();
+
+} // namespace AppLog
+
+#endif // LOGGING_H
@@ -0,0 +1,112 @@
+#include "perfcounters.h"
+#include <QMutex>
+
+#if defined(Q_OS_MACOS) || defined(Q_OS_IOS)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#elif defined(Q_OS_LINUX)
+#include <QFile>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace PerfCounters {
+
+namespace {
+QMutex g_mutex;
+ExportSample g_lastExport;
+}
+
+void recordExport(const QString &kind, qint64 rows, qint64 bytes, qint64 elapsedMs)
+{
+    QMutexLocker locker(&g_mutex);
+    g_lastExport.kind = kind;
+    g_lastExport.rows = rows;
+    g_lastExport.bytes = bytes;
+    g_lastExport.elapsedMs = elapsedMs;
+    g_lastExport.time = QDateTime::currentDateTime();
+}
+
+ExportSample lastExport()
+{
+    QMutexLocker locker(&g_mutex);
+    return g_lastExport;
+}
+
+qint64 residentMemoryBytes()
+{
+#if defined(Q_OS_MACOS) || defined(Q_OS_IOS)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return -1;
+    }
+    return qint64(info.resident_size);
+#elif defined(Q_OS_LINUX)
+    // Kolom kedua statm: halaman yang resident
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#elif defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return -1;
+    }
+    return qint64(counters.WorkingSetSize);
+#else
+    return -1;
+#endif
+}
+
+qint64 peakResidentMemoryBytes()
+{
+#if defined(Q_OS_MACOS) || defined(Q_OS_IOS)
+    // ru_maxrss dalam byte di Darwin
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+    return qint64(usage.ru_maxrss);
+#elif defined(Q_OS_LINUX)
+    // VmHWM bisa di-reset lewat clear_refs, ru_maxrss tidak
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    for (const QByteArray &line : status.readAll().split('\n')) {
+        if (line.startsWith("VmHWM:")) {
+            return line.mid(6).trimmed().split(' ').value(0).toLongLong() * 1024;
+        }
+    }
+    return -1;
+#elif defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return -1;
+    }
+    return qint64(counters.PeakWorkingSetSize);
+#else
+    return -1;
+#endif
+}
+
+bool resetPeakResidentMemory()
+{
+#if defined(Q_OS_LINUX)
+    // "5" mengembalikan VmHWM ke RSS saat ini (Linux 4.0+)
+    QFile clearRefs("/proc/self/clear_refs");
+    return clearRefs.open(QIODevice::WriteOnly) && clearRefs.write("5") == 1;
+#else
+    return false;
+#endif
+}
+
+} // namespace PerfCounters
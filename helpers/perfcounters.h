@@ -0,0 +1,37 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <QString>
+#include <QDateTime>
+
+// Penghitung ringan yang dibaca HUD performa (PerfHudDock) dan alat lain.
+// Menulis cukup murah untuk dipanggil sekali per operasi (bukan per baris).
+namespace PerfCounters {
+
+struct ExportSample
+{
+    QString kind;         // "csv", "pdf", "pdf-batch", ...
+    qint64 rows = 0;
+    qint64 bytes = 0;     // 0 kalau tidak diketahui
+    qint64 elapsedMs = 0;
+    QDateTime time;       // kosong = belum pernah ada export
+};
+
+// Dipanggil setelah satu export selesai, dari thread mana saja
+void recordExport(const QString &kind, qint64 rows, qint64 bytes, qint64 elapsedMs);
+
+ExportSample lastExport();
+
+// Resident set size proses ini, -1 kalau tidak tersedia di platform ini
+qint64 residentMemoryBytes();
+
+// Resident set size tertinggi sejak start (atau sejak resetPeakResidentMemory), -1 kalau tidak tersedia
+qint64 peakResidentMemoryBytes();
+
+// Mulai ukur puncak baru dari RSS sekarang. Hanya Linux (clear_refs), false di platform lain:
+// puncaknya tetap dihitung sejak proses mulai.
+bool resetPeakResidentMemory();
+
+} // namespace PerfCounters
+
+#endif // PERFCOUNTERS_H
@@ -0,0 +1,170 @@
+#include "pixmapcache.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImageReader>
+#include <QPixmapCache>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+const QString ICON_INFORMATION = ":/sysicon/images/information-freepik-white.png";
+const QString ICON_CRITICAL = ":/sysicon/images/critical-freepik-white.png";
+const QString ICON_QUESTION = ":/sysicon/images/question-mark-freepik_white.png";
+
+qreal effectiveDpr(qreal dpr)
+{
+    return dpr > 0 ? dpr : qApp->devicePixelRatio();
+}
+}
+
+const QString PixmapCache::APP_LOGO = ":/logo/logos/logo_crudMahasiswa_512px.png";
+
+PixmapCache &PixmapCache::instance()
+{
+    static PixmapCache cache;
+    return cache;
+}
+
+QPixmap PixmapCache::pixmap(const QString &path, const QSize &size, qreal dpr)
+{
+    dpr = effectiveDpr(dpr);
+    const QString key = cacheKey(path, size, dpr);
+
+    QPixmap result;
+    if (QPixmapCache::find(key, &result)) {
+        QMutexLocker locker(&m_mutex);
+        m_stats.hits++;
+        return result;
+    }
+
+    QImage image;
+    {
+        QMutexLocker locker(&m_mutex);
+        image = m_prewarmed.take(key);
+        if (!image.isNull()) {
+            m_stats.prewarmed++;
+        }
+    }
+
+    if (image.isNull()) {
+        TRACE_SPAN("ui", "PixmapCache::decode");
+
+        QElapsedTimer timer;
+        timer.start();
+        image = decode(path, size * dpr);
+
+        QMutexLocker locker(&m_mutex);
+        m_stats.misses++;
+        m_stats.decodeMs += timer.nsecsElapsed() / 1e6;
+    }
+
+    if (image.isNull()) {
+        qCWarning(lcUi) << "PixmapCache: gagal memuat" << path;
+        return result;
+    }
+
+    result = QPixmap::fromImage(image);
+    result.setDevicePixelRatio(dpr);
+    QPixmapCache::insert(key, result);
+
+    return result;
+}
+
+QIcon PixmapCache::icon(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_icons.constFind(path);
+    if (it == m_icons.cend()) {
+        it = m_icons.insert(path, QIcon(path));
+    }
+    return it.value();
+}
+
+QPixmap PixmapCache::messageBoxIcon(QMessageBox::Icon type)
+{
+    const QSize size(MESSAGE_BOX_ICON_SIZE, MESSAGE_BOX_ICON_SIZE);
+
+    // Pasangan ikon sama seperti sebelumnya di MainWindow::appMessageBox
+    switch (type) {
+    case QMessageBox::Information:
+        return pixmap(ICON_INFORMATION, size);
+    case QMessageBox::Critical:
+    case QMessageBox::Question:
+        return pixmap(ICON_QUESTION, size);
+    case QMessageBox::Warning:
+    default:
+        return pixmap(ICON_CRITICAL, size);
+    }
+}
+
+void PixmapCache::prewarm(const QList<Request> &requests)
+{
+    QList<Request> pending;
+    for (Request request : requests) {
+        request.dpr = effectiveDpr(request.dpr);
+        const QString key = cacheKey(request.path, request.size, request.dpr);
+
+        QPixmap existing;
+        QMutexLocker locker(&m_mutex);
+        if (!QPixmapCache::find(key, &existing) && !m_prewarmed.contains(key)) {
+            pending.append(request);
+        }
+    }
+
+    if (pending.isEmpty() || m_prewarmFuture.isRunning()) {
+        return;
+    }
+
+    m_prewarmFuture = QtConcurrent::run([this, pending]() {
+        TRACE_SPAN("ui", "PixmapCache::prewarm");
+
+        for (const Request &request : pending) {
+            const QImage image = decode(request.path, request.size * request.dpr);
+            if (image.isNull()) {
+                continue;
+            }
+
+            QMutexLocker locker(&m_mutex);
+            m_prewarmed.insert(cacheKey(request.path, request.size, request.dpr), image);
+        }
+
+        qCDebug(lcUi) << "PixmapCache:" << pending.size() << "gambar di-decode di background";
+    });
+}
+
+void PixmapCache::prewarmDefaults()
+{
+    const QSize iconSize(MESSAGE_BOX_ICON_SIZE, MESSAGE_BOX_ICON_SIZE);
+
+    prewarm({{ICON_INFORMATION, iconSize, 0},
+             {ICON_CRITICAL, iconSize, 0},
+             {ICON_QUESTION, iconSize, 0},
+             {APP_LOGO, iconSize, 0}});
+}
+
+PixmapCache::Stats PixmapCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+QString PixmapCache::cacheKey(const QString &path, const QSize &size, qreal dpr)
+{
+    return QString("pixmapcache:%1@%2x%3@%4").arg(path).arg(size.width()).arg(size.height()).arg(dpr);
+}
+
+QImage PixmapCache::decode(const QString &path, const QSize &pixelSize)
+{
+    QImageReader reader(path);
+
+    // Diperkecil saat dibaca, seperti QIcon::pixmap(): aspek tetap, tidak pernah diperbesar
+    const QSize sourceSize = reader.size();
+    if (sourceSize.isValid() && !pixelSize.isEmpty()
+        && (sourceSize.width() > pixelSize.width() || sourceSize.height() > pixelSize.height())) {
+        reader.setScaledSize(sourceSize.scaled(pixelSize, Qt::KeepAspectRatio));
+    }
+
+    return reader.read();
+}
@@ -0,0 +1,76 @@
+#ifndef PIXMAPCACHE_H
+#define PIXMAPCACHE_H
+
+#include <QString>
+#include <QSize>
+#include <QHash>
+#include <QIcon>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QFuture>
+#include <QPixmap>
+#include <QMessageBox>
+
+// Satu tempat untuk ikon dan gambar dari resource (:/sysicon, :/logo, ...).
+// Setiap gambar di-decode sekali per ukuran dan device pixel ratio, lalu
+// disimpan di QPixmapCache; pemanggil berikutnya hanya mendapat salinan
+// implicitly shared. prewarm() men-decode di thread pool sebagai QImage
+// (QPixmap hanya boleh dibuat di GUI thread), pixmap() mengubahnya menjadi
+// QPixmap saat pertama diminta.
+// Semua fungsi dipanggil dari GUI thread, hanya decode prewarm() yang berjalan di thread pool.
+class PixmapCache
+{
+public:
+    struct Request
+    {
+        QString path;
+        QSize size;      // dalam device-independent pixel
+        qreal dpr = 0;   // 0 = qApp->devicePixelRatio()
+    };
+
+    struct Stats
+    {
+        qint64 hits = 0;
+        qint64 misses = 0;      // di-decode di GUI thread
+        qint64 prewarmed = 0;   // di-decode di background lalu dipakai
+        double decodeMs = 0;    // total decode di GUI thread
+    };
+
+    static PixmapCache &instance();
+
+    // Gambar di path, diperkecil (aspek dipertahankan) agar muat di size
+    QPixmap pixmap(const QString &path, const QSize &size, qreal dpr = 0);
+
+    // QIcon bersama per path; QIcon sendiri men-decode (sekali) per ukuran saat dipakai
+    QIcon icon(const QString &path);
+
+    // Ikon 64x64 untuk MainWindow::appMessageBox dan dialog lain
+    QPixmap messageBoxIcon(QMessageBox::Icon type);
+
+    // Decode di background, hasilnya dipakai pixmap() berikutnya.
+    // Yang sudah ada di cache dilewati.
+    void prewarm(const QList<Request> &requests);
+
+    // Ikon message box dan logo aplikasi, dipanggil setelah startup selesai
+    void prewarmDefaults();
+
+    Stats stats() const;
+
+    static constexpr int MESSAGE_BOX_ICON_SIZE = 64;
+    static const QString APP_LOGO;
+
+private:
+    PixmapCache() = default;
+
+    static QString cacheKey(const QString &path, const QSize &size, qreal dpr);
+    static QImage decode(const QString &path, const QSize &pixelSize);
+
+    mutable QMutex m_mutex;
+    QHash<QString, QImage> m_prewarmed; // cacheKey -> gambar yang belum jadi QPixmap
+    QHash<QString, QIcon> m_icons;
+    QFuture<void> m_prewarmFuture;
+    Stats m_stats;
+};
+
+#endif // PIXMAPCACHE_H
@@ -0,0 +1,379 @@
+#include "querystats.h"
+#include "helpers/Environments.h"
+#include "helpers/logging.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSqlError>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Batas cache SQL mentah -> bentuk, dikosongkan kalau penuh
+constexpr int MAX_CACHED_SHAPES = 2048;
+
+// Hanya statement ini yang punya query plan
+bool hasQueryPlan(const QString &sql)
+{
+    const QString head = sql.trimmed().left(6).toUpper();
+    return head.startsWith("SELECT") || head.startsWith("INSERT") || head.startsWith("UPDATE")
+           || head.startsWith("DELETE") || head.startsWith("WITH");
+}
+
+bool isIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_';
+}
+}
+
+QueryStats &QueryStats::instance()
+{
+    static QueryStats stats;
+    return stats;
+}
+
+QueryStats::QueryStats()
+    : m_enabled(true)
+    , m_slowThresholdMs(100)
+{
+}
+
+void QueryStats::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_enabled = enabled;
+}
+
+bool QueryStats::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
+
+void QueryStats::setSlowQueryThresholdMs(double ms)
+{
+    QMutexLocker locker(&m_mutex);
+    m_slowThresholdMs = ms;
+}
+
+double QueryStats::slowQueryThresholdMs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_slowThresholdMs;
+}
+
+void QueryStats::setSlowQueryLogPath(const QString &filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_slowLogPath = filePath;
+}
+
+QString QueryStats::slowQueryLogPath() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_slowLogPath;
+}
+
+QString QueryStats::defaultSlowQueryLogPath()
+{
+    return QString("%1/%2/logs/slow_queries.log").arg(QDir::homePath()).arg(AppEnv::APP_HOMEDIR_NAME);
+}
+
+QList<QueryStats::ShapeStats> QueryStats::shapeStats() const
+{
+    QList<ShapeStats> result;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        result.reserve(m_shapes.size());
+
+        for (auto it = m_shapes.cbegin(); it != m_shapes.cend(); ++it) {
+            const Shape &shape = it.value();
+
+            ShapeStats stats;
+            stats.shape = it.key();
+            stats.function = shape.function;
+            stats.calls = shape.calls;
+            stats.errors = shape.errors;
+            stats.rows = shape.rows;
+            stats.totalMs = shape.totalNs / 1e6;
+            stats.maxMs = shape.maxNs / 1e6;
+            stats.p50Ms = percentileMs(shape, 0.50);
+            stats.p95Ms = percentileMs(shape, 0.95);
+            stats.p99Ms = percentileMs(shape, 0.99);
+            stats.slowCalls = shape.slowCalls;
+            result.append(stats);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const ShapeStats &a, const ShapeStats &b) {
+        return a.totalMs > b.totalMs;
+    });
+
+    return result;
+}
+
+QList<QueryStats::SlowQuery> QueryStats::slowQueries() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_slowQueries;
+}
+
+QueryStats::LastQuery QueryStats::lastQuery() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lastQuery;
+}
+
+void QueryStats::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_shapes.clear();
+    m_slowQueries.clear();
+    m_lastQuery = LastQuery();
+}
+
+bool QueryStats::record(const QString &sql, const QString &function, qint64 elapsedNs, qint64 rows, bool success)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_enabled) {
+        return false;
+    }
+
+    auto cached = m_shapeCache.constFind(sql);
+    if (cached == m_shapeCache.cend()) {
+        if (m_shapeCache.size() >= MAX_CACHED_SHAPES) {
+            m_shapeCache.clear();
+        }
+        cached = m_shapeCache.insert(sql, normalizeSql(sql));
+    }
+
+    Shape &shape = m_shapes[cached.value()];
+    shape.function = function;
+    shape.calls++;
+    shape.rows += rows;
+    shape.totalNs += elapsedNs;
+    shape.maxNs = qMax(shape.maxNs, elapsedNs);
+    shape.buckets[bucketFor(elapsedNs)]++;
+    if (!success) {
+        shape.errors++;
+    }
+
+    m_lastQuery.function = function;
+    m_lastQuery.shape = cached.value();
+    m_lastQuery.durationMs = elapsedNs / 1e6;
+    m_lastQuery.rows = rows;
+    m_lastQuery.success = success;
+
+    const bool slow = m_slowThresholdMs > 0 && elapsedNs >= m_slowThresholdMs * 1e6;
+    if (slow) {
+        shape.slowCalls++;
+    }
+
+    return slow;
+}
+
+void QueryStats::recordSlowQuery(const SlowQuery &query)
+{
+    QString logPath;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_slowQueries.append(query);
+        if (m_slowQueries.size() > MAX_SLOW_QUERIES) {
+            m_slowQueries.removeFirst();
+        }
+        logPath = m_slowLogPath;
+    }
+
+    qCDebug(lcDb) << "Query lambat:" << query.function << QString::number(query.durationMs, 'f', 1) << "ms,"
+                  << query.rows << "baris:" << query.sql << query.plan;
+
+    if (logPath.isEmpty()) {
+        return;
+    }
+
+    QByteArray entry = query.time.toString(Qt::ISODateWithMs).toUtf8() + ' '
+                     + QByteArray::number(query.durationMs, 'f', 1) + " ms, "
+                     + QByteArray::number(query.rows) + " rows, "
+                     + QByteArray::number(query.bindCount) + " binds, "
+                     + query.function.toUtf8() + '\n'
+                     + query.sql.simplified().toUtf8() + '\n';
+    for (const QString &line : query.plan) {
+        entry += "  plan: " + line.toUtf8() + '\n';
+    }
+    entry += '\n';
+
+    // Jarang terjadi dan statement-nya sudah lambat, jadi ditulis langsung
+    static QMutex fileMutex;
+    QMutexLocker fileLocker(&fileMutex);
+
+    QDir().mkpath(QFileInfo(logPath).absolutePath());
+    QFile file(logPath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        file.write(entry);
+    }
+}
+
+QString QueryStats::normalizeSql(const QString &sql)
+{
+    QString shape;
+    shape.reserve(sql.size());
+
+    for (qsizetype i = 0; i < sql.size(); ++i) {
+        const QChar c = sql.at(i);
+
+        if (c.isSpace()) {
+            // Spasi berturut-turut jadi satu
+            while (i + 1 < sql.size() && sql.at(i + 1).isSpace()) {
+                ++i;
+            }
+            if (!shape.isEmpty()) {
+                shape += ' ';
+            }
+        } else if (c == '\'') {
+            // String literal ('' di dalamnya adalah kutip yang di-escape)
+            ++i;
+            while (i < sql.size()) {
+                if (sql.at(i) == '\'') {
+                    if (i + 1 < sql.size() && sql.at(i + 1) == '\'') {
+                        ++i;
+                    } else {
+                        break;
+                    }
+                }
+                ++i;
+            }
+            shape += '?';
+        } else if (c == ':' && i + 1 < sql.size() && isIdentifierChar(sql.at(i + 1))) {
+            // Placeholder bernama
+            while (i + 1 < sql.size() && isIdentifierChar(sql.at(i + 1))) {
+                ++i;
+            }
+            shape += '?';
+        } else if (c.isDigit() && (shape.isEmpty() || !isIdentifierChar(shape.back()))) {
+            // Angka yang berdiri sendiri, bukan bagian dari nama
+            while (i + 1 < sql.size() && (sql.at(i + 1).isDigit() || sql.at(i + 1) == '.')) {
+                ++i;
+            }
+            shape += '?';
+        } else {
+            shape += c;
+        }
+    }
+
+    return shape.trimmed();
+}
+
+int QueryStats::bucketFor(qint64 ns)
+{
+    if (ns <= (qint64(1) << MIN_OCTAVE)) {
+        return 0;
+    }
+
+    const int bucket = int((std::log2(double(ns)) - MIN_OCTAVE) * BUCKETS_PER_OCTAVE);
+    return qBound(0, bucket, BUCKET_COUNT - 1);
+}
+
+double QueryStats::percentileMs(const Shape &shape, double percentile)
+{
+    if (shape.calls == 0) {
+        return 0;
+    }
+
+    const qint64 target = qMax<qint64>(1, qint64(std::ceil(shape.calls * percentile)));
+    qint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += shape.buckets[i];
+        if (seen >= target) {
+            // Batas atas bucket, tidak pernah melebihi durasi terlama yang tercatat
+            const double upperNs = std::exp2(MIN_OCTAVE + double(i + 1) / BUCKETS_PER_OCTAVE);
+            return qMin(upperNs, double(shape.maxNs)) / 1e6;
+        }
+    }
+
+    return shape.maxNs / 1e6;
+}
+
+QueryTimer::QueryTimer(const QSqlDatabase &db, const QSqlQuery &query, const char *function)
+    : m_db(db)
+    , m_function(function)
+    , m_active(QueryStats::instance().isEnabled())
+{
+    if (m_active) {
+        m_sql = query.lastQuery();
+        m_bindValues = query.boundValues();
+        m_timer.start();
+    }
+}
+
+QueryTimer::QueryTimer(const QSqlDatabase &db, const QString &sql, const char *function)
+    : m_db(db)
+    , m_sql(sql)
+    , m_function(function)
+    , m_active(QueryStats::instance().isEnabled())
+{
+    if (m_active) {
+        m_timer.start();
+    }
+}
+
+QueryTimer::~QueryTimer()
+{
+    finish();
+}
+
+void QueryTimer::finish()
+{
+    if (!m_active) {
+        return;
+    }
+    m_active = false;
+
+    const qint64 elapsedNs = m_timer.nsecsElapsed();
+    const QString function = QString("DatabaseManager::%1").arg(QLatin1String(m_function));
+
+    if (!QueryStats::instance().record(m_sql, function, elapsedNs, m_rows, m_success)) {
+        return;
+    }
+
+    QueryStats::SlowQuery slow;
+    slow.time = QDateTime::currentDateTime();
+    slow.function = function;
+    slow.sql = m_sql;
+    slow.bindCount = m_bindValues.size();
+    slow.durationMs = elapsedNs / 1e6;
+    slow.rows = m_rows;
+    slow.plan = explainQueryPlan();
+    QueryStats::instance().recordSlowQuery(slow);
+}
+
+QStringList QueryTimer::explainQueryPlan() const
+{
+    QStringList plan;
+    if (!m_db.isOpen() || !hasQueryPlan(m_sql)) {
+        return plan;
+    }
+
+    // Nilai yang sama di-bind ulang sesuai posisinya
+    QSqlQuery explain(m_db);
+    if (!explain.prepare("EXPLAIN QUERY PLAN " + m_sql)) {
+        plan << "(EXPLAIN gagal: " + explain.lastError().text() + ")";
+        return plan;
+    }
+    for (int i = 0; i < m_bindValues.size(); ++i) {
+        explain.bindValue(i, m_bindValues.at(i));
+    }
+
+    if (!explain.exec()) {
+        plan << "(EXPLAIN gagal: " + explain.lastError().text() + ")";
+        return plan;
+    }
+
+    // Kolom: id, parent, notused, detail
+    while (explain.next()) {
+        plan << explain.value(3).toString();
+    }
+
+    return plan;
+}
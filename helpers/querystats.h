@@ -0,0 +1,163 @@
+#ifndef QUERYSTATS_H
+#define QUERYSTATS_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QVariant>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QElapsedTimer>
+#include <array>
+
+// Statistik latensi semua statement SQL dari DatabaseManager, dikelompokkan
+// per "bentuk" statement: literal dan placeholder diganti "?", jadi
+// "SELECT ... WHERE kelas = :kelas" untuk kelas berbeda masuk satu kelompok.
+// Setiap kelompok punya histogram log-scale (p50/p95/p99) dan jumlah baris.
+//
+// Statement yang lebih lambat dari slowQueryThresholdMs() dicatat bersama
+// EXPLAIN QUERY PLAN-nya (SCAN = full scan, SEARCH = memakai index), disimpan
+// di memori dan ditambahkan ke slowQueryLogPath() kalau diisi.
+// Aman dipanggil dari banyak thread (satu koneksi per thread).
+class QueryStats
+{
+public:
+    struct ShapeStats
+    {
+        QString shape;
+        QString function;  // fungsi DatabaseManager yang terakhir menjalankannya
+        qint64 calls = 0;
+        qint64 errors = 0;
+        qint64 rows = 0;   // baris yang dibaca (SELECT) atau diubah
+        double totalMs = 0;
+        double maxMs = 0;
+        double p50Ms = 0;
+        double p95Ms = 0;
+        double p99Ms = 0;
+        qint64 slowCalls = 0;
+    };
+
+    struct SlowQuery
+    {
+        QDateTime time;
+        QString function;
+        QString sql;
+        int bindCount = 0;
+        double durationMs = 0;
+        qint64 rows = 0;
+        QStringList plan; // baris EXPLAIN QUERY PLAN
+    };
+
+    struct LastQuery
+    {
+        QString function;
+        QString shape;
+        double durationMs = 0;
+        qint64 rows = 0;
+        bool success = true;
+    };
+
+    static QueryStats &instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    void setSlowQueryThresholdMs(double ms); // default 100 ms, <= 0 mematikan slow-query log
+    double slowQueryThresholdMs() const;
+
+    // Kosong = slow query hanya disimpan di memori
+    void setSlowQueryLogPath(const QString &filePath);
+    QString slowQueryLogPath() const;
+
+    // ~/.crudMahasiswa/logs/slow_queries.log
+    static QString defaultSlowQueryLogPath();
+
+    // Urut dari total waktu terbesar
+    QList<ShapeStats> shapeStats() const;
+
+    // Slow query terbaru di akhir, paling banyak MAX_SLOW_QUERIES
+    QList<SlowQuery> slowQueries() const;
+
+    // Statement terakhir yang dicatat (function kosong = belum ada)
+    LastQuery lastQuery() const;
+
+    void reset();
+
+    // Dipakai QueryTimer. Mengembalikan true kalau statement termasuk lambat,
+    // pemanggil lalu mengisi plan dan memanggil recordSlowQuery().
+    bool record(const QString &sql, const QString &function, qint64 elapsedNs, qint64 rows, bool success);
+    void recordSlowQuery(const SlowQuery &query);
+
+    static QString normalizeSql(const QString &sql);
+
+    static constexpr int MAX_SLOW_QUERIES = 200;
+
+private:
+    QueryStats();
+
+    // Histogram log-scale: 4 bucket per kelipatan dua (resolusi ~19%),
+    // dari ~1 µs sampai ~4,5 menit
+    static constexpr int BUCKETS_PER_OCTAVE = 4;
+    static constexpr int MIN_OCTAVE = 10; // 2^10 ns
+    static constexpr int OCTAVES = 28;
+    static constexpr int BUCKET_COUNT = BUCKETS_PER_OCTAVE * OCTAVES;
+
+    struct Shape
+    {
+        QString function;
+        qint64 calls = 0;
+        qint64 errors = 0;
+        qint64 rows = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+        qint64 slowCalls = 0;
+        std::array<qint64, BUCKET_COUNT> buckets{};
+    };
+
+    static int bucketFor(qint64 ns);
+    static double percentileMs(const Shape &shape, double percentile);
+
+    mutable QMutex m_mutex;
+    bool m_enabled;
+    double m_slowThresholdMs;
+    QString m_slowLogPath;
+    QHash<QString, Shape> m_shapes;
+    QHash<QString, QString> m_shapeCache; // SQL mentah -> bentuk
+    QList<SlowQuery> m_slowQueries;
+    LastQuery m_lastQuery;
+};
+
+// Mengukur satu statement dari exec sampai baris terakhir dibaca (biaya
+// full scan SQLite ada di next(), bukan di exec()). Dibuat tepat sebelum
+// exec, setelah semua bindValue, lalu dicatat saat finish() atau destruktor.
+class QueryTimer
+{
+public:
+    QueryTimer(const QSqlDatabase &db, const QSqlQuery &query, const char *function);
+    QueryTimer(const QSqlDatabase &db, const QString &sql, const char *function);
+    ~QueryTimer();
+
+    void addRows(qint64 rows = 1) { m_rows += rows; }
+    void setFailed() { m_success = false; }
+    void finish();
+
+    QueryTimer(const QueryTimer &) = delete;
+    QueryTimer &operator=(const QueryTimer &) = delete;
+
+private:
+    QStringList explainQueryPlan() const;
+
+    QSqlDatabase m_db;
+    QString m_sql;
+    QVariantList m_bindValues;
+    const char *m_function;
+    QElapsedTimer m_timer;
+    qint64 m_rows = 0;
+    bool m_success = true;
+    bool m_active;
+};
+
+#endif // QUERYSTATS_H
@@ -0,0 +1,354 @@
+#include "stallwatchdog.h"
+#include "helpers/Environments.h"
+#include "helpers/logging.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+
+#if defined(Q_OS_UNIX) && __has_include(<execinfo.h>)
+#define CRUD_HAS_BACKTRACE
+#include <execinfo.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include <pthread.h>
+#include <signal.h>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace {
+// Selama ping belum dijawab, watchdog memeriksa sesering ini
+constexpr int POLL_MS = 5;
+// Laporan dirotasi ke <nama>.1 setelah sebesar ini
+constexpr qint64 MAX_REPORT_SIZE = 1024 * 1024;
+
+#ifdef CRUD_HAS_BACKTRACE
+constexpr int MAX_FRAMES = 64;
+// Frame handler sinyal dan trampolinnya, bukan bagian dari kode yang macet
+constexpr int SKIPPED_FRAMES = 2;
+
+void *g_frames[MAX_FRAMES];
+std::atomic<int> g_frameCount(0);
+// Nomor permintaan sampel terakhir, dan nomor yang sudah dijawab handler.
+// Selama keduanya berbeda ada sinyal yang belum ditangani (mis. datang
+// terlambat setelah timeout), g_frames bisa ditulis kapan saja.
+std::atomic<quint64> g_requestedSample(0);
+std::atomic<quint64> g_answeredSample(0);
+
+// Berjalan di GUI thread, hanya mengisi buffer; simbolnya dicari di thread watchdog
+void sampleHandler(int)
+{
+    const quint64 request = g_requestedSample.load(std::memory_order_acquire);
+    g_frameCount.store(backtrace(g_frames, MAX_FRAMES), std::memory_order_relaxed);
+    g_answeredSample.store(request, std::memory_order_release);
+}
+
+bool installSampleHandler()
+{
+    static const bool installed = []() {
+        // Panggilan pertama backtrace() memuat library unwinder (malloc),
+        // jangan sampai terjadi di dalam handler
+        void *warmUp[1];
+        backtrace(warmUp, 1);
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = sampleHandler;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        return sigaction(SIGUSR2, &action, nullptr) == 0;
+    }();
+    return installed;
+}
+
+QString describeFrame(void *address)
+{
+    Dl_info info;
+    if (!dladdr(address, &info)) {
+        return QString("0x%1").arg(quintptr(address), 0, 16);
+    }
+
+    const QString module = info.dli_fname ? QFileInfo(QString::fromLocal8Bit(info.dli_fname)).fileName() : QString("?");
+    if (!info.dli_sname) {
+        return QString("0x%1 (%2)").arg(quintptr(address), 0, 16).arg(module);
+    }
+
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    const QString name = QString::fromUtf8(status == 0 && demangled ? demangled : info.dli_sname);
+    free(demangled);
+
+    return QString("%1 + 0x%2 (%3)").arg(name).arg(quintptr(address) - quintptr(info.dli_saddr), 0, 16).arg(module);
+}
+#endif
+}
+
+StallWatchdog::StallWatchdog(int thresholdMs)
+    : m_thresholdMs(qMax(1, thresholdMs))
+{
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+}
+
+void StallWatchdog::setThresholdMs(int thresholdMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_thresholdMs = qMax(1, thresholdMs);
+}
+
+int StallWatchdog::thresholdMs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_thresholdMs;
+}
+
+void StallWatchdog::setReportPath(const QString &filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_reportPath = filePath;
+}
+
+QString StallWatchdog::reportPath() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_reportPath;
+}
+
+QString StallWatchdog::defaultReportPath()
+{
+    return QString("%1/%2/logs/stalls.log").arg(QDir::homePath()).arg(AppEnv::APP_HOMEDIR_NAME);
+}
+
+bool StallWatchdog::start()
+{
+    if (m_thread) {
+        return true;
+    }
+
+    QCoreApplication *app = QCoreApplication::instance();
+    if (!app || QThread::currentThread() != app->thread()) {
+        qCWarning(lcUi) << "StallWatchdog: start() harus dipanggil dari GUI thread";
+        return false;
+    }
+
+    m_receiver.reset(new QObject());
+    m_guiStack = Tracer::currentStack();
+    m_guiThreadId = QThread::currentThreadId();
+    Tracer::setStackTracking(true);
+
+#ifdef CRUD_HAS_BACKTRACE
+    if (!installSampleHandler()) {
+        qCWarning(lcUi) << "StallWatchdog: handler sinyal gagal dipasang, hanya span stack yang dicatat";
+    }
+#endif
+
+    m_stopping = false;
+    m_pingPending.store(false);
+    m_pongNs.store(Tracer::nowNs());
+    m_lastLatencyNs.store(-1);
+
+    m_thread.reset(QThread::create([this]() { run(); }));
+    m_thread->setObjectName("stall-watchdog");
+    m_thread->start();
+
+    return true;
+}
+
+void StallWatchdog::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+    }
+    m_wake.wakeOne();
+
+    m_thread->wait();
+    m_thread.reset();
+
+    // Ping yang masih antre ikut terbuang bersama penerimanya
+    m_receiver.reset();
+    Tracer::setStackTracking(false);
+}
+
+bool StallWatchdog::isRunning() const
+{
+    return !m_thread.isNull();
+}
+
+QList<StallWatchdog::Stall> StallWatchdog::stalls() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stalls;
+}
+
+qint64 StallWatchdog::stallCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stallCount;
+}
+
+qint64 StallWatchdog::longestStallMs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_longestStallMs;
+}
+
+double StallWatchdog::lastLatencyMs() const
+{
+    const qint64 latencyNs = m_lastLatencyNs.load(std::memory_order_relaxed);
+    return latencyNs < 0 ? -1.0 : latencyNs / 1e6;
+}
+
+void StallWatchdog::run()
+{
+    bool inStall = false;
+    Stall stall;
+    qint64 pingSentNs = 0;
+    qint64 nextPingNs = 0;
+
+    QMutexLocker locker(&m_mutex);
+    while (!m_stopping) {
+        const qint64 thresholdNs = qint64(m_thresholdMs) * 1000000;
+        locker.unlock();
+
+        qint64 now = Tracer::nowNs();
+        const bool pending = m_pingPending.load(std::memory_order_acquire);
+
+        if (!pending) {
+            const qint64 pongNs = m_pongNs.load(std::memory_order_relaxed);
+            if (pingSentNs > 0 && pongNs >= pingSentNs) {
+                m_lastLatencyNs.store(pongNs - pingSentNs, std::memory_order_relaxed);
+            }
+            if (inStall) {
+                // Ping sudah dijawab, macetnya selesai
+                stall.durationMs = (pongNs - pingSentNs) / 1000000;
+                if (Tracer::isEnabled()) {
+                    Tracer::record("ui", "UI stall", pingSentNs, pongNs);
+                }
+                finishStall(stall);
+                inStall = false;
+            }
+            // Satu ping per threshold, GUI thread tidak dibangunkan lebih sering
+            nextPingNs = pongNs + thresholdNs;
+        }
+
+        if (!pending && now >= nextPingNs) {
+            pingSentNs = now;
+            m_pingPending.store(true, std::memory_order_release);
+            QMetaObject::invokeMethod(m_receiver.get(), [this]() {
+                m_pongNs.store(Tracer::nowNs(), std::memory_order_relaxed);
+                m_pingPending.store(false, std::memory_order_release);
+            }, Qt::QueuedConnection);
+        } else if (pending && !inStall && now - pingSentNs >= thresholdNs) {
+            // GUI thread masih sibuk: catat apa yang sedang dikerjakannya sekarang
+            inStall = true;
+            stall = Stall();
+            stall.time = QDateTime::currentDateTime().addMSecs(-(now - pingSentNs) / 1000000);
+            stall.spans = Tracer::stackSnapshot(m_guiStack);
+            stall.backtrace = sampleBacktrace();
+        }
+
+        now = Tracer::nowNs();
+        const bool waitingForPong = m_pingPending.load(std::memory_order_acquire);
+        const qint64 waitMs = waitingForPong ? POLL_MS : qBound<qint64>(1, (nextPingNs - now) / 1000000, thresholdNs / 1000000);
+
+        locker.relock();
+        if (!m_stopping) {
+            m_wake.wait(&m_mutex, waitMs);
+        }
+    }
+}
+
+void StallWatchdog::finishStall(const Stall &stall)
+{
+    QString reportPath;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stalls.append(stall);
+        if (m_stalls.size() > MAX_STALLS) {
+            m_stalls.removeFirst();
+        }
+        m_stallCount++;
+        m_longestStallMs = qMax(m_longestStallMs, stall.durationMs);
+        reportPath = m_reportPath;
+    }
+
+    qCWarning(lcUi) << "UI macet" << stall.durationMs << "ms di"
+                    << (stall.spans.isEmpty() ? QString("(tanpa span)") : stall.spans.join(" > "));
+
+    if (!reportPath.isEmpty()) {
+        QFile file(reportPath);
+        if (file.size() >= MAX_REPORT_SIZE) {
+            QFile::remove(reportPath + ".1");
+            QFile::rename(reportPath, reportPath + ".1");
+        }
+
+        QDir().mkpath(QFileInfo(reportPath).absolutePath());
+        if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            file.write(formatStall(stall));
+        }
+    }
+}
+
+QByteArray StallWatchdog::formatStall(const Stall &stall)
+{
+    QByteArray text = stall.time.toString(Qt::ISODateWithMs).toUtf8() + " UI macet "
+                    + QByteArray::number(stall.durationMs) + " ms\n";
+    text += "  span: " + (stall.spans.isEmpty() ? QByteArray("(tanpa span)") : stall.spans.join(" > ").toUtf8()) + '\n';
+    for (int i = 0; i < stall.backtrace.size(); ++i) {
+        text += "  #" + QByteArray::number(i) + ' ' + stall.backtrace.at(i).toUtf8() + '\n';
+    }
+    text += '\n';
+    return text;
+}
+
+QStringList StallWatchdog::sampleBacktrace()
+{
+    QStringList frames;
+
+#ifdef CRUD_HAS_BACKTRACE
+    // Handler dari permintaan sebelumnya (yang timeout) belum berjalan: jangan
+    // kirim sinyal baru, handler yang terlambat itu masih bisa menimpa g_frames
+    const quint64 previous = g_requestedSample.load(std::memory_order_relaxed);
+    if (g_answeredSample.load(std::memory_order_acquire) != previous) {
+        frames << "(sampel backtrace sebelumnya belum dijawab)";
+        return frames;
+    }
+
+    const quint64 request = previous + 1;
+    g_requestedSample.store(request, std::memory_order_release);
+    if (pthread_kill(reinterpret_cast<pthread_t>(m_guiThreadId), SIGUSR2) != 0) {
+        // Tidak ada sinyal yang menunggu, permintaan ini dianggap sudah dijawab
+        g_answeredSample.store(request, std::memory_order_release);
+        return frames;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    while (g_answeredSample.load(std::memory_order_acquire) != request) {
+        if (timer.elapsed() > 100) {
+            frames << "(sampel backtrace tidak diterima)";
+            return frames;
+        }
+        QThread::usleep(200);
+    }
+
+    // Dijawab untuk permintaan ini; permintaan berikutnya baru dikirim setelah
+    // frame ini selesai dibaca, jadi tidak ada handler lain yang menulis
+    const int count = g_frameCount.load(std::memory_order_relaxed);
+    for (int i = SKIPPED_FRAMES; i < count; ++i) {
+        frames << describeFrame(g_frames[i]);
+    }
+#endif
+
+    return frames;
+}
@@ -0,0 +1,89 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QDateTime>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QScopedPointer>
+#include <atomic>
+#include "helpers/tracer.h"
+
+// Mendeteksi event loop GUI yang macet. Thread watchdog mengirim "ping"
+// (queued call) ke GUI thread; kalau tidak dijawab dalam thresholdMs(), GUI
+// thread dianggap macet dan watchdog mencatat span yang sedang terbuka di
+// GUI thread (Tracer::stackSnapshot) serta satu sampel backtrace native.
+// Setelah ping dijawab, durasi totalnya dicatat ke laporan stall
+// (~/.crudMahasiswa/logs/stalls.log, dirotasi) dan ke log crud.ui.
+//
+// Backtrace native tersedia di macOS dan Linux (sinyal ke GUI thread,
+// lalu backtrace() di dalam handler-nya), di platform lain hanya span stack.
+class StallWatchdog
+{
+public:
+    struct Stall
+    {
+        QDateTime time;        // saat macet mulai (ping dikirim)
+        qint64 durationMs = 0; // sampai ping dijawab
+        QStringList spans;     // span terbuka di GUI thread, terluar dulu
+        QStringList backtrace; // frame teratas dulu
+    };
+
+    explicit StallWatchdog(int thresholdMs = 50);
+    ~StallWatchdog();
+
+    void setThresholdMs(int thresholdMs);
+    int thresholdMs() const;
+
+    // Kosong = laporan hanya disimpan di memori
+    void setReportPath(const QString &filePath);
+    QString reportPath() const;
+
+    // ~/.crudMahasiswa/logs/stalls.log
+    static QString defaultReportPath();
+
+    // Dipanggil dari GUI thread setelah QCoreApplication dibuat
+    bool start();
+    void stop();
+    bool isRunning() const;
+
+    // Stall terbaru di akhir, paling banyak MAX_STALLS
+    QList<Stall> stalls() const;
+    qint64 stallCount() const;
+    qint64 longestStallMs() const;
+
+    // Waktu tunggu ping terakhir yang sudah dijawab, -1 kalau belum ada
+    double lastLatencyMs() const;
+
+    static constexpr int MAX_STALLS = 100;
+
+private:
+    void run();
+    void finishStall(const Stall &stall);
+    QStringList sampleBacktrace();
+    static QByteArray formatStall(const Stall &stall);
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    bool m_stopping = false;
+    int m_thresholdMs;
+    QString m_reportPath;
+    QList<Stall> m_stalls;
+    qint64 m_stallCount = 0;
+    qint64 m_longestStallMs = 0;
+
+    QScopedPointer<QThread> m_thread;
+    QScopedPointer<QObject> m_receiver; // konteks ping di GUI thread
+    Tracer::SpanStack *m_guiStack = nullptr;
+    Qt::HANDLE m_guiThreadId = nullptr;
+
+    std::atomic<bool> m_pingPending{false};
+    std::atomic<qint64> m_pongNs{0};
+    std::atomic<qint64> m_lastLatencyNs{-1};
+};
+
+#endif // STALLWATCHDOG_H
@@ -0,0 +1,107 @@
+#include "startupprofile.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+#include <QMutex>
+
+namespace StartupProfile {
+
+namespace {
+QMutex g_mutex;
+qint64 g_startNs = -1;
+qint64 g_lastNs = -1;
+bool g_finished = false;
+QList<Phase> g_phases;
+
+// Dipanggil dengan g_mutex terkunci
+bool markLocked(const char *phase)
+{
+    if (g_startNs < 0) {
+        return false;
+    }
+
+    const QString name = QString::fromLatin1(phase);
+    for (const Phase &existing : std::as_const(g_phases)) {
+        if (existing.name == name) {
+            return false;
+        }
+    }
+
+    const qint64 now = Tracer::nowNs();
+    g_phases.append({name, (now - g_startNs) / 1e6, (now - g_lastNs) / 1e6});
+    if (Tracer::isEnabled()) {
+        Tracer::record("startup", phase, g_lastNs, now);
+    }
+    g_lastNs = now;
+
+    return true;
+}
+}
+
+void start()
+{
+    QMutexLocker locker(&g_mutex);
+    g_startNs = g_lastNs = Tracer::nowNs();
+    g_finished = false;
+    g_phases.clear();
+}
+
+void mark(const char *phase)
+{
+    QMutexLocker locker(&g_mutex);
+    if (!g_finished && markLocked(phase)) {
+        qCDebug(lcUi).noquote() << "Startup:" << g_phases.last().name << "pada"
+                                << QString::number(g_phases.last().atMs, 'f', 1) << "ms";
+    }
+}
+
+void finish(const char *phase)
+{
+    {
+        QMutexLocker locker(&g_mutex);
+        if (g_finished || g_startNs < 0) {
+            return;
+        }
+        markLocked(phase);
+        g_finished = true;
+    }
+
+    qCInfo(lcUi).noquote() << summary();
+}
+
+bool isFinished()
+{
+    QMutexLocker locker(&g_mutex);
+    return g_finished;
+}
+
+double phaseMs(const QString &phase)
+{
+    QMutexLocker locker(&g_mutex);
+    for (const Phase &existing : std::as_const(g_phases)) {
+        if (existing.name == phase) {
+            return existing.atMs;
+        }
+    }
+    return -1;
+}
+
+QList<Phase> phases()
+{
+    QMutexLocker locker(&g_mutex);
+    return g_phases;
+}
+
+QString summary()
+{
+    const QList<Phase> list = phases();
+
+    QStringList parts;
+    for (const Phase &phase : list) {
+        parts << QString("%1 %2 ms (+%3)").arg(phase.name)
+                                          .arg(phase.atMs, 0, 'f', 1)
+                                          .arg(phase.deltaMs, 0, 'f', 1);
+    }
+    return "Startup: " + parts.join(", ");
+}
+
+} // namespace StartupProfile
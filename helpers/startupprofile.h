@@ -0,0 +1,39 @@
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+#include <QString>
+#include <QList>
+
+// Waktu setiap fase startup sejak start() dipanggil di awal main():
+//
+//   StartupProfile::mark("stylesheet");
+//
+// Hanya kemunculan pertama setiap fase yang dicatat, jadi mark() boleh
+// dipanggil dari jalur yang juga dipakai setelah startup (mis. reload data).
+// Setiap fase juga direkam sebagai span "startup" kalau Tracer aktif.
+// finish() menulis ringkasannya ke log crud.ui sekali saja.
+// phase harus string literal, sama seperti nama span Tracer.
+namespace StartupProfile {
+
+struct Phase
+{
+    QString name;
+    double atMs = 0;    // sejak start()
+    double deltaMs = 0; // sejak fase sebelumnya
+};
+
+void start();
+void mark(const char *phase);
+
+// Mencatat fase terakhir lalu menulis ringkasan, hanya sekali
+void finish(const char *phase);
+bool isFinished();
+
+// -1 kalau fase itu belum tercatat
+double phaseMs(const QString &phase);
+QList<Phase> phases();
+QString summary();
+
+} // namespace StartupProfile
+
+#endif // STARTUPPROFILE_H
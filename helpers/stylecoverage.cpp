@@ -0,0 +1,38 @@
+#include "stylecoverage.h"
+#include "logging.h"
+#include <QEvent>
+#include <QWidget>
+
+StyleCoverageCheck::StyleCoverageCheck(const QStringList &droppedClasses, QObject *parent)
+    : QObject(parent)
+    , m_droppedClasses(droppedClasses.cbegin(), droppedClasses.cend())
+{
+}
+
+QStringList StyleCoverageCheck::missingClasses() const
+{
+    QStringList classes(m_missingClasses.cbegin(), m_missingClasses.cend());
+    classes.sort();
+    return classes;
+}
+
+bool StyleCoverageCheck::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Polish && watched->isWidgetType()) {
+        // Selector stylesheet cocok dengan kelas widget maupun kelas dasarnya
+        for (const QMetaObject *meta = watched->metaObject(); meta; meta = meta->superClass()) {
+            const QString className = QString::fromLatin1(meta->className());
+            if (m_droppedClasses.contains(className) && !m_missingClasses.contains(className)) {
+                m_missingClasses.insert(className);
+                qCWarning(lcUi) << "Stylesheet: rule untuk" << className << "dibuang, tapi dipakai oleh"
+                                << watched->metaObject()->className() << watched->objectName()
+                                << "- tambahkan ke AppStyle::usedWidgetClasses()";
+            }
+            if (meta == &QWidget::staticMetaObject) {
+                break;
+            }
+        }
+    }
+
+    return QObject::eventFilter(watched, event);
+}
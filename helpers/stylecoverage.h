@@ -0,0 +1,32 @@
+#ifndef STYLECOVERAGE_H
+#define STYLECOVERAGE_H
+
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+
+// Memeriksa stylesheet hasil pangkas terhadap widget yang benar-benar dibuat:
+// setiap widget (termasuk child di dalam dialog Qt seperti QFileDialog) yang
+// di-polish dicek rantai kelasnya. Kelas yang rule-nya dibuang qssprune berarti
+// usedWidgetClasses() kurang lengkap, dicatat sekali per kelas ke log crud.ui.
+// Dipasang sebagai event filter di QApplication, hanya saat diminta karena
+// melihat semua event aplikasi.
+class StyleCoverageCheck : public QObject
+{
+    Q_OBJECT
+public:
+    // droppedClasses: AppStyle::PruneStats::droppedClasses dari stylesheet yang dipakai
+    explicit StyleCoverageCheck(const QStringList &droppedClasses, QObject *parent = nullptr);
+
+    // Kelas widget yang dipakai tapi rule-nya tidak ada di stylesheet, urut
+    QStringList missingClasses() const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    QSet<QString> m_droppedClasses;
+    QSet<QString> m_missingClasses;
+};
+
+#endif // STYLECOVERAGE_H
@@ -0,0 +1,205 @@
+#include "stylesheet.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSet>
+
+namespace AppStyle {
+
+namespace {
+bool isIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_' || c == '-';
+}
+
+bool isCombinator(QChar c)
+{
+    return c.isSpace() || c == '>' || c == '+' || c == '~';
+}
+
+// Semua nama kelas di satu selector, mis. "QTabWidget > QTabBar::tab:selected"
+QStringList selectorClasses(const QString &selector)
+{
+    QStringList classes;
+    bool typePosition = true;
+
+    for (qsizetype i = 0; i < selector.size(); ++i) {
+        const QChar c = selector.at(i);
+
+        if (isCombinator(c)) {
+            typePosition = true;
+        } else if (c == '[') {
+            // Atribut selector, isinya (termasuk string) bukan nama kelas
+            while (i < selector.size() && selector.at(i) != ']') {
+                ++i;
+            }
+            typePosition = false;
+        } else if (typePosition && c.isLetter()) {
+            const qsizetype start = i;
+            while (i + 1 < selector.size() && isIdentifierChar(selector.at(i + 1))) {
+                ++i;
+            }
+            classes << selector.mid(start, i - start + 1);
+            typePosition = false;
+        } else {
+            // *, .kelas, #id, :pseudo dan ::sub-control
+            typePosition = false;
+        }
+    }
+
+    return classes;
+}
+
+QString stripComments(const QString &text)
+{
+    QString result;
+    result.reserve(text.size());
+
+    qsizetype i = 0;
+    while (i < text.size()) {
+        if (text.at(i) == '/' && i + 1 < text.size() && text.at(i + 1) == '*') {
+            const qsizetype end = text.indexOf("*/", i + 2);
+            if (end < 0) {
+                break;
+            }
+            i = end + 2;
+        } else {
+            result += text.at(i);
+            ++i;
+        }
+    }
+
+    return result;
+}
+}
+
+QStringList usedWidgetClasses()
+{
+    return QStringList()
+        // MainWindow, AboutDialog, QueryStatsDialog, HUD performa
+        << "QWidget" << "QMainWindow" << "QDialog" << "QMenuBar" << "QMenu" << "QStatusBar" << "QSizeGrip"
+        << "QDockWidget" << "QGroupBox" << "QLabel" << "QLineEdit" << "QPushButton" << "QAbstractSpinBox"
+        << "QTabWidget" << "QTabBar" << "QToolTip"
+        // Tabel mahasiswa dan tabel statistik
+        << "QAbstractScrollArea" << "QAbstractItemView" << "QTableView" << "QHeaderView"
+        << "QTableCornerButton" << "QScrollBar"
+        // QMessageBox, QProgressDialog
+        << "QDialogButtonBox" << "QTextEdit" << "QCheckBox" << "QProgressBar"
+        // QPrintPreviewDialog dan preview laporan: toolbar, combo zoom (popup-nya QListView), halaman
+        << "QToolBar" << "QToolButton" << "QComboBox" << "QListView" << "QGraphicsView"
+        // Isi QTabWidget, dan QFileDialog non-native (daftar file dan panel samping)
+        << "QStackedWidget" << "QTreeView" << "QSplitter";
+}
+
+QString pruneStyleSheet(const QString &styleSheet, const QStringList &usedClasses, PruneStats *stats)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QSet<QString> used(usedClasses.cbegin(), usedClasses.cend());
+    const QString text = stripComments(styleSheet);
+    QSet<QString> dropped;
+
+    QString result;
+    result.reserve(text.size() / 2);
+
+    int rules = 0;
+    int keptRules = 0;
+
+    qsizetype pos = 0;
+    while (true) {
+        const qsizetype open = text.indexOf('{', pos);
+        if (open < 0) {
+            break;
+        }
+        const qsizetype close = text.indexOf('}', open + 1);
+        if (close < 0) {
+            break;
+        }
+
+        ++rules;
+
+        QStringList keptSelectors;
+        const QStringList selectors = text.mid(pos, open - pos).split(',');
+        for (const QString &selector : selectors) {
+            const QString simplified = selector.simplified();
+            if (simplified.isEmpty()) {
+                continue;
+            }
+
+            bool keep = true;
+            for (const QString &className : selectorClasses(simplified)) {
+                if (!used.contains(className)) {
+                    keep = false;
+                    dropped.insert(className);
+                }
+            }
+            if (keep) {
+                keptSelectors << simplified;
+            }
+        }
+
+        if (!keptSelectors.isEmpty()) {
+            ++keptRules;
+            result += keptSelectors.join(',');
+            result += '{';
+            result += text.mid(open + 1, close - open - 1).simplified();
+            result += "}\n";
+        }
+
+        pos = close + 1;
+    }
+
+    if (stats) {
+        stats->rules = rules;
+        stats->keptRules = keptRules;
+        stats->inputBytes = styleSheet.toUtf8().size();
+        stats->outputBytes = result.toUtf8().size();
+        stats->elapsedMs = timer.nsecsElapsed() / 1e6;
+        stats->droppedClasses = QStringList(dropped.cbegin(), dropped.cend());
+        stats->droppedClasses.sort();
+    }
+
+    return result;
+}
+
+QString generatedHeader(const PruneStats &stats)
+{
+    return QString("/* qssprune: %1 of %2 rules, %3 of %4 bytes */\n/* dropped: %5 */\n")
+        .arg(stats.keptRules).arg(stats.rules).arg(stats.outputBytes).arg(stats.inputBytes)
+        .arg(stats.droppedClasses.join(' '));
+}
+
+bool loadStyleSheet(const QString &filePath, QString &styleSheet, PruneStats *stats, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    styleSheet = QString::fromUtf8(file.readAll());
+
+    if (stats) {
+        *stats = PruneStats();
+        stats->inputBytes = stats->outputBytes = styleSheet.toUtf8().size();
+
+        // Header dari generatedHeader(), dua baris komentar pertama
+        static const QRegularExpression header(
+            "^/\\* qssprune: (\\d+) of (\\d+) rules, (\\d+) of (\\d+) bytes \\*/\n/\\* dropped: ([^*]*) \\*/");
+        const QRegularExpressionMatch match = header.match(styleSheet);
+        if (match.hasMatch()) {
+            stats->keptRules = match.captured(1).toInt();
+            stats->rules = match.captured(2).toInt();
+            stats->outputBytes = match.captured(3).toLongLong();
+            stats->inputBytes = match.captured(4).toLongLong();
+            stats->droppedClasses = match.captured(5).split(' ', Qt::SkipEmptyParts);
+        }
+    }
+
+    return true;
+}
+
+} // namespace AppStyle
@@ -0,0 +1,44 @@
+#ifndef STYLESHEET_H
+#define STYLESHEET_H
+
+#include <QString>
+#include <QStringList>
+
+// Pemangkasan stylesheet aplikasi (darkstyle.qss, ~2200 baris hasil qtsass):
+// komentar dan spasi dibuang, dan rule yang selector-nya menyebut widget yang
+// tidak pernah dibuat aplikasi ini (QCalendarWidget, QSlider, ...) dibuang.
+// Dijalankan saat build oleh tools/qssprune, hasilnya (darkstyle.pruned.qss)
+// masuk resource; ikon url() milik rule yang dibuang tidak pernah dimuat.
+// Kalau menambah jenis widget baru di UI, tambahkan kelasnya ke usedWidgetClasses(),
+// StyleCoverageCheck memperingatkan kelas yang terlewat saat aplikasi berjalan.
+// Hanya butuh QtCore.
+namespace AppStyle {
+
+struct PruneStats
+{
+    int rules = 0;
+    int keptRules = 0;
+    qint64 inputBytes = 0;
+    qint64 outputBytes = 0;
+    double elapsedMs = 0;
+    QStringList droppedClasses; // kelas yang rule-nya dibuang, urut
+};
+
+// Kelas widget (termasuk kelas dasarnya) yang muncul di jendela dan dialog aplikasi
+QStringList usedWidgetClasses();
+
+// Rule tanpa nama kelas (*, .class, #id) selalu dipertahankan. Selector dengan
+// beberapa kelas (mis. "QTabWidget QTabBar") hanya dipertahankan kalau semuanya dipakai.
+QString pruneStyleSheet(const QString &styleSheet, const QStringList &usedClasses, PruneStats *stats = nullptr);
+
+// Komentar di awal file hasil pangkas, berisi statistik dan daftar kelas yang dibuang
+QString generatedHeader(const PruneStats &stats);
+
+// Baca file stylesheet (boleh dari resource). Kalau file hasil qssprune,
+// stats diisi dari header-nya; selain itu hanya ukuran file.
+bool loadStyleSheet(const QString &filePath, QString &styleSheet,
+                    PruneStats *stats = nullptr, QString *error = nullptr);
+
+} // namespace AppStyle
+
+#endif // STYLESHEET_H
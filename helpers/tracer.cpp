@@ -0,0 +1,317 @@
+#include "tracer.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QSaveFile>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace Tracer {
+
+std::atomic<unsigned> g_flags(0);
+
+namespace {
+
+struct Event
+{
+    const char *category;
+    const char *name;
+    qint64 start;
+    qint64 end;
+    int threadId;
+};
+
+// Satu slot ring buffer, dilindungi seqlock. seq = 2 * index + 1 selama event
+// ke-index ditulis dan 2 * index + 2 setelah selesai, jadi pembaca tahu event
+// mana yang ada di slot dan apakah slot itu berubah selama disalin.
+// Semua field atomic (relaxed) agar baca-tulis bersamaan bukan data race.
+struct EventSlot
+{
+    std::atomic<quint64> seq{0};
+    std::atomic<const char *> category{nullptr};
+    std::atomic<const char *> name{nullptr};
+    std::atomic<qint64> start{0};
+    std::atomic<qint64> end{0};
+    std::atomic<int> threadId{0};
+};
+
+// Ditulis hanya oleh thread pemiliknya, dibaca (disalin) saat trace disimpan
+struct ThreadBuffer
+{
+    std::unique_ptr<EventSlot[]> events{new EventSlot[EVENTS_PER_THREAD]};
+    std::atomic<quint64> head{0}; // jumlah event yang pernah ditulis
+    quint64 clearedAt = 0;        // event sebelum indeks ini sudah di-clear() (dijaga mutex)
+};
+
+struct Registry
+{
+    QMutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer *> freeBuffers; // milik thread yang sudah selesai
+    QHash<int, QString> threadNames;
+    int nextThreadId = 1;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+// Buffer dikembalikan ke registry saat thread selesai, dipakai ulang oleh
+// thread berikutnya (thread pool membuat thread baru untuk setiap ekspor)
+struct ThreadSlot
+{
+    ThreadBuffer *buffer = nullptr;
+    int threadId = 0;
+
+    ~ThreadSlot()
+    {
+        if (buffer) {
+            Registry &reg = registry();
+            QMutexLocker locker(&reg.mutex);
+            reg.freeBuffers.push_back(buffer);
+        }
+    }
+};
+
+thread_local ThreadSlot t_slot;
+
+thread_local SpanStack t_stack;
+
+void acquireBuffer(ThreadSlot &slot)
+{
+    QString name;
+    QThread *thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        name = "main";
+    } else if (thread && !thread->objectName().isEmpty()) {
+        name = thread->objectName();
+    }
+
+    Registry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    if (reg.freeBuffers.empty()) {
+        reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+        slot.buffer = reg.buffers.back().get();
+    } else {
+        slot.buffer = reg.freeBuffers.back();
+        reg.freeBuffers.pop_back();
+    }
+
+    slot.threadId = reg.nextThreadId++;
+    reg.threadNames.insert(slot.threadId, name.isEmpty() ? QString("thread %1").arg(slot.threadId) : name);
+}
+
+void appendJsonString(QByteArray &out, const char *text)
+{
+    out += '"';
+    for (const char *c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+            out += *c;
+        } else if (uchar(*c) < 0x20) {
+            out += ' ';
+        } else {
+            out += *c;
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+void setEnabled(bool enabled)
+{
+    nowNs(); // epoch dimulai sebelum span pertama
+    if (enabled) {
+        g_flags.fetch_or(RecordingFlag, std::memory_order_relaxed);
+    } else {
+        g_flags.fetch_and(~unsigned(RecordingFlag), std::memory_order_relaxed);
+    }
+}
+
+qint64 nowNs()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void setStackTracking(bool enabled)
+{
+    if (enabled) {
+        g_flags.fetch_or(StackTrackingFlag, std::memory_order_relaxed);
+    } else {
+        g_flags.fetch_and(~unsigned(StackTrackingFlag), std::memory_order_relaxed);
+    }
+}
+
+SpanStack *currentStack()
+{
+    return &t_stack;
+}
+
+SpanStack *pushStack(const char *name)
+{
+    SpanStack *stack = &t_stack;
+    const int depth = stack->depth.load(std::memory_order_relaxed);
+    if (depth < MAX_STACK_DEPTH) {
+        stack->names[depth].store(name, std::memory_order_relaxed);
+    }
+    stack->depth.store(depth + 1, std::memory_order_release);
+    return stack;
+}
+
+void popStack(SpanStack *stack)
+{
+    stack->depth.store(stack->depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+}
+
+QStringList stackSnapshot(const SpanStack *stack)
+{
+    QStringList names;
+    if (!stack) {
+        return names;
+    }
+
+    // Bisa sedikit terlambat dari pemiliknya, tapi nama selalu string literal yang valid
+    const int depth = qMin(stack->depth.load(std::memory_order_acquire), MAX_STACK_DEPTH);
+    for (int i = 0; i < depth; ++i) {
+        if (const char *name = stack->names[i].load(std::memory_order_relaxed)) {
+            names << QString::fromLatin1(name);
+        }
+    }
+    if (stack->depth.load(std::memory_order_relaxed) > MAX_STACK_DEPTH) {
+        names << "...";
+    }
+
+    return names;
+}
+
+void record(const char *category, const char *name, qint64 startNs, qint64 endNs)
+{
+    ThreadSlot &slot = t_slot;
+    if (!slot.buffer) {
+        acquireBuffer(slot);
+    }
+
+    ThreadBuffer *buffer = slot.buffer;
+    const quint64 head = buffer->head.load(std::memory_order_relaxed);
+    EventSlot &event = buffer->events[head % EVENTS_PER_THREAD];
+
+    // Ganjil dulu, field baru terlihat setelahnya (fence), lalu genap untuk event ini
+    event.seq.store(2 * head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.category.store(category, std::memory_order_relaxed);
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(startNs, std::memory_order_relaxed);
+    event.end.store(endNs, std::memory_order_relaxed);
+    event.threadId.store(slot.threadId, std::memory_order_relaxed);
+    event.seq.store(2 * head + 2, std::memory_order_release);
+
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void clear()
+{
+    Registry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    // head hanya boleh ditulis pemiliknya, jadi cukup tandai batasnya
+    for (const std::unique_ptr<ThreadBuffer> &buffer : reg.buffers) {
+        buffer->clearedAt = buffer->head.load(std::memory_order_acquire);
+    }
+}
+
+bool writeChromeTrace(const QString &filePath, QString *error)
+{
+    std::vector<Event> events;
+    QHash<int, QString> threadNames;
+
+    {
+        Registry &reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        threadNames = reg.threadNames;
+
+        for (const std::unique_ptr<ThreadBuffer> &buffer : reg.buffers) {
+            const quint64 head = buffer->head.load(std::memory_order_acquire);
+            quint64 first = head > quint64(EVENTS_PER_THREAD) ? head - EVENTS_PER_THREAD : 0;
+            first = qMax(first, buffer->clearedAt);
+
+            // Slot yang sedang ditulis, sudah ditimpa event yang lebih baru atau
+            // berubah selama disalin dibuang, tidak pernah ada event campuran
+            for (quint64 i = first; i < head; ++i) {
+                const EventSlot &slot = buffer->events[i % EVENTS_PER_THREAD];
+                const quint64 seq = slot.seq.load(std::memory_order_acquire);
+                if (seq != 2 * i + 2) {
+                    continue;
+                }
+
+                const Event event = {
+                    slot.category.load(std::memory_order_relaxed),
+                    slot.name.load(std::memory_order_relaxed),
+                    slot.start.load(std::memory_order_relaxed),
+                    slot.end.load(std::memory_order_relaxed),
+                    slot.threadId.load(std::memory_order_relaxed)
+                };
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) == seq) {
+                    events.push_back(event);
+                }
+            }
+        }
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray json;
+    json.reserve(int(events.size()) * 128 + 1024);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool firstEvent = true;
+    for (auto it = threadNames.cbegin(); it != threadNames.cend(); ++it) {
+        if (!firstEvent) {
+            json += ",\n";
+        }
+        firstEvent = false;
+
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid
+              + ",\"tid\":" + QByteArray::number(it.key()) + ",\"args\":{\"name\":";
+        appendJsonString(json, it.value().toUtf8().constData());
+        json += "}}";
+    }
+
+    // Complete events ("ph":"X"), waktu dalam mikrodetik
+    for (const Event &event : events) {
+        if (!firstEvent) {
+            json += ",\n";
+        }
+        firstEvent = false;
+
+        json += "{\"name\":";
+        appendJsonString(json, event.name);
+        json += ",\"cat\":";
+        appendJsonString(json, event.category);
+        json += ",\"ph\":\"X\",\"ts\":" + QByteArray::number(event.start / 1000.0, 'f', 3)
+              + ",\"dur\":" + QByteArray::number((event.end - event.start) / 1000.0, 'f', 3)
+              + ",\"pid\":" + pid + ",\"tid\":" + QByteArray::number(event.threadId) + "}";
+    }
+
+    json += "\n]}\n";
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Tracer
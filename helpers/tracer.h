@@ -0,0 +1,146 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QStringList>
+#include <atomic>
+
+// Tracing ringan dengan span bertingkat (RAII), bisa disimpan sebagai Chrome
+// trace JSON lalu dibuka di Perfetto (ui.perfetto.dev) atau chrome://tracing.
+//
+//   void DatabaseManager::selectRecords(...)
+//   {
+//       TRACE_SPAN("db", "DatabaseManager::selectRecords");
+//       ...
+//   }
+//
+// Setiap thread mencatat ke ring buffer miliknya sendiri tanpa lock, event
+// terlama ditimpa kalau buffer penuh. Saat tracing dan stack tracking mati,
+// biaya satu span hanya satu pembacaan flag dan satu branch.
+// name dan category harus string literal (pointernya yang disimpan).
+//
+// Terpisah dari rekaman, setiap thread juga bisa mencatat span yang sedang
+// terbuka (setStackTracking) agar thread lain bisa melihat apa yang sedang
+// dikerjakan, dipakai oleh StallWatchdog.
+namespace Tracer {
+
+// Jumlah event yang disimpan per thread
+constexpr int EVENTS_PER_THREAD = 16384;
+
+// Kedalaman span terbuka yang dicatat per thread, span yang lebih dalam diabaikan
+constexpr int MAX_STACK_DEPTH = 32;
+
+// Semua flag dalam satu word, jadi Span cukup membaca satu kali
+enum Flag : unsigned {
+    RecordingFlag = 1u << 0,
+    StackTrackingFlag = 1u << 1
+};
+
+extern std::atomic<unsigned> g_flags;
+
+inline bool isEnabled()
+{
+    return g_flags.load(std::memory_order_relaxed) & RecordingFlag;
+}
+
+void setEnabled(bool enabled);
+
+inline bool isStackTracking()
+{
+    return g_flags.load(std::memory_order_relaxed) & StackTrackingFlag;
+}
+
+void setStackTracking(bool enabled);
+
+// Span yang sedang terbuka di satu thread. Hanya pemiliknya yang menulis,
+// thread lain boleh membaca kapan saja lewat stackSnapshot().
+struct SpanStack
+{
+    std::atomic<int> depth{0};
+    std::atomic<const char *> names[MAX_STACK_DEPTH] = {};
+};
+
+// Stack milik thread pemanggil
+SpanStack *currentStack();
+
+// Nama span terbuka dari yang terluar, boleh dipanggil dari thread lain
+QStringList stackSnapshot(const SpanStack *stack);
+
+// Tulis semua event yang masih ada di buffer sebagai Chrome trace JSON
+bool writeChromeTrace(const QString &filePath, QString *error = nullptr);
+
+// Buang semua event yang sudah tercatat
+void clear();
+
+// Dipakai oleh Span, bukan untuk dipanggil langsung
+qint64 nowNs();
+void record(const char *category, const char *name, qint64 startNs, qint64 endNs);
+SpanStack *pushStack(const char *name);
+void popStack(SpanStack *stack);
+
+class Span
+{
+public:
+    Span(const char *category, const char *name)
+        : m_flags(g_flags.load(std::memory_order_relaxed))
+    {
+        if (m_flags) {
+            begin(category, name);
+        }
+    }
+
+    ~Span()
+    {
+        if (m_flags) {
+            end();
+        }
+    }
+
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+private:
+    void begin(const char *category, const char *name)
+    {
+        m_category = category;
+        m_name = name;
+        if (m_flags & RecordingFlag) {
+            m_start = nowNs();
+        }
+        if (m_flags & StackTrackingFlag) {
+            m_stack = pushStack(name);
+        }
+    }
+
+    void end()
+    {
+        if (m_stack) {
+            popStack(m_stack);
+        }
+        if (m_flags & RecordingFlag) {
+            record(m_category, m_name, m_start, nowNs());
+        }
+    }
+
+    const unsigned m_flags; // flag saat span dibuat, 0 = tidak dicatat sama sekali
+    const char *m_category = nullptr;
+    const char *m_name = nullptr;
+    qint64 m_start = 0;
+    SpanStack *m_stack = nullptr; // nullptr = stack tracking mati saat span dibuat
+};
+
+} // namespace Tracer
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+// Span dari baris ini sampai akhir scope.
+// DEFINES += CRUD_NO_TRACING menghapus semua span saat kompilasi.
+#ifdef CRUD_NO_TRACING
+#define TRACE_SPAN(category, name) static_cast<void>(0)
+#else
+#define TRACE_SPAN(category, name) \
+    Tracer::Span TRACE_CONCAT(traceSpan_, __LINE__)(category, name)
+#endif
+
+#endif // TRACER_H
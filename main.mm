@@ -2,6 +2,13 @@
 
 #include <QApplication>
 #include <QStyleFactory>
+#include <QCommandLineParser>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include "helpers/stylecoverage.h"
+#include "helpers/stylesheet.h"
 #include <AppKit/AppKit.h>
 
 /**** beberapa method untuk kustomisasi warna dari titlebar khusus untuk macos ****/
@@ -19,7 +26,7 @@ bool isDark(QColor color) {
 
 void setCustomizedTitleBar(WId i, QColor clrInHexFromWidgetbG){
       NSView* viewDiag = (NSView*)i;
-      qDebug() << Q_FUNC_INFO << viewDiag;
+      qCDebug(lcUi) << Q_FUNC_INFO << viewDiag;
       NSWindow* windowDiag = [viewDiag window];
       windowDiag.titlebarAppearsTransparent = YES;
 
@@ -29,45 +36,190 @@ void setCustomizedTitleBar(WId i, QColor clrInHexFromWidgetbG){
 
 void checkForHomeDir(){
     QString dirStr  = QString("%1/%2").arg(QDir::homePath()).arg(AppEnv::APP_HOMEDIR_NAME);
-    qDebug() << Q_FUNC_INFO << dirStr;
+    qCDebug(lcUi) << Q_FUNC_INFO << dirStr;
     QDir dr(dirStr);
 
     if (!dr.exists()){
-        qDebug() << Q_FUNC_INFO << "the home directory not exist, proceed to make it one";
+        qCInfo(lcUi) << Q_FUNC_INFO << "the home directory not exist, proceed to make it one";
         dr.mkpath(dirStr);
     } else {
-        qDebug() << Q_FUNC_INFO << "the home directory already there, so no need to make it";
+        qCDebug(lcUi) << Q_FUNC_INFO << "the home directory already there, so no need to make it";
     }
 }
 
+// Hasil --startup-benchmark, dengan info build dan mesin seperti "crudmahasiswa-cli bench"
+bool writeStartupBenchmark(const QString &filePath, qint64 rowCount, bool prunedStyle,
+                           const AppStyle::PruneStats &styleStats, const QStringList &missingStyleClasses,
+                           qint64 stallCount)
+{
+    QJsonArray phases;
+    for (const StartupProfile::Phase &phase : StartupProfile::phases()) {
+        QJsonObject object;
+        object["name"] = phase.name;
+        object["atMs"] = phase.atMs;
+        object["deltaMs"] = phase.deltaMs;
+        phases.append(object);
+    }
+
+    QJsonObject style;
+    style["pruned"] = prunedStyle;
+    style["rules"] = styleStats.rules;
+    style["keptRules"] = styleStats.keptRules;
+    style["inputBytes"] = styleStats.inputBytes;
+    style["outputBytes"] = styleStats.outputBytes;
+    style["droppedClasses"] = QJsonArray::fromStringList(styleStats.droppedClasses);
+    style["missingClasses"] = QJsonArray::fromStringList(missingStyleClasses);
+
+    QJsonObject root;
+    root["tool"] = "tutorialCRUDMahasiswa --startup-benchmark";
+    root["version"] = APP_VERSION;
+    root["qtVersion"] = qVersion();
+    root["platform"] = QGuiApplication::platformName();
+    root["os"] = QSysInfo::prettyProductName();
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["rows"] = rowCount;
+    root["timeToWindowShownMs"] = StartupProfile::phaseMs("window shown");
+    root["timeToFirstRowMs"] = StartupProfile::phaseMs("first rows");
+    root["timeToFullLoadMs"] = StartupProfile::phaseMs("full load");
+    root["uiStalls"] = stallCount;
+    root["stylesheet"] = style;
+    root["phases"] = phases;
+
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    QFile file(filePath == "-" ? QString() : filePath);
+    const bool opened = filePath == "-" ? file.open(stdout, QIODevice::WriteOnly) : file.open(QIODevice::WriteOnly);
+    return opened && file.write(json) == json.size();
+}
+
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+
+    // Fase startup dicatat ke log crud.ui setelah semua data dimuat
+    StartupProfile::start();
+
+    // Benchmark startup, bisa tanpa layar:
+    //   QT_QPA_PLATFORM=offscreen tutorialCRUDMahasiswa --startup-benchmark --benchmark-output startup.json
+    // Aplikasi keluar sendiri setelah semua data dimuat.
+    QCommandLineParser parser;
+    QCommandLineOption benchmarkOption("startup-benchmark", "Ukur startup, tulis hasilnya sebagai JSON lalu keluar");
+    QCommandLineOption benchmarkOutputOption("benchmark-output", "File hasil benchmark (default: - = stdout)", "file", "-");
+    QCommandLineOption fullStyleOption("full-stylesheet", "Pakai darkstyle.qss utuh, bukan hasil pangkas saat build (pembanding)");
+    parser.addOptions({benchmarkOption, benchmarkOutputOption, fullStyleOption});
+    // Argumen lain (mis. dari Qt Creator atau macOS) diabaikan
+    parser.parse(a.arguments());
+    const bool startupBenchmark = parser.isSet(benchmarkOption);
+
+    // CRUDMAHASISWA_TRACE=1: rekam trace sejak aplikasi dibuka (menu Debug > Simpan Trace)
+    if (qEnvironmentVariableIntValue("CRUDMAHASISWA_TRACE") > 0) {
+        Tracer::setEnabled(true);
+    }
+
     checkForHomeDir();
 
-    //apply css
-    QFile fCss(":/qdarkstyle/dark/darkstyle.qss");
-    if (fCss.open(QFile::ReadOnly | QFile::Text)) {
-        QString styleSheet = QLatin1String(fCss.readAll());
-        // 2. Terapkan Stylesheet ke aplikasi
+    // Semua log juga ditulis ke ~/.crudMahasiswa/logs dari thread terpisah
+    QString logError;
+    if (!AppLog::installFileSink(AppLog::defaultLogFilePath(), &logError)) {
+        qCWarning(lcUi) << "Gagal membuka file log:" << logError;
+    }
+
+    // Query lambat (default >= 100 ms) dicatat beserta EXPLAIN QUERY PLAN-nya,
+    // batasnya bisa diubah dengan CRUDMAHASISWA_SLOW_QUERY_MS atau menu Debug > Statistik Query
+    QueryStats::instance().setSlowQueryLogPath(QueryStats::defaultSlowQueryLogPath());
+    if (qEnvironmentVariableIsSet("CRUDMAHASISWA_SLOW_QUERY_MS")) {
+        QueryStats::instance().setSlowQueryThresholdMs(qEnvironmentVariableIntValue("CRUDMAHASISWA_SLOW_QUERY_MS"));
+    }
+
+    StartupProfile::mark("init");
+
+    //apply css, hanya rule untuk widget yang dipakai aplikasi (dipangkas saat build, lihat AppStyle::usedWidgetClasses)
+    const bool pruneStyle = !parser.isSet(fullStyleOption);
+    const QString stylePath = pruneStyle ? ":/qdarkstyle/dark/darkstyle.pruned.qss" : ":/qdarkstyle/dark/darkstyle.qss";
+    AppStyle::PruneStats styleStats;
+    QString styleSheet;
+    QString styleError;
+    if (AppStyle::loadStyleSheet(stylePath, styleSheet, &styleStats, &styleError)) {
+        // Diterapkan sebelum jendela dibuat agar setiap widget hanya di-polish sekali
         a.setStyleSheet(styleSheet);
-        fCss.close();
+        qCDebug(lcUi) << "Stylesheet:" << styleStats.keptRules << "dari" << styleStats.rules << "rule,"
+                      << styleStats.outputBytes << "dari" << styleStats.inputBytes << "byte";
     } else {
-        qWarning("Gagal memuat style.qss!");
+        qCWarning(lcUi) << "Gagal memuat style.qss!" << styleError;
+    }
+
+    // CRUDMAHASISWA_STYLE_CHECK=1 (dan --startup-benchmark): peringatan untuk widget yang rule-nya ikut dibuang
+    StyleCoverageCheck *styleCheck = nullptr;
+    if (pruneStyle && (startupBenchmark || qEnvironmentVariableIntValue("CRUDMAHASISWA_STYLE_CHECK") > 0)) {
+        styleCheck = new StyleCoverageCheck(styleStats.droppedClasses, &a);
+        a.installEventFilter(styleCheck);
     }
+    StartupProfile::mark("stylesheet");
+
+    // Event loop yang macet >= 50 ms dicatat ke ~/.crudMahasiswa/logs/stalls.log
+    // beserta span dan backtrace GUI thread (CRUDMAHASISWA_STALL_MS, 0 = mati).
+    // Dibuat sebelum jendela agar hidup lebih lama dari MainWindow (perf HUD memegang pointernya)
+    const int stallThresholdMs = qEnvironmentVariableIsSet("CRUDMAHASISWA_STALL_MS")
+                                     ? qEnvironmentVariableIntValue("CRUDMAHASISWA_STALL_MS")
+                                     : 50;
+    StallWatchdog stallWatchdog(stallThresholdMs);
+    stallWatchdog.setReportPath(StallWatchdog::defaultReportPath());
 
     MainWindow w;
 
     //apply custom title bar color in macOS
     QColor clrInHexFromWidgetbG = QColor::fromString("#19232d"); //replace this color in hex with default QWidget background-color from applied theme (in css file)
 
+    // WId hanya NSView di platform cocoa (bukan offscreen/minimal)
+    const bool cocoa = QGuiApplication::platformName() == "cocoa";
+
     QObject::connect(&w, &MainWindow::dialogWinId, [&](WId i){
-        setCustomizedTitleBar(i, clrInHexFromWidgetbG);
+        if (cocoa) {
+            setCustomizedTitleBar(i, clrInHexFromWidgetbG);
+        }
     });
     // qDebug() << Q_FUNC_INFO << w.effectiveWinId();
 
-    setCustomizedTitleBar(w.effectiveWinId(), clrInHexFromWidgetbG);
+    if (cocoa) {
+        setCustomizedTitleBar(w.effectiveWinId(), clrInHexFromWidgetbG);
+    }
 
     w.show();
-    return a.exec();
+    StartupProfile::mark("window shown");
+
+    // Baru dimulai setelah jendela tampil, pembuatan jendela bukan stall
+    if (stallThresholdMs > 0) {
+        stallWatchdog.start();
+    }
+    w.setStallWatchdog(&stallWatchdog);
+
+    // Ikon message box dan logo di-decode di background setelah data pertama kali dimuat
+    QObject::connect(&w, &MainWindow::studentsDataLoaded, &a, []() {
+        PixmapCache::instance().prewarmDefaults();
+    }, Qt::SingleShotConnection);
+
+    if (startupBenchmark) {
+        const QString benchmarkOutput = parser.value(benchmarkOutputOption);
+        QObject::connect(&w, &MainWindow::studentsDataLoaded, &a, [&](qint64 rowCount) {
+            const bool written = writeStartupBenchmark(benchmarkOutput, rowCount, pruneStyle, styleStats,
+                                                       styleCheck ? styleCheck->missingClasses() : QStringList(),
+                                                       stallWatchdog.stallCount());
+            if (!written) {
+                qCWarning(lcUi) << "Gagal menulis hasil benchmark ke" << benchmarkOutput;
+            }
+            QCoreApplication::exit(written ? 0 : 1);
+        }, Qt::SingleShotConnection);
+
+        // Database gagal dibuka = data tidak pernah selesai dimuat
+        QTimer::singleShot(60000, &a, []() {
+            qCWarning(lcUi) << "Benchmark startup: data tidak selesai dimuat dalam 60 detik";
+            QCoreApplication::exit(2);
+        });
+    }
+
+    const int exitCode = a.exec();
+
+    stallWatchdog.stop();
+    AppLog::shutdown();
+    return exitCode;
 }
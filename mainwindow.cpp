@@ -8,23 +8,48 @@ MainWindow::MainWindow(QWidget *parent)
     , tblModel(new TableModel(ui->tableView))
     , proxModel(new QSortFilterProxyModel(this))
 {
+    StartupProfile::mark("db open");
+
     ui->setupUi(this);
 
     QRegularExpression rxNPM("\\d+");
     npmValidator.reset(new QRegularExpressionValidator(rxNPM, this));
 
+    reportCache.reset(new ReportCache());
+
+    // Tracing bisa sudah aktif dari CRUDMAHASISWA_TRACE, tanpa membuang event-nya
+    {
+        const QSignalBlocker blocker(ui->actionRecord_trace);
+        ui->actionRecord_trace->setChecked(Tracer::isEnabled());
+    }
+
     if (!dbManager.get()->isDatabaseOpen()) {
-        qCritical() << Q_FUNC_INFO << "Database tidak terbuka. Tidak dapat memuat data.";
+        qCCritical(lcUi) << Q_FUNC_INFO << "Database tidak terbuka. Tidak dapat memuat data.";
 
         QMessageBox::warning(this, "Fail", "Fail to open database");
 
         setEnableControls(false);
     } else {
-        qDebug() << Q_FUNC_INFO << "Database sukses terbuka";
+        qCDebug(lcUi) << Q_FUNC_INFO << "Database sukses terbuka";
 
         setTableColumns();
 
-        QTimer::singleShot(1750, this, &MainWindow::loadStudentsData);
+        studentsLoadJob.reset(new StudentsLoadJob(dbManager->databasePath()));
+        connect(studentsLoadJob.get(), &StudentsLoadJob::rowsLoaded, tblModel.get(), &TableModel::appendTableData);
+        connect(studentsLoadJob.get(), &StudentsLoadJob::finished, this, [this](bool success, qint64 rowCount, qint64 elapsedMs) {
+            if (!success) {
+                qCWarning(lcUi) << "Gagal memuat sisa data mahasiswa di background";
+            }
+            qCDebug(lcUi) << rowCount << "baris sisa dimuat dalam" << elapsedMs << "ms";
+            // Hanya pemuatan pertama yang termasuk startup, reload berikutnya tidak
+            if (!StartupProfile::isFinished()) {
+                StartupProfile::finish("full load");
+            }
+            emit studentsDataLoaded(tblModel.get()->rowCount());
+        });
+
+        // Halaman pertama dimuat begitu event loop berjalan, tepat setelah jendela tampil
+        QTimer::singleShot(0, this, &MainWindow::loadStudentsData);
     }
 
 
@@ -33,9 +58,33 @@ MainWindow::MainWindow(QWidget *parent)
     ui->lineEdit_2->setValidator(npmValidator.get());
 
     //set search icon to search textbox (lineEdit_4)
-    QIcon icnSearch = QIcon(":/qss_icons/dark/rc/searchIcon_grey.png");
     ui->lineEdit_4->setClearButtonEnabled(true);
-    ui->lineEdit_4->addAction(icnSearch, QLineEdit::LeadingPosition);
+    ui->lineEdit_4->addAction(PixmapCache::instance().icon(":/qss_icons/dark/rc/searchIcon_grey.png"), QLineEdit::LeadingPosition);
+
+    perfHud = new PerfHudDock(this);
+    perfHud->setModel(tblModel.get());
+    addDockWidget(Qt::RightDockWidgetArea, perfHud);
+    perfHud->hide();
+
+    QAction *perfHudAction = perfHud->toggleViewAction();
+    perfHudAction->setText("HUD Performa");
+    perfHudAction->setShortcut(QKeySequence("Ctrl+Shift+H"));
+    ui->menuDebug->addAction(perfHudAction);
+
+    // Lama sort diukur dari sinyal layout proxy, karena sort dipicu langsung oleh header view
+    connect(proxModel.get(), &QSortFilterProxyModel::layoutAboutToBeChanged, this,
+            [this](const QList<QPersistentModelIndex> &, QAbstractItemModel::LayoutChangeHint hint) {
+        if (hint == QAbstractItemModel::VerticalSortHint) {
+            sortTimer.start();
+        }
+    });
+    connect(proxModel.get(), &QSortFilterProxyModel::layoutChanged, this,
+            [this](const QList<QPersistentModelIndex> &, QAbstractItemModel::LayoutChangeHint hint) {
+        if (hint == QAbstractItemModel::VerticalSortHint && sortTimer.isValid()) {
+            perfHud->recordSortLatency(sortTimer.nsecsElapsed() / 1e6);
+            sortTimer.invalidate();
+        }
+    });
 }
 
 MainWindow::~MainWindow()
@@ -43,40 +92,37 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
+void MainWindow::setStallWatchdog(StallWatchdog *watchdog)
+{
+    perfHud->setStallWatchdog(watchdog);
+}
+
 void MainWindow::setEnableControls(bool enable)
 {
     if (!ui->centralwidget) {
-        qWarning() << "Error: centralwidget is null.";
+        qCWarning(lcUi) << "Error: centralwidget is null.";
         return;
     }
 
-    qDebug() << Q_FUNC_INFO << (enable ? "Enabling" : "Disabling") << "QLineEdit and QPushButton widgets...";
-
     // --- 1. Iterasi melalui QLineEdit ---
 
     // QWidget::findChildren<T>() secara rekursif mencari semua turunan dari tipe T
     QList<QLineEdit *> lineEdits = ui->centralwidget->findChildren<QLineEdit *>();
 
-    int lineEditCount = 0;
     for (QLineEdit *lineEdit : lineEdits) {
         lineEdit->setEnabled(enable);
-        lineEditCount++;
     }
-    qDebug() << Q_FUNC_INFO << "Total QLineEdit affected:" << lineEditCount;
-
 
     // --- 2. Iterasi melalui QPushButton ---
 
     QList<QPushButton *> pushButtons = ui->centralwidget->findChildren<QPushButton *>();
 
-    int buttonCount = 0;
     for (QPushButton *button : pushButtons) {
         button->setEnabled(enable);
-        buttonCount++;
     }
-    qDebug() << Q_FUNC_INFO << "Total QPushButton affected:" << buttonCount;
 
-    qDebug() << Q_FUNC_INFO << "Widget toggling complete.";
+    qCDebug(lcUi) << Q_FUNC_INFO << (enable ? "Enabled" : "Disabled")
+                  << lineEdits.size() << "QLineEdit and" << pushButtons.size() << "QPushButton";
 }
 
 void MainWindow::setTableColumns()
@@ -91,12 +137,29 @@ void MainWindow::setTableColumns()
 
 void MainWindow::loadStudentsData()
 {
-    QString tableName =  "mahasiswa";
-    QStringList columnsToRetrieve = QStringList() << "id" << "nama" << "npm" << "kelas";
-    QList<StudentsDataStruct> queryResult = dbManager->selectRecords(tableName, columnsToRetrieve);
+    TRACE_SPAN("ui", "MainWindow::loadStudentsData");
+
+    // Satu layar penuh dulu lewat query halaman (primary key), sisanya dibaca di background
+    const int rowHeight = qMax(1, ui->tableView->verticalHeader()->defaultSectionSize());
+    const int firstPageSize = qMax(50, ui->tableView->viewport()->height() / rowHeight + 1);
+
+    QList<StudentsDataStruct> firstPage;
+    dbManager->selectRecordsPage("mahasiswa", 0, firstPageSize, firstPage);
+
+    tblModel.get()->setTableData(firstPage);
+    StartupProfile::mark("first rows");
 
-    tblModel.get()->setTableData(queryResult);
+    if (firstPage.size() < firstPageSize) {
+        // Semua data sudah masuk, pembacaan lama (kalau ada) tidak boleh menambah baris lagi
+        studentsLoadJob->cancel();
+        if (!StartupProfile::isFinished()) {
+            StartupProfile::finish("full load");
+        }
+        emit studentsDataLoaded(firstPage.size());
+        return;
+    }
 
+    studentsLoadJob->start(firstPage.last().id);
 }
 
 void MainWindow::clearData()
@@ -122,6 +185,8 @@ bool MainWindow::confirmationMsgBox(const QString &title, const QString &desc)
 
 void MainWindow::addANewStudent()
 {
+    TRACE_SPAN("ui", "MainWindow::addANewStudent");
+
     QString nama = ui->lineEdit->text();
     QString npm = ui->lineEdit_2->text();
     QString kelas = ui->lineEdit_3->text();
@@ -153,7 +218,7 @@ void MainWindow::addANewStudent()
 
     qint64 newId = dbManager.get()->insertRecord(tblNameToInsert, userData);
     if (newId > -1) {
-        qDebug() << "User baru berhasil ditambahkan dengan ID:" << newId;
+        qCDebug(lcUi) << "User baru berhasil ditambahkan dengan ID:" << newId;
         // QMessageBox::information(this, "Success", "New Student data has been added");
         appMessageBox(QMessageBox::Information, "Success", "New Student data has been added");
 
@@ -165,6 +230,8 @@ void MainWindow::addANewStudent()
 
 void MainWindow::updateSelectedStudent()
 {
+    TRACE_SPAN("ui", "MainWindow::updateSelectedStudent");
+
     if (selectedStudentID < 0){
         // QMessageBox::warning(this, "Attention", "You should choose one student record");
         appMessageBox(QMessageBox::Warning, "Attention", "You should choose one student record");
@@ -207,8 +274,8 @@ void MainWindow::updateSelectedStudent()
     updateBindValues[":npm"] = npm;
     updateBindValues[":kelas"] = kelas;
 
-    qDebug() << Q_FUNC_INFO << QString("id: %1 | nama : %2 | npm : %3 | kelas : %4")
-                                   .arg(QString::number(selectedStudentID)).arg(nama).arg(npm).arg(kelas);
+    qCDebug(lcUi) << Q_FUNC_INFO << QString("id: %1 | nama : %2 | npm : %3 | kelas : %4")
+                                        .arg(QString::number(selectedStudentID)).arg(nama).arg(npm).arg(kelas);
 
     if (dbManager.get()->updateRecord(tableName, updateData, updateCondition, updateBindValues)) {
         // QMessageBox::information(this, "Success", "Student data updated");
@@ -224,6 +291,8 @@ void MainWindow::updateSelectedStudent()
 
 void MainWindow::deleteSelectedStudent()
 {
+    TRACE_SPAN("ui", "MainWindow::deleteSelectedStudent");
+
     if (selectedStudentID < 0){
         // QMessageBox::warning(this, "Attention", "You should choose one student record");
         appMessageBox(QMessageBox::Warning, "Attention", "You should choose one student record");
@@ -249,6 +318,8 @@ void MainWindow::deleteSelectedStudent()
 
 void MainWindow::showReportPreview()
 {
+    TRACE_SPAN("ui", "MainWindow::showReportPreview");
+
     if (!dbManager.get()->isDatabaseOpen()) {
         // QMessageBox::critical(this, "Error", "Database tidak terbuka.");
         appMessageBox(QMessageBox::Critical, "Error", "Database tidak terbuka.");
@@ -282,54 +353,233 @@ void MainWindow::showReportPreview()
 
 void MainWindow::exportToPDF()
 {
-    // --- Configuration ---
-    // const QString OUTPUT_FILE = "LargeDataReport.pdf";
+    TRACE_SPAN("ui", "MainWindow::exportToPDF");
+
+    if (!pdfExportJob.isNull() && pdfExportJob->isRunning()) {
+        appMessageBox(QMessageBox::Information, "Info", "Ekspor PDF masih berjalan.");
+        return;
+    }
+
+    if (!dbManager.get()->isDatabaseOpen()) {
+        appMessageBox(QMessageBox::Critical, "Error", "Database tidak terbuka.");
+        return;
+    }
 
-    // const int DATASET_SIZE = 100; // 5005 rows ensures 11 chunks (500*10 + 5 remaining)
+    const QString filePath = QFileDialog::getSaveFileName(this, "Choose where you want to save this PDF file", QDir::homePath(), "PDF File (*.pdf)");
 
-    // const QString REPORT_TITLE = "Quarterly Sales Data Report";
-    // const QString REPORT_LABEL = "Generated by Qt Buffered Exporter";
-    // const QList<QString> HEADERS = {"Txn ID", "Customer Name", "Amount ($)", "Sale Date"};
-    // // -------------------
+    if (filePath.trimmed().isEmpty()){
+        return;
+    }
 
-    // const QString OUTPUT_FILE = QFileDialog::getSaveFileName(this, "Choose where you want to save this PDF file", QDir::homePath(), "PDF File (*.pdf)");
+    // Job dibuat ulang setiap ekspor. Baris dibaca worker thread dengan koneksi
+    // read-only sendiri dan langsung ditulis ke PDF, GUI thread tidak memuat data
+    pdfExportJob.reset(new PDFExportJob());
+    pdfExportJob->setDatabaseSource(dbManager.get()->databasePath(), "mahasiswa");
+    pdfExportJob->exporter().setTitle("Laporan Mahasiswa");
+    pdfExportJob->exporter().setTableHeaders(QStringList() << "id" << "nama" << "npm" << "kelas");
+
+    QProgressDialog *progress = new QProgressDialog("Membuat PDF...", "Batal", 0, 0, this);
+    progress->setWindowTitle("Ekspor PDF");
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+
+    connect(progress, &QProgressDialog::canceled, pdfExportJob.get(), &PDFExportJob::cancel);
+
+    connect(pdfExportJob.get(), &PDFExportJob::pageFinished, progress,
+            [progress](int page, qint64 rowsDone, qint64 rowCount) {
+                progress->setMaximum(int(rowCount));
+                progress->setLabelText(QString("Halaman %1 selesai (%2 dari %3 baris)")
+                                           .arg(page).arg(rowsDone).arg(rowCount));
+                progress->setValue(int(rowsDone));
+            });
+
+    QPointer<QProgressDialog> progressGuard(progress);
+    connect(pdfExportJob.get(), &PDFExportJob::finished, this,
+            [this, progressGuard](bool success, bool cancelled, const QString &filePath) {
+                if (progressGuard) {
+                    progressGuard->close();
+                }
+
+                if (success) {
+                    appMessageBox(QMessageBox::Information, "Success", "PDF berhasil disimpan ke " + filePath);
+                } else if (!cancelled) {
+                    appMessageBox(QMessageBox::Critical, "Failed", pdfExportJob->getLastError());
+                }
+            });
+
+    if (!pdfExportJob->start(filePath)) {
+        progress->close();
+        appMessageBox(QMessageBox::Critical, "Failed", pdfExportJob->getLastError());
+    }
+}
 
-    // if (OUTPUT_FILE.trimmed().isEmpty()){
-    //     appMessageBox(QMessageBox::Warning, "Empty", "You should enter file name for exported pdf file");
-    //     return;
-    // }
+void MainWindow::exportGroupedReport()
+{
+    TRACE_SPAN("ui", "MainWindow::exportGroupedReport");
 
-    // PDFExporter exporter(this, REPORT_TITLE, REPORT_LABEL, HEADERS, ROWS_PER_CHUNK);
+    if (!pdfExportJob.isNull() && pdfExportJob->isRunning()) {
+        appMessageBox(QMessageBox::Information, "Info", "Ekspor PDF masih berjalan.");
+        return;
+    }
 
-    // qDebug() << "Starting PDF export for" << DATASET_SIZE << "rows (Chunk Size:" << ROWS_PER_CHUNK << ").";
+    if (!dbManager.get()->isDatabaseOpen()) {
+        appMessageBox(QMessageBox::Critical, "Error", "Database tidak terbuka.");
+        return;
+    }
 
-    // QElapsedTimer totalTimer;
-    // totalTimer.start();
+    const QString filePath = QFileDialog::getSaveFileName(this, "Choose where you want to save this PDF file", QDir::homePath(), "PDF File (*.pdf)");
 
-    // if (exporter.openExport(OUTPUT_FILE)) {
-    //     // 1. Generate and write data rows
-    //     for (int i = 1; i <= DATASET_SIZE; ++i) {
-    //         QList<QVariant> dataRow;
-    //         dataRow << QString::number(10000 + i)
-    //                 << QString("Customer %1").arg(i)
-    //                 << (double)i * 1.23 + 50.0
-    //                 << QDateTime::currentDateTime().addDays(i / 10).toString("yyyy-MM-dd");
+    if (filePath.trimmed().isEmpty()){
+        return;
+    }
 
-    //         // This is the call that manages the buffer and triggers flushes
-    //         exporter.writeRow(dataRow);
-    //     }
+    // Pengelompokan, urutan dan jumlah per kelas dikerjakan SQLite di worker
+    // thread dengan koneksi read-only sendiri, baris langsung ditulis ke PDF
+    pdfExportJob.reset(new PDFExportJob());
+    pdfExportJob->setDatabaseSource(dbManager.get()->databasePath(), "mahasiswa");
+    pdfExportJob->setGroupedByKelas(true);
+    pdfExportJob->exporter().setTitle("Laporan Mahasiswa per Kelas");
+    pdfExportJob->exporter().setTableHeaders(QStringList() << "id" << "nama" << "npm" << "kelas");
+
+    QProgressDialog *progress = new QProgressDialog("Membuat laporan per kelas...", "Batal", 0, 0, this);
+    progress->setWindowTitle("Laporan per Kelas");
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+
+    connect(progress, &QProgressDialog::canceled, pdfExportJob.get(), &PDFExportJob::cancel);
+
+    // Jumlah baris baru diketahui worker, maksimum diisi dari sinyal halaman
+    connect(pdfExportJob.get(), &PDFExportJob::pageFinished, progress,
+            [progress](int page, qint64 rowsDone, qint64 rowCount) {
+                progress->setMaximum(int(rowCount));
+                progress->setLabelText(QString("Halaman %1 selesai (%2 dari %3 baris)")
+                                           .arg(page).arg(rowsDone).arg(rowCount));
+                progress->setValue(int(rowsDone));
+            });
+
+    QPointer<QProgressDialog> progressGuard(progress);
+    connect(pdfExportJob.get(), &PDFExportJob::finished, this,
+            [this, progressGuard](bool success, bool cancelled, const QString &filePath) {
+                if (progressGuard) {
+                    progressGuard->close();
+                }
+
+                if (success) {
+                    appMessageBox(QMessageBox::Information, "Success",
+                                  QString("Laporan %1 kelas (%2 mahasiswa) disimpan ke %3")
+                                      .arg(pdfExportJob->exportedGroupCount())
+                                      .arg(pdfExportJob->exportedRowCount())
+                                      .arg(filePath));
+                } else if (!cancelled) {
+                    appMessageBox(QMessageBox::Critical, "Failed",
+                                  "Gagal membuat laporan per kelas: " + pdfExportJob->getLastError());
+                }
+            });
+
+    if (!pdfExportJob->start(filePath)) {
+        progress->close();
+        appMessageBox(QMessageBox::Critical, "Failed", pdfExportJob->getLastError());
+    }
+}
 
-    //     // 2. Finalize export (flushes the remaining rows)
-    //     exporter.closeExport();
-    // } else {
-    //     qCritical() << "Export initialization failed!";
-    // }
+void MainWindow::exportReportsPerClass()
+{
+    TRACE_SPAN("ui", "MainWindow::exportReportsPerClass");
+
+    if (!reportBatchJob.isNull() && reportBatchJob->isRunning()) {
+        appMessageBox(QMessageBox::Information, "Info", "Laporan per kelas masih dibuat.");
+        return;
+    }
 
-    // qDebug() << "Total operation time:" << totalTimer.elapsed() << "ms.";
+    if (!dbManager.get()->isDatabaseOpen()) {
+        appMessageBox(QMessageBox::Critical, "Error", "Database tidak terbuka.");
+        return;
+    }
+
+    QList<StudentsGroupStruct> groups;
+    if (!dbManager.get()->selectGroupSummary("mahasiswa", groups)) {
+        appMessageBox(QMessageBox::Critical, "Error", "Gagal membaca daftar kelas.");
+        return;
+    }
+
+    if (groups.isEmpty()) {
+        appMessageBox(QMessageBox::Information, "Info", "Tidak ada data yang tersedia");
+        return;
+    }
+
+    const QString directory = QFileDialog::getExistingDirectory(this, "Choose where you want to save the PDF files", QDir::homePath());
+
+    if (directory.trimmed().isEmpty()){
+        return;
+    }
+
+    // Setiap worker membuka koneksi sendiri ke file database yang sama
+    reportBatchJob.reset(new ReportBatchJob());
+    reportBatchJob->setDatabasePath(dbManager.get()->databasePath());
+    reportBatchJob->setTableName("mahasiswa");
+
+    QProgressDialog *progress = new QProgressDialog("Membuat laporan per kelas...", "Batal", 0, int(groups.size()), this);
+    progress->setWindowTitle("Laporan per Kelas");
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+
+    connect(progress, &QProgressDialog::canceled, reportBatchJob.get(), &ReportBatchJob::cancel);
+
+    connect(reportBatchJob.get(), &ReportBatchJob::fileFinished, progress,
+            [progress](const ReportBatchFile &file, int done, int total) {
+                progress->setLabelText(QString("%1 selesai (%2 dari %3 file)")
+                                           .arg(QFileInfo(file.filePath).fileName()).arg(done).arg(total));
+                progress->setValue(done);
+            });
+
+    QPointer<QProgressDialog> progressGuard(progress);
+    connect(reportBatchJob.get(), &ReportBatchJob::finished, this,
+            [this, progressGuard](bool success, bool cancelled) {
+                if (progressGuard) {
+                    progressGuard->close();
+                }
+
+                if (cancelled) {
+                    return;
+                }
+
+                const QList<ReportBatchFile> files = reportBatchJob->results();
+                qint64 rows = 0;
+                int pages = 0;
+                int failed = 0;
+                for (const ReportBatchFile &file : files) {
+                    rows += file.rows;
+                    pages += file.pages;
+                    if (!file.success) {
+                        ++failed;
+                    }
+                }
+
+                const QString summary = QString("%1 file (%2 mahasiswa, %3 halaman) dalam %4 ms.\nRingkasan: %5")
+                                            .arg(files.size() - failed).arg(rows).arg(pages)
+                                            .arg(reportBatchJob->elapsedMs()).arg(reportBatchJob->summaryFilePath());
+
+                if (success) {
+                    appMessageBox(QMessageBox::Information, "Success", summary);
+                } else {
+                    appMessageBox(QMessageBox::Critical, "Failed",
+                                  QString("%1 file gagal: %2\n%3").arg(failed).arg(reportBatchJob->getLastError()).arg(summary));
+                }
+            });
+
+    if (!reportBatchJob->start(groups, directory)) {
+        progress->close();
+        appMessageBox(QMessageBox::Critical, "Failed", reportBatchJob->getLastError());
+    }
 }
 
 void MainWindow::previewDatabaseReport(const QString &reportTitle, const QStringList &headers, const QList<StudentsDataStruct> &data)
 {
+    TRACE_SPAN("ui", "MainWindow::previewDatabaseReport");
+
     // // 1. Buat Konten HTML
     // QTextDocument doc;
     // QString htmlContent;
@@ -404,17 +654,13 @@ void MainWindow::previewDatabaseReport(const QString &reportTitle, const QString
     exporter.setTitle(reportTitle);
     exporter.setTableHeaders(headers);
 
-    // Convert StudentsDataStruct to QList<QStringList>
-    QList<QStringList> tableData;
-    for (const StudentsDataStruct &student : data) {
-        QStringList row;
-        row << QString::number(student.id)
-            << student.nama
-            << student.npm
-            << student.kelas;
-        tableData.append(row);
-    }
-    exporter.setTableData(tableData);
+    // Baris ditulis langsung dari StudentsDataStruct lewat row adapter
+    exporter.setTableRows(data, StudentsRowAdapter());
+
+    // Laporan yang datanya tidak berubah diambil dari cache. Tanggal tanpa jam:
+    // tanggal ikut di key cache, jadi cache berlaku selama hari yang sama
+    exporter.setDateFormat("dd MMMM yyyy");
+    exporter.setReportCache(reportCache.get());
 
     // Preview only
     exporter.preview(this);
@@ -428,18 +674,12 @@ int MainWindow::appMessageBox(const QMessageBox::Icon &msgBoxType, const QString
     msgBox.setStandardButtons(QMessageBox::Ok);
     msgBox.setDefaultButton(QMessageBox::Ok);
 
-    if (msgBoxType == QMessageBox::Information){
-        msgBox.setIconPixmap(QIcon(":/sysicon/images/information-freepik-white.png").pixmap(64,64));
-    } else if (msgBoxType == QMessageBox::Warning){
-        msgBox.setIconPixmap(QIcon(":/sysicon/images/critical-freepik-white.png").pixmap(64,64));
-    } else if (msgBoxType == QMessageBox::Critical){
-        msgBox.setIconPixmap(QIcon(":/sysicon/images/question-mark-freepik_white.png").pixmap(64,64));
-    } else if (msgBoxType == QMessageBox::Question){
-        msgBox.setIconPixmap(QIcon(":/sysicon/images/question-mark-freepik_white.png").pixmap(64,64));
+    // Ikon di-decode sekali per ukuran/DPR, selanjutnya diambil dari cache
+    msgBox.setIconPixmap(PixmapCache::instance().messageBoxIcon(msgBoxType));
+
+    if (msgBoxType == QMessageBox::Question){
         msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
         msgBox.setDefaultButton(QMessageBox::No);
-    } else {
-        msgBox.setIconPixmap(QIcon(":/sysicon/images/critical-freepik-white.png").pixmap(64,64));
     }
 
     msgBox.exec();
@@ -448,6 +688,8 @@ int MainWindow::appMessageBox(const QMessageBox::Icon &msgBoxType, const QString
 
 void MainWindow::exportDataToCSV()
 {
+    TRACE_SPAN("ui", "MainWindow::exportDataToCSV");
+
     QString completeFilePath = QFileDialog::getSaveFileName(this, "Choose where you want to save this csv file", QDir::homePath(), "CSV File (*.csv)");
 
     if (completeFilePath.trimmed().isEmpty()){
@@ -459,7 +701,7 @@ void MainWindow::exportDataToCSV()
     reportColumns << "id" << "nama" << "npm" << "kelas";
 
     // Ambil Data dari Database
-    QVector<QStringList> reportData = dbManager.get()->selectRecordsToVector(
+    QList<StudentsDataStruct> reportData = dbManager.get()->selectRecords(
         "mahasiswa",
         reportColumns,
         "", // Semua record
@@ -476,20 +718,52 @@ void MainWindow::exportDataToCSV()
     exporter.setDelimiter(";");
     exporter.setFilePath(completeFilePath);
 
-    QElapsedTimer timer;
-    timer.start();
-
-    if (exporter.exportDataWithHeaders(reportColumns, reportData))
+    // Tulis StudentsDataStruct langsung ke buffer CSV, tanpa QStringList per baris
+    if (exporter.exportRows(reportData, StudentsRowAdapter(), reportColumns))
     {
-        qint64 elapsed = timer.elapsed();
-        qDebug() << Q_FUNC_INFO << "Small dataset exported in" << elapsed << "ms";
-
         appMessageBox(QMessageBox::Information, "Success","CSV data exported");
     } else {
         appMessageBox(QMessageBox::Critical, "Failed",  "The System are fail to export the CSV file");
     }
 }
 
+void MainWindow::importDataFromCSV()
+{
+    TRACE_SPAN("ui", "MainWindow::importDataFromCSV");
+
+    QString completeFilePath = QFileDialog::getOpenFileName(this, "Choose the csv file you want to import", QDir::homePath(), "CSV File (*.csv)");
+
+    if (completeFilePath.trimmed().isEmpty()){
+        appMessageBox(QMessageBox::Warning, "Empty", "You should choose a csv file to import");
+        return;
+    }
+
+    // nama bersifat UNIQUE, tanyakan apa yang harus dilakukan jika nama sudah ada
+    int updateExisting = appMessageBox(QMessageBox::Question, "Confirmation", "Update students that already exist (same name) ?\nChoose No to skip them");
+
+    CSVImporter importer;
+    importer.setDelimiter(";"); // sama dengan delimiter di exportDataToCSV
+    importer.setFilePath(completeFilePath);
+    importer.setConflictPolicy(updateExisting == QMessageBox::Yes ? DatabaseManager::UpdateOnConflict
+                                                                  : DatabaseManager::SkipOnConflict);
+
+    if (importer.importData(dbManager.get(), "mahasiswa")) {
+        CSVImporter::ImportStats stats = importer.getLastStats();
+        qCDebug(lcUi) << Q_FUNC_INFO << stats.rowsRead << "rows imported in" << stats.elapsedMs << "ms";
+
+        QString summary = QString("%1 rows saved, %2 skipped, %3 rejected")
+                              .arg(stats.rowsInserted).arg(stats.rowsSkipped).arg(stats.rowsRejected);
+        if (stats.rowsRejected > 0) {
+            summary += "\n\n" + importer.getRejectedRows().mid(0, 10).join("\n");
+        }
+        appMessageBox(QMessageBox::Information, "Success", summary);
+
+        loadStudentsData();
+    } else {
+        appMessageBox(QMessageBox::Critical, "Failed", importer.getLastError());
+    }
+}
+
 void MainWindow::on_pushButton_clicked()
 {
     addANewStudent();
@@ -506,7 +780,7 @@ void MainWindow::on_tableView_clicked(const QModelIndex &index)
     ui->lineEdit_2->setText(data.npm);
     ui->lineEdit_3->setText(data.kelas);
 
-    qDebug() << Q_FUNC_INFO << "selectedStudentID : " << selectedStudentID;
+    qCDebug(lcUi) << Q_FUNC_INFO << "selectedStudentID : " << selectedStudentID;
     ui->tableView->clearSelection();
 }
 
@@ -544,14 +818,20 @@ void MainWindow::on_pushButton_3_clicked()
 
 void MainWindow::on_lineEdit_4_textChanged(const QString &arg1)
 {
+    TRACE_SPAN("ui", "MainWindow::filterStudents");
+
+    QElapsedTimer timer;
+    timer.start();
+
     proxModel.get()->setFilterRegularExpression(arg1);
+
+    perfHud->recordFilterLatency(timer.nsecsElapsed() / 1e6, proxModel.get()->rowCount());
 }
 
 
 void MainWindow::on_pushButton_4_clicked()
 {
     showReportPreview();
-    // exportToPDF();
 }
 
 
@@ -567,3 +847,66 @@ void MainWindow::on_pushButton_6_clicked()
     exportDataToCSV();
 }
 
+
+void MainWindow::on_pushButton_7_clicked()
+{
+    importDataFromCSV();
+}
+
+
+void MainWindow::on_pushButton_8_clicked()
+{
+    exportToPDF();
+}
+
+
+void MainWindow::on_pushButton_9_clicked()
+{
+    exportGroupedReport();
+}
+
+
+void MainWindow::on_pushButton_10_clicked()
+{
+    exportReportsPerClass();
+}
+
+
+void MainWindow::on_actionRecord_trace_toggled(bool checked)
+{
+    // Mulai rekaman baru setiap kali diaktifkan
+    if (checked) {
+        Tracer::clear();
+    }
+    Tracer::setEnabled(checked);
+}
+
+
+void MainWindow::on_actionSave_trace_triggered()
+{
+    const QString filePath = QFileDialog::getSaveFileName(this, "Choose where you want to save the trace", QDir::homePath() + "/crudMahasiswa-trace.json", "Chrome Trace (*.json)");
+
+    if (filePath.trimmed().isEmpty()){
+        return;
+    }
+
+    QString error;
+    if (Tracer::writeChromeTrace(filePath, &error)) {
+        appMessageBox(QMessageBox::Information, "Success", "Trace disimpan ke " + filePath + "\nBuka di ui.perfetto.dev atau chrome://tracing");
+    } else {
+        appMessageBox(QMessageBox::Critical, "Failed", "Gagal menyimpan trace: " + error);
+    }
+}
+
+
+void MainWindow::on_actionQuery_stats_triggered()
+{
+    if (!queryStatsDialog) {
+        queryStatsDialog = new QueryStatsDialog(this);
+        queryStatsDialog->setAttribute(Qt::WA_DeleteOnClose);
+    }
+
+    queryStatsDialog->show();
+    queryStatsDialog->raise();
+    queryStatsDialog->activateWindow();
+}
@@ -7,9 +7,18 @@
 #include <QDir>
 #include "helpers/Environments.h"
 #include "helpers/databasemanager.h"
+#include "helpers/logging.h"
+#include "helpers/pixmapcache.h"
+#include "helpers/querystats.h"
+#include "helpers/stallwatchdog.h"
+#include "helpers/startupprofile.h"
+#include "helpers/tracer.h"
+#include "models/studentsloadjob.h"
 #include "models/tablemodel.h"
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QSortFilterProxyModel>
+#include <QHeaderView>
 #include <QTextDocument>
 #include <QPrinter>
 #include <QPrintPreviewDialog>
@@ -18,8 +27,17 @@
 #include <QValidator>
 #include <QFileDialog>
 #include "dialogs/AboutDialog/aboutdialog.h"
+#include "dialogs/PerfHudDock/perfhuddock.h"
+#include "dialogs/QueryStatsDialog/querystatsdialog.h"
 #include "modules/CSVExporter/csvexporter.h"
+#include "modules/CSVImporter/csvimporter.h"
 #include "modules/PDFExporter/pdfexporter.h"
+#include "modules/PDFExporter/pdfexportjob.h"
+#include "modules/PDFExporter/reportbatchjob.h"
+#include <QProgressDialog>
+#include <QPointer>
+#include <QSignalBlocker>
+#include <QFileInfo>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -35,6 +53,9 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Sumber latensi event loop untuk HUD performa, boleh nullptr
+    void setStallWatchdog(StallWatchdog *watchdog);
+
 private slots:
     void setEnableControls(bool enable = false);
     void setTableColumns();
@@ -50,6 +71,8 @@ private slots:
 
     void showReportPreview();
     void exportToPDF();
+    void exportGroupedReport();
+    void exportReportsPerClass();
 
     void previewDatabaseReport(const QString &reportTitle,
                                const QStringList &headers,
@@ -59,6 +82,7 @@ private slots:
     int appMessageBox(const QMessageBox::Icon &msgBoxType, const QString &msgBoxTitle, const QString &msgBoxDesc);
 
     void exportDataToCSV();
+    void importDataFromCSV();
 
     void on_pushButton_clicked();
 
@@ -78,18 +102,54 @@ private slots:
 
     void on_pushButton_6_clicked();
 
+    void on_pushButton_7_clicked();
+
+    void on_pushButton_8_clicked();
+
+    void on_pushButton_9_clicked();
+
+    void on_pushButton_10_clicked();
+
+    void on_actionRecord_trace_toggled(bool checked);
+
+    void on_actionSave_trace_triggered();
+
+    void on_actionQuery_stats_triggered();
+
 private:
     Ui::MainWindow *ui;
     QScopedPointer<DatabaseManager> dbManager;
     QScopedPointer<TableModel> tblModel;
     QScopedPointer<QSortFilterProxyModel> proxModel;
 
+    // Sisa data di luar halaman pertama, dibaca di background
+    QScopedPointer<StudentsLoadJob> studentsLoadJob;
+
     int selectedStudentID = -1;
     QScopedPointer<QValidator> npmValidator;
 
+    // Cache laporan (PDF dan halaman preview) di ~/.crudMahasiswa/reportcache
+    QScopedPointer<ReportCache> reportCache;
+
+    // Ekspor PDF di background, hidup sampai ekspor berikutnya
+    QScopedPointer<PDFExportJob> pdfExportJob;
+
+    // Satu PDF per kelas, dikerjakan paralel dengan koneksi DB per thread
+    QScopedPointer<ReportBatchJob> reportBatchJob;
+
+    // Jendela statistik query (non-modal), dibuat saat pertama dibuka
+    QPointer<QueryStatsDialog> queryStatsDialog;
+
+    // HUD performa (menu Debug), tersembunyi sampai diaktifkan
+    PerfHudDock *perfHud = nullptr;
+    QElapsedTimer sortTimer;
+
 
 signals:
     void dialogWinId(WId i);
 
+    // Semua baris mahasiswa sudah ada di model (setelah halaman terakhir dimuat)
+    void studentsDataLoaded(qint64 rowCount);
+
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,123 @@
+#include "studentsloadjob.h"
+#include "helpers/databasemanager.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+StudentsLoadJob::StudentsLoadJob(const QString &databasePath, QObject *parent)
+    : QObject{parent}
+    , m_databasePath(databasePath)
+    , m_generation(0)
+{
+    m_pool.setMaxThreadCount(1);
+    connect(&m_watcher, &QFutureWatcher<LoadResult>::finished, this, &StudentsLoadJob::onWorkerFinished);
+}
+
+StudentsLoadJob::~StudentsLoadJob()
+{
+    // Pembacaan lama yang sudah dibatalkan juga masih memakai this
+    cancel();
+    m_pool.waitForDone();
+}
+
+void StudentsLoadJob::start(qint64 afterId, int pageSize)
+{
+    // Tidak menunggu pembacaan sebelumnya: generation baru membuatnya berhenti
+    // dan membuang semua yang masih dikirimnya
+    const quint64 generation = ++m_generation;
+
+    m_future = QtConcurrent::run(&m_pool, [this, generation, afterId, pageSize]() {
+        return run(generation, afterId, pageSize);
+    });
+    m_watcher.setFuture(m_future);
+}
+
+void StudentsLoadJob::cancel()
+{
+    ++m_generation;
+}
+
+bool StudentsLoadJob::isRunning() const
+{
+    return m_future.isRunning();
+}
+
+StudentsLoadJob::LoadResult StudentsLoadJob::run(quint64 generation, qint64 afterId, int pageSize)
+{
+    TRACE_SPAN("model", "StudentsLoadJob::run");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    LoadResult result;
+    result.generation = generation;
+
+    const auto cancelled = [this, generation]() {
+        return generation != m_generation.load();
+    };
+
+    // Dibatalkan sebelum sempat mulai, koneksi tidak perlu dibuka
+    if (cancelled()) {
+        return result;
+    }
+
+    // Koneksi QSqlDatabase hanya boleh dipakai di thread yang membukanya
+    DatabaseManager db(m_databasePath,
+                       QString("studentsload_%1_%2").arg(quintptr(this), 0, 16).arg(generation),
+                       true);
+    if (!db.isDatabaseOpen()) {
+        result.elapsedMs = timer.elapsed();
+        return result;
+    }
+
+    QList<StudentsDataStruct> rows;
+    bool success = true;
+    while (!cancelled()) {
+        if (!db.selectRecordsPage("mahasiswa", afterId, pageSize, rows)) {
+            success = false;
+            break;
+        }
+        if (rows.isEmpty()) {
+            break;
+        }
+
+        afterId = rows.last().id;
+        result.rowCount += rows.size();
+        const bool lastPage = rows.size() < pageSize;
+
+        // Dikirim ke thread pemilik; halaman dari pembacaan yang sudah diganti dibuang di sana
+        QMetaObject::invokeMethod(this, [this, generation, rows]() {
+            if (generation == m_generation.load()) {
+                emit rowsLoaded(rows);
+            }
+        }, Qt::QueuedConnection);
+
+        if (lastPage) {
+            break;
+        }
+    }
+
+    result.success = success && !cancelled();
+    result.elapsedMs = timer.elapsed();
+
+    qCDebug(lcModel) << "StudentsLoadJob:" << result.rowCount << "baris dibaca di background dalam"
+                     << result.elapsedMs << "ms" << (result.success ? "" : "(dibatalkan/gagal)");
+
+    return result;
+}
+
+void StudentsLoadJob::onWorkerFinished()
+{
+    // Watcher dari pembacaan lama juga bisa selesai setelah start() baru,
+    // hanya hasil pembacaan terakhir yang belum dibatalkan yang dilaporkan
+    if (isRunning()) {
+        return;
+    }
+
+    const LoadResult result = m_future.result();
+    if (result.generation != m_generation.load()) {
+        return;
+    }
+    emit finished(result.success, result.rowCount, result.elapsedMs);
+}
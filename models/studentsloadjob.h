@@ -0,0 +1,60 @@
+#ifndef STUDENTSLOADJOB_H
+#define STUDENTSLOADJOB_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <atomic>
+#include "helpers/Environments.h"
+
+// Membaca sisa tabel mahasiswa di worker thread, halaman demi halaman
+// (DatabaseManager::selectRecordsPage) lewat koneksi read-only sendiri.
+// Setiap halaman dikirim ke thread pemilik job lewat rowsLoaded() agar
+// bisa langsung ditambahkan ke model sementara halaman berikutnya dibaca.
+// start() lagi membatalkan pembacaan sebelumnya tanpa menunggunya; setiap
+// pembacaan punya generation sendiri, halaman dan hasil dari generation lama
+// dibuang, jadi model tidak pernah tercampur dua pembacaan.
+class StudentsLoadJob : public QObject
+{
+    Q_OBJECT
+public:
+    explicit StudentsLoadJob(const QString &databasePath, QObject *parent = nullptr);
+    ~StudentsLoadJob(); // membatalkan dan menunggu semua pembacaan yang masih berjalan
+
+    // Mulai membaca baris dengan id > afterId
+    void start(qint64 afterId, int pageSize = 5000);
+
+    // Halaman yang sudah dibaca tapi belum dikirim ikut dibuang
+    void cancel();
+    bool isRunning() const;
+
+signals:
+    void rowsLoaded(const QList<StudentsDataStruct> &rows);
+    void finished(bool success, qint64 rowCount, qint64 elapsedMs);
+
+private:
+    // Hasil satu pembacaan, dikembalikan lewat future masing-masing
+    struct LoadResult
+    {
+        quint64 generation = 0;
+        bool success = false;
+        qint64 rowCount = 0;
+        qint64 elapsedMs = 0;
+    };
+
+    LoadResult run(quint64 generation, qint64 afterId, int pageSize);
+    void onWorkerFinished();
+
+    QString m_databasePath;
+    // Satu thread: pembacaan baru antre di belakang yang lama, yang berhenti
+    // di batas halaman berikutnya setelah dibatalkan
+    QThreadPool m_pool;
+    QFuture<LoadResult> m_future;
+    QFutureWatcher<LoadResult> m_watcher;
+    std::atomic<quint64> m_generation; // naik setiap start()/cancel()
+};
+
+#endif // STUDENTSLOADJOB_H
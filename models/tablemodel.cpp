@@ -1,4 +1,23 @@
 #include "tablemodel.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+
+namespace {
+// Header QArrayData + isi UTF-16 dengan terminator; string null tidak punya buffer
+qint64 stringBytes(const QString &text)
+{
+    return text.isNull() ? 0 : qint64(sizeof(QArrayData)) + (text.size() + 1) * qint64(sizeof(QChar));
+}
+
+qint64 estimateBytes(const QList<StudentsDataStruct> &rows)
+{
+    qint64 bytes = qint64(rows.size()) * qint64(sizeof(StudentsDataStruct));
+    for (const StudentsDataStruct &row : rows) {
+        bytes += stringBytes(row.nama) + stringBytes(row.npm) + stringBytes(row.kelas);
+    }
+    return bytes;
+}
+}
 
 TableModel::TableModel(QObject *parent)
     : QAbstractTableModel(parent)
@@ -12,13 +31,35 @@ void TableModel::setColumns(QStringList cols)
 
 void TableModel::setTableData(const QList<StudentsDataStruct> &data)
 {
+    TRACE_SPAN("model", "TableModel::setTableData");
+
     // Notifikasi ke View bahwa data akan berubah
     beginResetModel();
 
     m_tableData = data;
 
+    m_estimatedBytes = estimateBytes(m_tableData);
+
     // Notifikasi ke View bahwa perubahan data sudah selesai
     endResetModel();
+
+    qCDebug(lcModel) << "TableModel:" << m_tableData.size() << "baris dimuat";
+}
+
+void TableModel::appendTableData(const QList<StudentsDataStruct> &data)
+{
+    TRACE_SPAN("model", "TableModel::appendTableData");
+
+    if (data.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_tableData.size(), m_tableData.size() + data.size() - 1);
+    m_tableData.append(data);
+    m_estimatedBytes += estimateBytes(data);
+    endInsertRows();
+
+    qCDebug(lcModel) << "TableModel:" << data.size() << "baris ditambahkan, total" << m_tableData.size();
 }
 
 int TableModel::rowCount(const QModelIndex &parent) const
@@ -90,3 +131,8 @@ StudentsDataStruct TableModel::getCurrentData(int index)
     StudentsDataStruct d = m_tableData.at(index);
     return d;
 }
+
+qint64 TableModel::estimatedMemoryBytes() const
+{
+    return m_estimatedBytes;
+}
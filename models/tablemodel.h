@@ -18,6 +18,9 @@ public:
     // Fungsi untuk mengisi data model dari luar (e.g., dari DatabaseManager)
     void setTableData(const QList<StudentsDataStruct> &data);
 
+    // Tambahkan baris di akhir tanpa reset, dipakai saat data dimuat bertahap
+    void appendTableData(const QList<StudentsDataStruct> &data);
+
     // Implementasi QAbstractTableModel wajib
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -26,9 +29,13 @@ public:
 
     StudentsDataStruct getCurrentData(int index);
 
+    // Perkiraan memori data baris (struct + isi QString), dihitung saat setTableData
+    qint64 estimatedMemoryBytes() const;
+
 private:
     QList<StudentsDataStruct> m_tableData; // Data baris (list of QVariantMap)
     QStringList m_headers;          // Nama kolom (headers)
+    qint64 m_estimatedBytes = 0;
 };
 
 #endif // TABLEMODEL_H
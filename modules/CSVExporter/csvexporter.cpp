@@ -1,10 +1,25 @@
 #include "csvexporter.h"
+#include "helpers/perfcounters.h"
+#include <charconv>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
 
 CSVExporter::CSVExporter(QObject *parent)
     : QObject{parent}
     , m_delimiter(",")
     , m_bufferSize(0) // 0 means auto-size
     , m_autoBufferSize(true)
+    , m_lastRowCount(0)
+    , m_maxRowsPerPart(0)
+    , m_maxBytesPerPart(0)
+    , m_threadCount(0)
+    , m_rowFlushSize(0)
+    , m_rowTotal(0)
 {}
 
 /*************** public methods ***********************/
@@ -32,8 +47,25 @@ void CSVExporter::setAutoBufferSize(bool enable)
         m_bufferSize = 0;
 }
 
+void CSVExporter::setMaxRowsPerPart(qint64 rows)
+{
+    m_maxRowsPerPart = qMax<qint64>(0, rows);
+}
+
+void CSVExporter::setMaxBytesPerPart(qint64 bytes)
+{
+    m_maxBytesPerPart = qMax<qint64>(0, bytes);
+}
+
+void CSVExporter::setThreadCount(int count)
+{
+    m_threadCount = qMax(0, count);
+}
+
 bool CSVExporter::exportData(const QVector<QStringList> &data)
 {
+    TRACE_SPAN("csv", "CSVExporter::exportData");
+
     if (m_filePath.isEmpty())
     {
         m_lastError = "File path is not set";
@@ -101,11 +133,281 @@ bool CSVExporter::exportDataWithHeaders(const QStringList &headers, const QVecto
     return exportData(fullData);
 }
 
+bool CSVExporter::exportChanges(DatabaseManager *dbManager, const QString &exportName, const QString &tableName)
+{
+    TRACE_SPAN("csv", "CSVExporter::exportChanges");
+
+    m_lastRowCount = 0;
+
+    if (!dbManager || !dbManager->isDatabaseOpen())
+    {
+        m_lastError = "Database is not open";
+        return false;
+    }
+
+    // A failed read is not "never exported", that would silently redo a full snapshot
+    qint64 sinceSeq = -1;
+    if (!dbManager->exportWatermark(exportName, sinceSeq))
+    {
+        m_lastError = "Cannot read the export watermark";
+        return false;
+    }
+
+    // Registered before the first snapshot, the triggers only log while an export exists
+    if (sinceSeq < 0 && !dbManager->setExportWatermark(exportName, -1, tableName))
+    {
+        m_lastError = "Cannot register the export";
+        return false;
+    }
+
+    QList<StudentChangeStruct> changes;
+    qint64 upToSeq = 0;
+    if (!dbManager->selectChangesSince(tableName, sinceSeq, changes, upToSeq))
+    {
+        m_lastError = "Cannot read the change log";
+        return false;
+    }
+
+    const QStringList headers = QStringList() << "change" << "id" << "nama" << "npm" << "kelas";
+    if (!exportRows(changes, StudentChangesRowAdapter(), headers))
+        return false;
+
+    // Only move the watermark once the file is complete, a failed run is simply repeated
+    if (upToSeq != sinceSeq && !dbManager->setExportWatermark(exportName, upToSeq, tableName))
+    {
+        m_lastError = "File written, but the export watermark could not be saved";
+        return false;
+    }
+
+    m_lastRowCount = changes.size();
+    return true;
+}
+
+QStringList CSVExporter::getLastPartFiles() const
+{
+    return m_lastPartFiles;
+}
+
+QString CSVExporter::getLastManifestPath() const
+{
+    return m_lastManifestPath;
+}
+
+qint64 CSVExporter::getLastRowCount() const
+{
+    return m_lastRowCount;
+}
+
 QString CSVExporter::getLastError() const
 {
     return m_lastError;
 }
 
+/*************** CSVRowWriter *************************/
+
+CSVRowWriter::CSVRowWriter(QByteArray &buffer, const QString &delimiter)
+    : m_buffer(buffer)
+    , m_delimiter(delimiter)
+    , m_delimiterUtf8(delimiter.toUtf8())
+    , m_firstField(true)
+{}
+
+void CSVRowWriter::writeField(const QString &field)
+{
+    if (!m_firstField)
+        m_buffer.append(m_delimiterUtf8);
+    m_firstField = false;
+
+    // Same rule as CSVExporter::escapeField
+    const bool needsQuotes = field.contains(m_delimiter) ||
+                             field.contains('"') ||
+                             field.contains('\n') ||
+                             field.contains('\r');
+
+    if (!needsQuotes)
+    {
+        appendEncoded(field, false);
+        return;
+    }
+
+    m_buffer.append('"');
+    appendEncoded(field, true);
+    m_buffer.append('"');
+}
+
+void CSVRowWriter::writeField(qint64 value)
+{
+    if (!m_firstField)
+        m_buffer.append(m_delimiterUtf8);
+    m_firstField = false;
+
+    char digits[24];
+    const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    m_buffer.append(digits, int(result.ptr - digits));
+}
+
+void CSVRowWriter::endRow()
+{
+    m_buffer.append('\n');
+    m_firstField = true;
+}
+
+void CSVRowWriter::appendEncoded(QStringView text, bool doubleQuotes)
+{
+    const char16_t *p = text.utf16();
+    const char16_t *end = p + text.size();
+
+    while (p < end)
+    {
+        char32_t ch = *p++;
+
+        // ASCII fast path
+        if (ch < 0x80)
+        {
+            m_buffer.append(char(ch));
+            if (doubleQuotes && ch == '"')
+                m_buffer.append('"');
+            continue;
+        }
+
+        if (QChar::isHighSurrogate(ch) && p < end && QChar::isLowSurrogate(*p))
+            ch = QChar::surrogateToUcs4(char16_t(ch), *p++);
+        else if (QChar::isSurrogate(ch))
+            ch = 0xFFFD; // lone surrogate
+
+        if (ch < 0x800)
+        {
+            m_buffer.append(char(0xC0 | (ch >> 6)));
+            m_buffer.append(char(0x80 | (ch & 0x3F)));
+        }
+        else if (ch < 0x10000)
+        {
+            m_buffer.append(char(0xE0 | (ch >> 12)));
+            m_buffer.append(char(0x80 | ((ch >> 6) & 0x3F)));
+            m_buffer.append(char(0x80 | (ch & 0x3F)));
+        }
+        else
+        {
+            m_buffer.append(char(0xF0 | (ch >> 18)));
+            m_buffer.append(char(0x80 | ((ch >> 12) & 0x3F)));
+            m_buffer.append(char(0x80 | ((ch >> 6) & 0x3F)));
+            m_buffer.append(char(0x80 | (ch & 0x3F)));
+        }
+    }
+}
+
+/*************** end of CSVRowWriter ******************/
+
+
+/*************** CSVPartWriter ************************/
+
+CSVPartWriter::CSVPartWriter(const QString &tempPrefix, const QByteArray &header,
+                             qint64 maxRows, qint64 maxBytes, int flushSize)
+    : m_tempPrefix(tempPrefix)
+    , m_header(header)
+    , m_maxRows(maxRows)
+    , m_maxBytes(maxBytes)
+    , m_flushSize(flushSize)
+    , m_hash(QCryptographicHash::Sha256)
+    , m_fileRows(0)
+    , m_fileBytes(0)
+{
+    m_buffer.reserve(m_flushSize + 1024);
+}
+
+bool CSVPartWriter::appendRow(const QByteArray &row)
+{
+    // Rotate when this row would break a limit (a part always holds at least one row)
+    if (m_file.isOpen() && m_fileRows > 0 &&
+        ((m_maxRows > 0 && m_fileRows >= m_maxRows) ||
+         (m_maxBytes > 0 && m_fileBytes + row.size() > m_maxBytes)))
+    {
+        if (!closeCurrent())
+            return false;
+    }
+
+    if (!m_file.isOpen() && !openNext())
+        return false;
+
+    m_buffer.append(row);
+    m_fileBytes += row.size();
+    ++m_fileRows;
+
+    if (m_buffer.size() >= m_flushSize)
+        return flush();
+
+    return true;
+}
+
+bool CSVPartWriter::finish()
+{
+    if (m_file.isOpen())
+        return closeCurrent();
+    return true;
+}
+
+QList<CSVPartInfo> CSVPartWriter::parts() const
+{
+    return m_parts;
+}
+
+QString CSVPartWriter::errorString() const
+{
+    return m_error;
+}
+
+bool CSVPartWriter::openNext()
+{
+    m_file.setFileName(QString("%1-%2").arg(m_tempPrefix).arg(m_parts.size()));
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        m_error = "Cannot open file for writing: " + m_file.errorString();
+        return false;
+    }
+
+    m_hash.reset();
+    m_fileRows = 0;
+    m_fileBytes = m_header.size();
+    m_buffer.append(m_header);
+    return true;
+}
+
+bool CSVPartWriter::flush()
+{
+    if (m_buffer.isEmpty())
+        return true;
+
+    m_hash.addData(m_buffer);
+    if (m_file.write(m_buffer) != m_buffer.size())
+    {
+        m_error = "Cannot write to file: " + m_file.errorString();
+        m_file.close();
+        m_file.remove();
+        return false;
+    }
+
+    m_buffer.resize(0); // keeps capacity
+    return true;
+}
+
+bool CSVPartWriter::closeCurrent()
+{
+    const QString filePath = m_file.fileName();
+    if (!flush())
+        return false;
+    m_file.close();
+
+    CSVPartInfo info;
+    info.filePath = filePath;
+    info.rows = m_fileRows;
+    info.bytes = m_fileBytes;
+    info.sha256 = m_hash.result().toHex();
+    m_parts.append(info);
+    return true;
+}
+
+/*************** end of CSVPartWriter *****************/
+
 /*************** end of public methods ****************/
 
 
@@ -182,15 +484,19 @@ int CSVExporter::calculateOptimalBufferSize(const QVector<QStringList> &data) co
     }
 
     int avgRowSize = totalEstimatedSize / samplesToCheck;
-    int totalRows = data.size();
 
+    return bufferSizeForRows(data.size(), avgRowSize);
+}
+
+int CSVExporter::bufferSizeForRows(qsizetype totalRows, int avgRowSize) const
+{
     // Define buffer size based on dataset size
     int bufferSize;
 
     if (totalRows < 100)
     {
         // Small dataset: 8KB - 16KB
-        bufferSize = qMax(8192, avgRowSize * totalRows);
+        bufferSize = qMax(8192, avgRowSize * int(totalRows));
     }
     else if (totalRows < 1000)
     {
@@ -217,4 +523,192 @@ int CSVExporter::calculateOptimalBufferSize(const QVector<QStringList> &data) co
     return qMin(bufferSize, 1048576);
 }
 
+bool CSVExporter::checkPartsExport(qsizetype rowCount)
+{
+    m_lastPartFiles.clear();
+    m_lastManifestPath.clear();
+
+    if (m_filePath.isEmpty())
+    {
+        m_lastError = "File path is not set";
+        return false;
+    }
+
+    if (rowCount == 0)
+    {
+        m_lastError = "No data to export";
+        return false;
+    }
+
+    return true;
+}
+
+qsizetype CSVExporter::rowsPerPartRange(qsizetype rowCount, qsizetype sampleRows,
+                                        qint64 sampleBytes, qint64 headerBytes) const
+{
+    qsizetype rangeRows = rowCount;
+
+    if (m_maxRowsPerPart > 0)
+        rangeRows = qMin<qsizetype>(rangeRows, m_maxRowsPerPart);
+
+    if (m_maxBytesPerPart > 0 && sampleRows > 0)
+    {
+        // Aim a little under the byte limit, so a range normally ends up as one part
+        const double avgRowBytes = qMax(1.0, double(sampleBytes) / sampleRows);
+        const double usableBytes = qMax<double>(1.0, m_maxBytesPerPart - headerBytes);
+        rangeRows = qMin<qsizetype>(rangeRows, qMax<qsizetype>(1, qsizetype(usableBytes * 0.95 / avgRowBytes)));
+    }
+
+    return qMax<qsizetype>(1, rangeRows);
+}
+
+int CSVExporter::partThreadCount() const
+{
+    return m_threadCount > 0 ? m_threadCount : qMax(1, QThread::idealThreadCount());
+}
+
+bool CSVExporter::finishParts(const QVector<QList<CSVPartInfo>> &rangeParts,
+                              const QVector<QString> &rangeErrors, bool failed)
+{
+    if (failed)
+    {
+        for (const QString &error : rangeErrors)
+        {
+            if (!error.isEmpty())
+            {
+                m_lastError = error;
+                break;
+            }
+        }
+
+        // Don't leave half an export behind
+        for (const QList<CSVPartInfo> &parts : rangeParts)
+        {
+            for (const CSVPartInfo &part : parts)
+                QFile::remove(part.filePath);
+        }
+        return false;
+    }
+
+    const QFileInfo target(m_filePath);
+    const QDir dir = target.absoluteDir();
+    const QString suffix = target.suffix().isEmpty() ? QString("csv") : target.suffix();
+
+    QJsonArray manifestParts;
+    qint64 totalRows = 0;
+    int partNumber = 0;
+
+    // Number the parts in row order
+    for (const QList<CSVPartInfo> &parts : rangeParts)
+    {
+        for (const CSVPartInfo &part : parts)
+        {
+            const QString fileName = QString("%1_part%2.%3")
+                                         .arg(target.completeBaseName())
+                                         .arg(++partNumber, 4, 10, QChar('0'))
+                                         .arg(suffix);
+            const QString finalPath = dir.filePath(fileName);
+
+            QFile::remove(finalPath);
+            if (!QFile::rename(part.filePath, finalPath))
+            {
+                m_lastError = "Cannot rename part file to " + finalPath;
+                return false;
+            }
+
+            m_lastPartFiles.append(finalPath);
+            totalRows += part.rows;
+
+            QJsonObject entry;
+            entry["file"] = fileName;
+            entry["rows"] = part.rows;
+            entry["bytes"] = part.bytes;
+            entry["sha256"] = QString::fromLatin1(part.sha256);
+            manifestParts.append(entry);
+        }
+    }
+
+    QJsonObject manifest;
+    manifest["created"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    manifest["delimiter"] = m_delimiter;
+    manifest["totalRows"] = totalRows;
+    manifest["parts"] = manifestParts;
+
+    m_lastManifestPath = dir.filePath(target.completeBaseName() + ".manifest.json");
+    QFile manifestFile(m_lastManifestPath);
+    if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        manifestFile.write(QJsonDocument(manifest).toJson()) < 0)
+    {
+        m_lastError = "Cannot write manifest: " + manifestFile.errorString();
+        return false;
+    }
+
+    manifestFile.close();
+    m_lastError.clear();
+    return true;
+}
+
+bool CSVExporter::beginRows(qsizetype rowCount, bool hasHeaders)
+{
+    if (m_filePath.isEmpty())
+    {
+        m_lastError = "File path is not set";
+        return false;
+    }
+
+    if (rowCount == 0 && !hasHeaders)
+    {
+        m_lastError = "No data to export";
+        return false;
+    }
+
+    m_rowTimer.start();
+    m_rowTotal = rowCount;
+
+    m_rowFile.setFileName(m_filePath);
+    if (!m_rowFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        m_lastError = "Cannot open file for writing: " + m_rowFile.errorString();
+        return false;
+    }
+
+    // Typed rows can't be sampled up front, assume a typical mahasiswa row (~48 bytes)
+    m_rowFlushSize = m_autoBufferSize ? bufferSizeForRows(rowCount, 48) : qMax(1, m_bufferSize);
+
+    m_rowBuffer.clear();
+    m_rowBuffer.reserve(m_rowFlushSize + 1024);
+    return true;
+}
+
+bool CSVExporter::flushRows()
+{
+    if (m_rowBuffer.isEmpty())
+        return true;
+
+    if (m_rowFile.write(m_rowBuffer) != m_rowBuffer.size())
+    {
+        m_lastError = "Cannot write to file: " + m_rowFile.errorString();
+        m_rowFile.close();
+        m_rowBuffer.clear();
+        return false;
+    }
+
+    m_rowBuffer.resize(0); // keeps capacity
+    return true;
+}
+
+bool CSVExporter::endRows()
+{
+    if (!flushRows())
+        return false;
+
+    const qint64 bytes = m_rowFile.size();
+    m_rowFile.close();
+    m_rowBuffer = QByteArray();
+    m_lastError.clear();
+
+    PerfCounters::recordExport("csv", m_rowTotal, bytes, m_rowTimer.elapsed());
+    return true;
+}
+
 /*************** end of private methods ***************/
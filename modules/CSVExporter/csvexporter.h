@@ -2,11 +2,90 @@
 #define CSVEXPORTER_H
 
 #include <QFile>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QString>
 #include <QVector>
 #include <QStringList>
 #include <QTextStream>
+#include <QByteArray>
+#include <QStringView>
+#include <QCryptographicHash>
+#include <QThreadPool>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
+#include <atomic>
+#include "helpers/Environments.h"
+#include "helpers/databasemanager.h"
+#include "helpers/tracer.h"
+
+// Writes the fields of one row straight into CSVExporter's UTF-8 output buffer.
+// Numbers are formatted with std::to_chars, strings are escaped and encoded in
+// a single pass, so no per-row container or temporary string is allocated.
+class CSVRowWriter
+{
+public:
+    void writeField(const QString& field);
+    void writeField(qint64 value);
+    void writeField(int value) { writeField(qint64(value)); }
+
+private:
+    friend class CSVExporter;
+
+    CSVRowWriter(QByteArray& buffer, const QString& delimiter);
+    void endRow();
+    void appendEncoded(QStringView text, bool doubleQuotes);
+
+    QByteArray& m_buffer;
+    const QString& m_delimiter;
+    QByteArray m_delimiterUtf8;
+    bool m_firstField;
+};
+
+// One finished part file of a split export
+struct CSVPartInfo
+{
+    QString filePath;
+    qint64 rows;
+    qint64 bytes;
+    QByteArray sha256; // hex
+};
+
+// Writes encoded rows of one row range into part files, starting a new file
+// whenever the row or byte limit would be exceeded. Every file starts with the
+// header row. Files are written in binary mode so byte counts and checksums
+// match the files on disk on every platform.
+class CSVPartWriter
+{
+public:
+    CSVPartWriter(const QString& tempPrefix, const QByteArray& header,
+                  qint64 maxRows, qint64 maxBytes, int flushSize);
+
+    bool appendRow(const QByteArray& row);
+    bool finish();
+
+    QList<CSVPartInfo> parts() const;
+    QString errorString() const;
+
+private:
+    bool openNext();
+    bool flush();
+    bool closeCurrent();
+
+    QString m_tempPrefix;
+    QByteArray m_header;
+    qint64 m_maxRows;
+    qint64 m_maxBytes;
+    int m_flushSize;
+
+    QFile m_file;
+    QByteArray m_buffer;
+    QCryptographicHash m_hash;
+    qint64 m_fileRows;
+    qint64 m_fileBytes;
+    QList<CSVPartInfo> m_parts;
+    QString m_error;
+};
 
 class CSVExporter : public QObject
 {
@@ -26,6 +105,13 @@ public:
     // Enable/disable automatic buffer sizing (enabled by default)
     void setAutoBufferSize(bool enable);
 
+    // Limits of one part file for exportRowsToParts() (0 = no limit, default)
+    void setMaxRowsPerPart(qint64 rows);
+    void setMaxBytesPerPart(qint64 bytes);
+
+    // Writer threads for exportRowsToParts() (default: 0 = QThread::idealThreadCount())
+    void setThreadCount(int count);
+
     // Export data to CSV file
     // data: 2D vector where each inner vector represents a row
     // Returns true if successful, false otherwise
@@ -35,6 +121,151 @@ public:
     bool exportDataWithHeaders(const QStringList& headers,
                                const QVector<QStringList>& data);
 
+    // Export typed rows without converting them to QStringList first.
+    // adapter is called as adapter(row, writer) and writes the row's fields in
+    // column order with writer.writeField(...), see StudentsRowAdapter.
+    // Headers are written first when not empty.
+    template <typename Container, typename Adapter>
+    bool exportRows(const Container& rows, Adapter adapter,
+                    const QStringList& headers = QStringList())
+    {
+        TRACE_SPAN("csv", "CSVExporter::exportRows");
+
+        if (!beginRows(rows.size(), !headers.isEmpty()))
+            return false;
+
+        CSVRowWriter writer(m_rowBuffer, m_delimiter);
+
+        if (!headers.isEmpty())
+        {
+            for (const QString& header : headers)
+                writer.writeField(header);
+            writer.endRow();
+        }
+
+        for (const auto& row : rows)
+        {
+            adapter(row, writer);
+            writer.endRow();
+
+            if (m_rowBuffer.size() >= m_rowFlushSize && !flushRows())
+                return false;
+        }
+
+        return endRows();
+    }
+
+    // Split export: writes <name>_part0001.<ext>, <name>_part0002.<ext>, ... next to
+    // the file path, each with the header row and within the row/byte limits, plus
+    // <name>.manifest.json with the row count, size and SHA-256 of every part.
+    // Writer threads claim row ranges from a shared cursor and write them concurrently;
+    // the parts are numbered in row order once all threads are done.
+    template <typename Container, typename Adapter>
+    bool exportRowsToParts(const Container& rows, Adapter adapter,
+                           const QStringList& headers = QStringList())
+    {
+        TRACE_SPAN("csv", "CSVExporter::exportRowsToParts");
+
+        const qsizetype rowCount = rows.size();
+        if (!checkPartsExport(rowCount))
+            return false;
+
+        QByteArray headerBytes;
+        if (!headers.isEmpty())
+        {
+            CSVRowWriter writer(headerBytes, m_delimiter);
+            for (const QString& header : headers)
+                writer.writeField(header);
+            writer.endRow();
+        }
+
+        // Encode a sample to estimate how many rows fit in one part
+        const qsizetype sampleRows = qMin<qsizetype>(rowCount, 1000);
+        QByteArray sample;
+        {
+            CSVRowWriter writer(sample, m_delimiter);
+            for (qsizetype i = 0; i < sampleRows; ++i)
+            {
+                adapter(rows.at(i), writer);
+                writer.endRow();
+            }
+        }
+
+        const qsizetype rangeRows = rowsPerPartRange(rowCount, sampleRows, sample.size(), headerBytes.size());
+        const int rangeCount = int((rowCount + rangeRows - 1) / rangeRows);
+        const int threads = qMin(partThreadCount(), rangeCount);
+        const int flushSize = m_autoBufferSize ? 524288 : qMax(1, m_bufferSize);
+
+        // Shared cursor: every thread claims the next row range until none is left
+        std::atomic<int> nextRange(0);
+        std::atomic<bool> failed(false);
+        QVector<QList<CSVPartInfo>> rangeParts(rangeCount);
+        QVector<QString> rangeErrors(rangeCount);
+        // Each range has its own slot, threads never touch the same element
+        QList<CSVPartInfo>* partsOut = rangeParts.data();
+        QString* errorsOut = rangeErrors.data();
+
+        {
+            QThreadPool pool;
+            pool.setMaxThreadCount(threads);
+
+            QList<QFuture<void>> writers;
+            for (int t = 0; t < threads; ++t)
+            {
+                writers.append(QtConcurrent::run(&pool, [&]() {
+                    QByteArray rowBytes;
+                    CSVRowWriter writer(rowBytes, m_delimiter);
+
+                    int range;
+                    while (!failed && (range = nextRange.fetch_add(1)) < rangeCount)
+                    {
+                        CSVPartWriter part(QString("%1.tmp-%2").arg(m_filePath).arg(range),
+                                           headerBytes, m_maxRowsPerPart, m_maxBytesPerPart, flushSize);
+
+                        const qsizetype first = qsizetype(range) * rangeRows;
+                        const qsizetype last = qMin(rowCount, first + rangeRows);
+                        bool ok = true;
+
+                        for (qsizetype i = first; i < last && ok; ++i)
+                        {
+                            rowBytes.resize(0);
+                            adapter(rows.at(i), writer);
+                            writer.endRow();
+                            ok = part.appendRow(rowBytes);
+                        }
+
+                        ok = ok && part.finish();
+                        partsOut[range] = part.parts();
+                        if (!ok)
+                        {
+                            errorsOut[range] = part.errorString();
+                            failed = true;
+                        }
+                    }
+                }));
+            }
+
+            for (QFuture<void>& writerThread : writers)
+                writerThread.waitForFinished();
+        }
+
+        return finishParts(rangeParts, rangeErrors, failed);
+    }
+
+    // Part files and manifest of the last exportRowsToParts()
+    QStringList getLastPartFiles() const;
+    QString getLastManifestPath() const;
+
+    // Incremental export: only rows inserted, updated or deleted since the last
+    // successful export named exportName (columns: change;id;nama;npm;kelas).
+    // The first run exports every row as an insert. The watermark is saved in
+    // the database only after the file has been written completely.
+    bool exportChanges(DatabaseManager* dbManager, const QString& exportName,
+                       const QString& tableName = "mahasiswa");
+
+    // Rows written by the last exportChanges()
+    qint64 getLastRowCount() const;
+
     // Get the last error message
     QString getLastError() const;
 
@@ -44,6 +275,19 @@ private:
     QString m_lastError;
     int m_bufferSize;
     bool m_autoBufferSize;
+    qint64 m_lastRowCount;
+    qint64 m_maxRowsPerPart;
+    qint64 m_maxBytesPerPart;
+    int m_threadCount;
+    QStringList m_lastPartFiles;
+    QString m_lastManifestPath;
+
+    // State of a running exportRows()
+    QFile m_rowFile;
+    QByteArray m_rowBuffer;
+    int m_rowFlushSize;
+    qsizetype m_rowTotal;
+    QElapsedTimer m_rowTimer;
 
     // Escape field if it contains delimiter, quotes, or newlines
     QString escapeField(const QString& field) const;
@@ -53,6 +297,22 @@ private:
 
     // Calculate optimal buffer size based on data
     int calculateOptimalBufferSize(const QVector<QStringList>& data) const;
+
+    // Buffer size for totalRows rows of about avgRowSize characters
+    int bufferSizeForRows(qsizetype totalRows, int avgRowSize) const;
+
+    // exportRowsToParts() steps that don't depend on the row type
+    bool checkPartsExport(qsizetype rowCount);
+    qsizetype rowsPerPartRange(qsizetype rowCount, qsizetype sampleRows,
+                               qint64 sampleBytes, qint64 headerBytes) const;
+    int partThreadCount() const;
+    bool finishParts(const QVector<QList<CSVPartInfo>>& rangeParts,
+                     const QVector<QString>& rangeErrors, bool failed);
+
+    // exportRows() steps that don't depend on the row type
+    bool beginRows(qsizetype rowCount, bool hasHeaders);
+    bool flushRows();
+    bool endRows();
 };
 
 #endif // CSVEXPORTER_H
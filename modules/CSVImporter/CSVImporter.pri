@@ -0,0 +1,3 @@
+SOURCES += $$PWD/csvimporter.cpp
+HEADERS += $$PWD/csvimporter.h
+INCLUDEPATH += $$PWD
\ No newline at end of file
@@ -0,0 +1,797 @@
+#include "csvimporter.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+#include <QDebug>
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+// Smaller files are parsed on the calling thread, splitting them costs more than it saves
+constexpr qint64 PARALLEL_MIN_BYTES = 1 << 20;
+// Target size of one parser chunk (roughly 100k rows of a typical export)
+constexpr qint64 CHUNK_BYTES = 4 << 20;
+// Upper bound of the row guess reserved up front, the vector grows past it if needed
+constexpr qint64 MAX_RESERVED_ROWS = 1 << 16;
+}
+
+CSVImporter::CSVImporter(QObject *parent)
+    : QObject{parent}
+    , m_delimiter(",")
+    , m_delimiterUtf8(",")
+    , m_batchSize(50000)
+    , m_threadCount(0)
+    , m_hasHeader(true)
+    , m_conflictPolicy(DatabaseManager::SkipOnConflict)
+{}
+
+/*************** public methods ***********************/
+
+void CSVImporter::setDelimiter(const QString &delimiter)
+{
+    // Quotes and line breaks can't be delimiters, keep the previous one
+    if (delimiter.isEmpty() || delimiter.contains('"') ||
+        delimiter.contains('\n') || delimiter.contains('\r'))
+        return;
+
+    m_delimiter = delimiter;
+    m_delimiterUtf8 = delimiter.toUtf8();
+}
+
+void CSVImporter::setFilePath(const QString &filePath)
+{
+    m_filePath = filePath;
+}
+
+void CSVImporter::setHasHeader(bool hasHeader)
+{
+    m_hasHeader = hasHeader;
+}
+
+void CSVImporter::setBatchSize(int size)
+{
+    m_batchSize = qMax(1, size);
+}
+
+void CSVImporter::setConflictPolicy(DatabaseManager::ConflictPolicy policy)
+{
+    m_conflictPolicy = policy;
+}
+
+void CSVImporter::setThreadCount(int count)
+{
+    m_threadCount = qMax(0, count);
+}
+
+bool CSVImporter::importData(DatabaseManager *dbManager, const QString &tableName)
+{
+    TRACE_SPAN("csv", "CSVImporter::importData");
+
+    m_stats = ImportStats();
+    m_rejectedRows.clear();
+
+    if (!dbManager || !dbManager->isDatabaseOpen())
+    {
+        m_lastError = "Database is not open";
+        return false;
+    }
+
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    QFile file(m_filePath);
+    QByteArray fallback;
+    const char *pos = nullptr;
+    const char *end = nullptr;
+    if (!openInput(file, fallback, pos, end))
+        return false;
+
+    qint64 line = 1;
+    ColumnMap map;
+    if (!resolveColumns(pos, end, map, line))
+        return false;
+
+    // AbortOnConflict is all or nothing, other policies keep every finished batch
+    const bool singleTransaction = (m_conflictPolicy == DatabaseManager::AbortOnConflict);
+
+    if (!dbManager->beginTransaction())
+    {
+        m_lastError = "Cannot start a database transaction";
+        return false;
+    }
+
+    QElapsedTimer stepTimer;
+
+    // Write one parsed batch, committing it unless the import is all or nothing
+    auto writeBatch = [&](const QVector<StudentsDataStruct> &rows, qint64 nextLine) -> bool
+    {
+        if (rows.isEmpty())
+            return true;
+
+        stepTimer.start();
+        qint64 affected = 0;
+        bool ok = dbManager->insertStudentsBatch(tableName, rows, m_conflictPolicy, &affected);
+        if (ok && !singleTransaction)
+            ok = dbManager->commitTransaction();
+
+        if (!ok)
+        {
+            dbManager->rollbackTransaction();
+            m_lastError = singleTransaction
+                ? QString("Insert failed before line %1 (duplicate nama?), nothing was imported").arg(nextLine)
+                : QString("Insert failed before line %1, %2 rows were already imported")
+                      .arg(nextLine).arg(m_stats.rowsInserted);
+            return false;
+        }
+
+        m_stats.rowsInserted += affected;
+        m_stats.rowsSkipped += rows.size() - affected;
+
+        if (!singleTransaction && !dbManager->beginTransaction())
+        {
+            m_lastError = "Cannot start a database transaction";
+            return false;
+        }
+
+        m_stats.insertMs += stepTimer.elapsed();
+        return true;
+    };
+
+    const int threads = effectiveThreadCount();
+
+    if (threads > 1 && end - pos >= PARALLEL_MIN_BYTES)
+    {
+        // Declared after the file mapping, so its destructor waits for every
+        // parser before the mapping goes away (also on early returns)
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+
+        const int chunkCount = int(qBound<qint64>(threads, (end - pos) / CHUNK_BYTES, 4096));
+        const QVector<Chunk> chunks = splitChunks(pos, end, line, chunkCount, &pool);
+
+        // Keep a bounded number of parsed chunks in flight so memory stays flat
+        // when the writer is slower than the parsers
+        const int window = threads * 2;
+        QList<QFuture<ParsedChunk>> pending;
+        int nextChunk = 0;
+
+        for (int i = 0; i < chunks.size(); ++i)
+        {
+            while (nextChunk < chunks.size() && nextChunk - i < window)
+            {
+                const Chunk chunk = chunks[nextChunk++];
+                pending.append(QtConcurrent::run(&pool, [this, chunk, map]() {
+                    return parseChunk(chunk, map);
+                }));
+            }
+
+            // Time the writer spends waiting for the parsers
+            stepTimer.start();
+            const ParsedChunk parsed = pending.takeFirst().result();
+            m_stats.parseMs += stepTimer.elapsed();
+
+            mergeChunk(parsed);
+
+            // A chunk holds far more rows than a batch, commit it batch by batch
+            for (qsizetype from = 0; from < parsed.rows.size(); from += m_batchSize)
+            {
+                if (!writeBatch(parsed.rows.mid(from, m_batchSize), parsed.nextLine))
+                    return false;
+            }
+
+            emit importProgress(m_stats.rowsRead);
+        }
+    }
+    else
+    {
+        ParsedChunk batch;
+        batch.rows.reserve(m_batchSize);
+
+        while (pos < end)
+        {
+            batch.rows.clear(); // keeps capacity
+            batch.rowsRead = 0;
+            batch.rowsRejected = 0;
+            batch.rejectedRows.clear();
+
+            stepTimer.start();
+            pos = parseRecords(pos, end, map, m_batchSize, batch, line);
+            m_stats.parseMs += stepTimer.elapsed();
+
+            mergeChunk(batch);
+            if (!writeBatch(batch.rows, line))
+                return false;
+
+            emit importProgress(m_stats.rowsRead);
+        }
+    }
+
+    if (!dbManager->commitTransaction())
+    {
+        dbManager->rollbackTransaction();
+        m_lastError = "Cannot commit the imported rows";
+        return false;
+    }
+
+    m_stats.elapsedMs = totalTimer.elapsed();
+    qCDebug(lcCsv) << "CSVImporter:" << m_stats.rowsRead << "rows read,"
+                   << m_stats.rowsInserted << "written," << m_stats.rowsSkipped << "skipped,"
+                   << m_stats.rowsRejected << "rejected in" << m_stats.elapsedMs << "ms"
+                   << "(parse" << m_stats.parseMs << "ms, insert" << m_stats.insertMs << "ms)";
+
+    m_lastError.clear();
+    return true;
+}
+
+bool CSVImporter::parseData(QVector<StudentsDataStruct> &rows)
+{
+    TRACE_SPAN("csv", "CSVImporter::parseData");
+
+    m_stats = ImportStats();
+    m_rejectedRows.clear();
+    rows.clear();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(m_filePath);
+    QByteArray fallback;
+    const char *pos = nullptr;
+    const char *end = nullptr;
+    if (!openInput(file, fallback, pos, end))
+        return false;
+
+    qint64 line = 1;
+    ColumnMap map;
+    if (!resolveColumns(pos, end, map, line))
+        return false;
+
+    const int threads = effectiveThreadCount();
+
+    if (threads > 1 && end - pos >= PARALLEL_MIN_BYTES)
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+
+        const int chunkCount = int(qBound<qint64>(threads, (end - pos) / CHUNK_BYTES, 4096));
+        const QVector<Chunk> chunks = splitChunks(pos, end, line, chunkCount, &pool);
+
+        QList<QFuture<ParsedChunk>> parsers;
+        parsers.reserve(chunks.size());
+        for (const Chunk &chunk : chunks)
+        {
+            parsers.append(QtConcurrent::run(&pool, [this, chunk, map]() {
+                return parseChunk(chunk, map);
+            }));
+        }
+
+        // Concatenate in file order, same result as the single threaded path
+        qsizetype total = 0;
+        for (QFuture<ParsedChunk> &parser : parsers)
+            total += parser.result().rows.size();
+        rows.reserve(total);
+
+        for (QFuture<ParsedChunk> &parser : parsers)
+        {
+            const ParsedChunk parsed = parser.result();
+            mergeChunk(parsed);
+            rows.append(parsed.rows);
+        }
+    }
+    else
+    {
+        // Rough guess of ~32 bytes per record, capped so a large file does not reserve gigabytes
+        ParsedChunk parsed;
+        parsed.rows.reserve(int(qMin<qint64>((end - pos) / 32 + 1, MAX_RESERVED_ROWS)));
+        parseRecords(pos, end, map, INT_MAX, parsed, line);
+        mergeChunk(parsed);
+        rows = std::move(parsed.rows);
+    }
+
+    m_stats.parseMs = m_stats.elapsedMs = timer.elapsed();
+    m_lastError.clear();
+    return true;
+}
+
+CSVImporter::ImportStats CSVImporter::getLastStats() const
+{
+    return m_stats;
+}
+
+QStringList CSVImporter::getRejectedRows() const
+{
+    return m_rejectedRows;
+}
+
+QString CSVImporter::getLastError() const
+{
+    return m_lastError;
+}
+
+/*************** end of public methods ****************/
+
+
+/*************** private methods **********************/
+
+bool CSVImporter::openInput(QFile &file, QByteArray &fallback, const char *&begin, const char *&end)
+{
+    if (m_filePath.isEmpty())
+    {
+        m_lastError = "File path is not set";
+        return false;
+    }
+
+    file.setFileName(m_filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        m_lastError = "Cannot open file for reading: " + file.errorString();
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size <= 0)
+    {
+        m_lastError = "File is empty";
+        return false;
+    }
+
+    // Map the whole file, the OS pages it in as the parser walks through it.
+    // The mapping is released together with the QFile.
+    uchar *mapped = file.map(0, size);
+    if (mapped)
+    {
+        begin = reinterpret_cast<const char *>(mapped);
+        end = begin + size;
+    }
+    else
+    {
+        fallback = file.readAll();
+        begin = fallback.constData();
+        end = begin + fallback.size();
+    }
+
+    // Skip UTF-8 BOM
+    if (end - begin >= 3 && memcmp(begin, "\xEF\xBB\xBF", 3) == 0)
+        begin += 3;
+
+    return true;
+}
+
+bool CSVImporter::resolveColumns(const char *&pos, const char *end, ColumnMap &map, qint64 &line)
+{
+    QVector<FieldRef> fields;
+    bool wellFormed = true;
+    qint64 nextLine = line;
+    const char *next = splitRecord(pos, end, fields, nextLine, wellFormed);
+
+    if (!wellFormed)
+    {
+        m_lastError = "The first record is not valid CSV";
+        return false;
+    }
+
+    if (m_hasHeader)
+    {
+        for (int i = 0; i < fields.size(); ++i)
+        {
+            const QString name = fieldToString(fields[i]).trimmed().toLower();
+            if (name == "nama")
+                map.nama = i;
+            else if (name == "npm")
+                map.npm = i;
+            else if (name == "kelas")
+                map.kelas = i;
+        }
+
+        if (map.nama < 0 || map.npm < 0 || map.kelas < 0)
+        {
+            m_lastError = "Header must contain nama, npm and kelas columns";
+            return false;
+        }
+
+        // Data starts after the header
+        pos = next;
+        line = nextLine;
+    }
+    else if (fields.size() >= 4)
+    {
+        // CSVExporter layout: id;nama;npm;kelas
+        map.nama = 1;
+        map.npm = 2;
+        map.kelas = 3;
+    }
+    else if (fields.size() == 3)
+    {
+        map.nama = 0;
+        map.npm = 1;
+        map.kelas = 2;
+    }
+    else
+    {
+        m_lastError = QString("Expected 3 or 4 columns, found %1 (check the delimiter)").arg(fields.size());
+        return false;
+    }
+
+    map.required = qMax(map.nama, qMax(map.npm, map.kelas)) + 1;
+    return true;
+}
+
+const char *CSVImporter::splitRecord(const char *pos, const char *end,
+                                     QVector<FieldRef> &fields, qint64 &line, bool &wellFormed) const
+{
+    const char *delim = m_delimiterUtf8.constData();
+    const int delimSize = m_delimiterUtf8.size();
+    const char delimFirst = delim[0];
+
+    auto atDelimiter = [&](const char *p) {
+        return *p == delimFirst &&
+               (delimSize == 1 || (end - p >= delimSize && memcmp(p, delim, delimSize) == 0));
+    };
+
+    fields.clear();
+    wellFormed = true;
+    const char *p = pos;
+
+    while (true)
+    {
+        FieldRef field { p, 0, false, false };
+
+        if (p < end && *p == '"')
+        {
+            // Quoted field, ends at the first quote that is not doubled
+            field.quoted = true;
+            field.data = ++p;
+            while (true)
+            {
+                const char *quote = static_cast<const char *>(memchr(p, '"', end - p));
+                if (!quote)
+                {
+                    // Unterminated quote swallows the rest of the file
+                    line += std::count(p, end, '\n');
+                    field.size = int(end - field.data);
+                    fields.append(field);
+                    wellFormed = false;
+                    return end;
+                }
+
+                line += std::count(p, quote, '\n');
+                if (quote + 1 < end && quote[1] == '"')
+                {
+                    field.hasEscapedQuotes = true;
+                    p = quote + 2;
+                    continue;
+                }
+
+                field.size = int(quote - field.data);
+                p = quote + 1;
+                break;
+            }
+        }
+        else
+        {
+            const char *q = p;
+            while (q < end && *q != '\n' && !atDelimiter(q))
+                ++q;
+
+            field.size = int(q - p);
+
+            // CRLF line ending
+            if (field.size > 0 && (q == end || *q == '\n') && p[field.size - 1] == '\r')
+                --field.size;
+
+            p = q;
+        }
+
+        fields.append(field);
+
+        if (p >= end)
+            return end;
+
+        if (atDelimiter(p))
+        {
+            p += delimSize;
+            continue;
+        }
+
+        if (*p == '\r' && p + 1 < end && p[1] == '\n')
+            ++p;
+        else if (*p == '\r' && p + 1 == end)
+            return end;
+
+        if (*p == '\n')
+        {
+            ++line;
+            return p + 1;
+        }
+
+        // Something after a closing quote, drop the rest of the line
+        wellFormed = false;
+        const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!eol)
+            return end;
+
+        ++line;
+        return eol + 1;
+    }
+}
+
+const char *CSVImporter::parseRecords(const char *pos, const char *end, const ColumnMap &map,
+                                      int maxRows, ParsedChunk &out, qint64 &line) const
+{
+    TRACE_SPAN("csv", "CSVImporter::parseRecords");
+
+    QVector<FieldRef> fields;
+    fields.reserve(map.required + 4);
+
+    int processed = 0;
+    while (pos < end && processed < maxRows)
+    {
+        const qint64 recordLine = line;
+        bool wellFormed = true;
+        pos = splitRecord(pos, end, fields, line, wellFormed);
+
+        // Blank line (a line with only "" is an empty record, not a blank line)
+        if (fields.size() == 1 && fields[0].size == 0 && !fields[0].quoted)
+            continue;
+
+        ++processed;
+        ++out.rowsRead;
+
+        if (!wellFormed)
+        {
+            rejectRow(out, recordLine, "malformed quoted field");
+            continue;
+        }
+
+        if (fields.size() < map.required)
+        {
+            rejectRow(out, recordLine, QString("expected at least %1 columns, found %2")
+                                      .arg(map.required).arg(fields.size()));
+            continue;
+        }
+
+        StudentsDataStruct student;
+        student.id = -1;
+        student.nama = fieldToString(fields[map.nama]);
+        student.npm = fieldToString(fields[map.npm]);
+        student.kelas = fieldToString(fields[map.kelas]);
+
+        if (student.nama.trimmed().isEmpty())
+        {
+            rejectRow(out, recordLine, "nama is empty");
+            continue;
+        }
+
+        if (!isValidNpm(student.npm))
+        {
+            rejectRow(out, recordLine, "npm must contain digits only");
+            continue;
+        }
+
+        if (student.kelas.trimmed().isEmpty())
+        {
+            rejectRow(out, recordLine, "kelas is empty");
+            continue;
+        }
+
+        out.rows.append(student);
+    }
+
+    out.nextLine = line;
+    return pos;
+}
+
+CSVImporter::ParsedChunk CSVImporter::parseChunk(const Chunk &chunk, const ColumnMap &map) const
+{
+    ParsedChunk parsed;
+    parsed.rows.reserve(int((chunk.end - chunk.begin) / 32 + 1));
+
+    qint64 line = chunk.firstLine;
+    parseRecords(chunk.begin, chunk.end, map, INT_MAX, parsed, line);
+    return parsed;
+}
+
+QVector<CSVImporter::Chunk> CSVImporter::splitChunks(const char *begin, const char *end, qint64 firstLine,
+                                                     int count, QThreadPool *pool) const
+{
+    const qint64 total = end - begin;
+
+    // Nominal edges, evenly spaced and moved to just after the next line break.
+    // Nothing spans such an edge except a quoted field: delimiters and CRLF
+    // cannot contain the line break they would have to cross.
+    QVector<const char *> edges;
+    edges.reserve(count + 1);
+    edges.append(begin);
+    for (int i = 1; i < count; ++i)
+    {
+        const char *nominal = qMax(begin + total * i / count, edges.last());
+        const char *eol = static_cast<const char *>(memchr(nominal, '\n', end - nominal));
+        if (!eol || eol + 1 >= end)
+            break;
+        if (eol + 1 > edges.last())
+            edges.append(eol + 1);
+    }
+    edges.append(end);
+
+    // Pre-scan every slice on the pool from both possible start states. A stray
+    // quote inside an unquoted field does not open a quoted field, so the
+    // states follow the parser instead of counting quotes.
+    const int slices = edges.size() - 1;
+    QList<QFuture<SliceScan>> scans;
+    scans.reserve(slices);
+    for (int i = 0; i < slices; ++i)
+    {
+        const char *from = edges[i];
+        const char *to = edges[i + 1];
+        scans.append(QtConcurrent::run(pool, [this, from, to]() {
+            SliceScan scan;
+            scan.endFromRecordStart = scanSlice(from, to, RecordStart);
+            scan.endFromInQuotes = scanSlice(from, to, InQuotes);
+            scan.newlines = std::count(from, to, '\n');
+            return scan;
+        }));
+    }
+
+    // Chain the states in file order, an edge is a chunk boundary when a record starts there
+    QVector<Chunk> chunks;
+    chunks.reserve(slices);
+
+    const char *chunkStart = begin;
+    qint64 chunkLine = firstLine;
+    qint64 line = firstLine;
+    SliceState state = RecordStart;
+
+    for (int i = 0; i < slices; ++i)
+    {
+        const SliceScan scan = scans[i].result();
+        state = (state == RecordStart) ? scan.endFromRecordStart : scan.endFromInQuotes;
+        line += scan.newlines;
+
+        const char *edge = edges[i + 1];
+        if (edge < end && state == RecordStart)
+        {
+            chunks.append(Chunk { chunkStart, edge, chunkLine });
+            chunkStart = edge;
+            chunkLine = line;
+        }
+    }
+
+    chunks.append(Chunk { chunkStart, end, chunkLine });
+    return chunks;
+}
+
+CSVImporter::SliceState CSVImporter::scanSlice(const char *from, const char *to, SliceState state) const
+{
+    // States of splitRecord(), from the start of a field to the end of the record
+    enum { FieldStart, Unquoted, Quoted, AfterQuote, Malformed } field =
+        (state == RecordStart) ? FieldStart : Quoted;
+
+    const char *delim = m_delimiterUtf8.constData();
+    const int delimSize = m_delimiterUtf8.size();
+
+    auto atDelimiter = [&](const char *p) {
+        return *p == delim[0] && (delimSize == 1 || (to - p >= delimSize && memcmp(p, delim, delimSize) == 0));
+    };
+
+    for (const char *p = from; p < to; ++p)
+    {
+        const char c = *p;
+
+        switch (field)
+        {
+        case FieldStart:
+        case Unquoted:
+            if (c == '\n')
+                field = FieldStart;
+            else if (atDelimiter(p))
+            {
+                field = FieldStart;
+                p += delimSize - 1;
+            }
+            else if (c == '"' && field == FieldStart)
+                field = Quoted;
+            else
+                field = Unquoted;
+            break;
+
+        case Quoted:
+            if (c == '"')
+            {
+                // Doubled quote stays inside the field
+                if (p + 1 < to && p[1] == '"')
+                    ++p;
+                else
+                    field = AfterQuote;
+            }
+            break;
+
+        case AfterQuote:
+            if (c == '\n')
+                field = FieldStart;
+            else if (c == '\r' && p + 1 < to && p[1] == '\n')
+            {
+                field = FieldStart;
+                ++p;
+            }
+            else if (atDelimiter(p))
+            {
+                field = FieldStart;
+                p += delimSize - 1;
+            }
+            else
+                field = Malformed; // splitRecord drops the rest of the line
+            break;
+
+        case Malformed:
+            if (c == '\n')
+                field = FieldStart;
+            break;
+        }
+    }
+
+    return field == Quoted ? InQuotes : RecordStart;
+}
+
+int CSVImporter::effectiveThreadCount() const
+{
+    return m_threadCount > 0 ? m_threadCount : qMax(1, QThread::idealThreadCount());
+}
+
+void CSVImporter::mergeChunk(const ParsedChunk &chunk)
+{
+    m_stats.rowsRead += chunk.rowsRead;
+    m_stats.rowsRejected += chunk.rowsRejected;
+
+    for (const QString &rejected : chunk.rejectedRows)
+    {
+        if (m_rejectedRows.size() >= 100)
+            break;
+        m_rejectedRows.append(rejected);
+    }
+}
+
+QString CSVImporter::fieldToString(const FieldRef &field) const
+{
+    if (!field.hasEscapedQuotes)
+        return QString::fromUtf8(field.data, field.size);
+
+    // Collapse "" into "
+    QByteArray unescaped;
+    unescaped.reserve(field.size);
+    for (int i = 0; i < field.size; ++i)
+    {
+        const char ch = field.data[i];
+        unescaped.append(ch);
+        if (ch == '"' && i + 1 < field.size && field.data[i + 1] == '"')
+            ++i;
+    }
+
+    return QString::fromUtf8(unescaped);
+}
+
+bool CSVImporter::isValidNpm(const QString &npm) const
+{
+    if (npm.isEmpty())
+        return false;
+
+    for (const QChar &ch : npm)
+    {
+        if (!ch.isDigit())
+            return false;
+    }
+
+    return true;
+}
+
+void CSVImporter::rejectRow(ParsedChunk &out, qint64 line, const QString &reason)
+{
+    ++out.rowsRejected;
+
+    if (out.rejectedRows.size() < 100)
+        out.rejectedRows.append(QString("Line %1: %2").arg(line).arg(reason));
+}
+
+/*************** end of private methods ***************/
@@ -0,0 +1,181 @@
+#ifndef CSVIMPORTER_H
+#define CSVIMPORTER_H
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QStringList>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include "helpers/Environments.h"
+#include "helpers/databasemanager.h"
+
+class CSVImporter : public QObject
+{
+    Q_OBJECT
+public:
+    // Summary of the last import/parse run
+    struct ImportStats
+    {
+        qint64 rowsRead = 0;      // data records found in the file (header excluded)
+        qint64 rowsInserted = 0;  // rows written to the database (inserted or updated)
+        qint64 rowsSkipped = 0;   // rows ignored because of the conflict policy
+        qint64 rowsRejected = 0;  // rows failing validation (empty nama/kelas, non-digit npm, ...)
+        qint64 parseMs = 0;       // time spent parsing
+        qint64 insertMs = 0;      // time spent in the database
+        qint64 elapsedMs = 0;     // wall time of the whole run
+    };
+
+    explicit CSVImporter(QObject *parent = nullptr);
+
+    // Set the delimiter (default is comma, same as CSVExporter)
+    void setDelimiter(const QString& delimiter);
+
+    // Set the input file path
+    void setFilePath(const QString& filePath);
+
+    // Whether the first record is a header row (default: true).
+    // With a header, columns are matched by name (nama, npm, kelas; id is ignored).
+    // Without a header, 4 columns are read as CSVExporter's id;nama;npm;kelas layout
+    // and 3 columns as nama;npm;kelas.
+    void setHasHeader(bool hasHeader);
+
+    // Number of rows bound and written per batch (default: 50000)
+    void setBatchSize(int size);
+
+    // What to do with rows whose nama already exists (default: skip them)
+    void setConflictPolicy(DatabaseManager::ConflictPolicy policy);
+
+    // Number of parser threads (default: 0 = QThread::idealThreadCount()).
+    // 1 parses on the calling thread only, which is also the reference path
+    // for checking the parallel parser. Files under 1 MB are always parsed
+    // on the calling thread.
+    void setThreadCount(int count);
+
+    // Import the file into tableName.
+    // Parsing runs on the parser threads, the calling thread is the single writer
+    // and commits the parsed batches in file order.
+    // AbortOnConflict runs the whole import in one transaction (all or nothing),
+    // the other policies commit after every batch.
+    // Returns true if successful, false otherwise
+    bool importData(DatabaseManager *dbManager, const QString &tableName = "mahasiswa");
+
+    // Parse and validate the file without touching the database
+    bool parseData(QVector<StudentsDataStruct> &rows);
+
+    // Statistics of the last run
+    ImportStats getLastStats() const;
+
+    // Rejected rows of the last run ("Line N: reason"), capped at 100 entries
+    QStringList getRejectedRows() const;
+
+    // Get the last error message
+    QString getLastError() const;
+
+signals:
+    // Emitted after every batch with the number of records processed so far
+    void importProgress(qint64 rowsProcessed);
+
+private:
+    // A field inside the mapped file, decoded to QString only when needed
+    struct FieldRef
+    {
+        const char *data;
+        int size;
+        bool hasEscapedQuotes;
+        bool quoted;
+    };
+
+    // Position of the columns we need inside a record
+    struct ColumnMap
+    {
+        int nama = -1;
+        int npm = -1;
+        int kelas = -1;
+        int required = 0; // minimum field count of a record
+    };
+
+    // A slice of the file that starts and ends on record boundaries
+    struct Chunk
+    {
+        const char *begin;
+        const char *end;
+        qint64 firstLine;
+    };
+
+    // Where a slice starting right after a line break can be: at a record start
+    // or inside a quoted field that spans the line break
+    enum SliceState { RecordStart, InQuotes };
+
+    // Pre-scan of one slice: the state at its end for both possible start states
+    struct SliceScan
+    {
+        SliceState endFromRecordStart = RecordStart;
+        SliceState endFromInQuotes = InQuotes;
+        qint64 newlines = 0;
+    };
+
+    // Output of one parser run, merged into m_stats by the writer
+    struct ParsedChunk
+    {
+        QVector<StudentsDataStruct> rows;
+        qint64 rowsRead = 0;
+        qint64 rowsRejected = 0;
+        QStringList rejectedRows;
+        qint64 nextLine = 0;
+    };
+
+    QString m_delimiter;
+    QByteArray m_delimiterUtf8;
+    QString m_filePath;
+    QString m_lastError;
+    QStringList m_rejectedRows;
+    ImportStats m_stats;
+    int m_batchSize;
+    int m_threadCount;
+    bool m_hasHeader;
+    DatabaseManager::ConflictPolicy m_conflictPolicy;
+
+    // Map the input file (falls back to reading it when mapping is not possible)
+    bool openInput(QFile &file, QByteArray &fallback, const char *&begin, const char *&end);
+
+    // Read the header (or peek the first record) and locate the columns
+    bool resolveColumns(const char *&pos, const char *end, ColumnMap &map, qint64 &line);
+
+    // Split one record starting at pos, returns the start of the next record
+    const char *splitRecord(const char *pos, const char *end,
+                            QVector<FieldRef> &fields, qint64 &line, bool &wellFormed) const;
+
+    // Parse up to maxRows records into out (invalid ones are rejected), returns where parsing stopped
+    const char *parseRecords(const char *pos, const char *end, const ColumnMap &map,
+                             int maxRows, ParsedChunk &out, qint64 &line) const;
+
+    // Parse a whole chunk, runs on a parser thread
+    ParsedChunk parseChunk(const Chunk &chunk, const ColumnMap &map) const;
+
+    // Cut [begin, end) into about count chunks whose edges fall on record boundaries.
+    // Nominal edges are moved to just after a line break, where a record either starts
+    // or a quoted field continues. A parallel pre-scan runs the splitRecord() state
+    // machine over every slice from both start states, then the states are chained
+    // in file order and only the edges at a record start are kept.
+    QVector<Chunk> splitChunks(const char *begin, const char *end, qint64 firstLine,
+                               int count, QThreadPool *pool) const;
+
+    // State at `to` when [from, to) is parsed from `state` (same rules as splitRecord)
+    SliceState scanSlice(const char *from, const char *to, SliceState state) const;
+
+    int effectiveThreadCount() const;
+    void mergeChunk(const ParsedChunk &chunk);
+
+    // Decode a field, collapsing doubled quotes
+    QString fieldToString(const FieldRef &field) const;
+
+    // Same rule as MainWindow's npmValidator (\d+)
+    bool isValidNpm(const QString &npm) const;
+
+    static void rejectRow(ParsedChunk &out, qint64 line, const QString &reason);
+};
+
+#endif // CSVIMPORTER_H
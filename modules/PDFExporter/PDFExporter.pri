@@ -1,3 +1,17 @@
-SOURCES += $$PWD/pdfexporter.cpp
-HEADERS += $$PWD/pdfexporter.h
-INCLUDEPATH += $$PWD
\ No newline at end of file
+SOURCES += $$PWD/htmlrowtemplate.cpp \
+    $$PWD/pdfexporter.cpp \
+    $$PWD/pdfexportjob.cpp \
+    $$PWD/reportbatchjob.cpp \
+    $$PWD/reportcache.cpp \
+    $$PWD/reportlayout.cpp \
+    $$PWD/reporttablerenderer.cpp \
+    $$PWD/reporttextcache.cpp
+HEADERS += $$PWD/htmlrowtemplate.h \
+    $$PWD/pdfexporter.h \
+    $$PWD/pdfexportjob.h \
+    $$PWD/reportbatchjob.h \
+    $$PWD/reportcache.h \
+    $$PWD/reportlayout.h \
+    $$PWD/reporttablerenderer.h \
+    $$PWD/reporttextcache.h
+INCLUDEPATH += $$PWD
@@ -0,0 +1,7 @@
+# Preview dialogs, need QtWidgets and QtPrintSupport (GUI application only)
+SOURCES += $$PWD/pdfexporterpreview.cpp \
+    $$PWD/reportpreviewdialog.cpp \
+    $$PWD/reportpreviewwidget.cpp
+HEADERS += $$PWD/reportpreviewdialog.h \
+    $$PWD/reportpreviewwidget.h
+INCLUDEPATH += $$PWD
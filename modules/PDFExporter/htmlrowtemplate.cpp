@@ -0,0 +1,128 @@
+#include "htmlrowtemplate.h"
+
+HtmlRowTemplate::HtmlRowTemplate()
+    : m_zebraEvenColor("#FFFFFF")
+    , m_zebraOddColor("#F0F0F0")
+{
+}
+
+bool HtmlRowTemplate::compile(const QString &source)
+{
+    m_literals.clear();
+    m_segments.clear();
+    m_lastError.clear();
+
+    qsizetype pos = 0;
+    while (pos < source.size()) {
+        const qsizetype open = source.indexOf(QLatin1String("{{"), pos);
+        const qsizetype literalEnd = (open < 0) ? source.size() : open;
+
+        if (literalEnd > pos) {
+            m_segments.append({Literal, int(m_literals.size()), int(literalEnd - pos)});
+            m_literals += QStringView(source).mid(pos, literalEnd - pos);
+        }
+
+        if (open < 0) {
+            break;
+        }
+
+        const qsizetype close = source.indexOf(QLatin1String("}}"), open + 2);
+        if (close < 0) {
+            m_lastError = QString("Unterminated placeholder at position %1").arg(open);
+            return false;
+        }
+
+        const QStringView name = QStringView(source).mid(open + 2, close - open - 2).trimmed();
+        bool isColumn = false;
+        const int column = name.toInt(&isColumn);
+
+        if (isColumn && column >= 0) {
+            m_segments.append({Cell, column, 0});
+        } else if (name == QLatin1String("zebra")) {
+            m_segments.append({Zebra, 0, 0});
+        } else if (name == QLatin1String("row")) {
+            m_segments.append({RowNumber, 0, 0});
+        } else {
+            m_lastError = "Unknown placeholder {{" + name.toString() + "}}";
+            return false;
+        }
+
+        pos = close + 2;
+    }
+
+    return true;
+}
+
+QString HtmlRowTemplate::defaultSource(int columns)
+{
+    QString source = QStringLiteral("<tr style='background-color: {{zebra}};'>");
+    for (int i = 0; i < columns; ++i) {
+        source += QStringLiteral("<td>{{") + QString::number(i) + QStringLiteral("}}</td>");
+    }
+    source += QStringLiteral("</tr>");
+    return source;
+}
+
+void HtmlRowTemplate::setZebraColors(const QString &evenColor, const QString &oddColor)
+{
+    m_zebraEvenColor = evenColor;
+    m_zebraOddColor = oddColor;
+}
+
+void HtmlRowTemplate::appendRow(QString &out, const QStringList &cells, qsizetype rowIndex) const
+{
+    for (const Segment &segment : m_segments) {
+        switch (segment.kind) {
+        case Literal:
+            out += QStringView(m_literals).mid(segment.value, segment.length);
+            break;
+        case Cell:
+            // Handle column count mismatch gracefully, missing cells stay empty
+            if (segment.value < cells.size()) {
+                appendEscaped(out, cells[segment.value]);
+            }
+            break;
+        case Zebra:
+            out += (rowIndex % 2 == 0) ? m_zebraEvenColor : m_zebraOddColor;
+            break;
+        case RowNumber:
+            out += QString::number(rowIndex + 1);
+            break;
+        }
+    }
+}
+
+qsizetype HtmlRowTemplate::fixedSize() const
+{
+    return m_literals.size() + qMax(m_zebraEvenColor.size(), m_zebraOddColor.size());
+}
+
+QString HtmlRowTemplate::getLastError() const
+{
+    return m_lastError;
+}
+
+void HtmlRowTemplate::appendEscaped(QString &out, QStringView text)
+{
+    // Copy runs of plain characters in one go, stop only at the five specials
+    qsizetype runStart = 0;
+    const qsizetype size = text.size();
+
+    for (qsizetype i = 0; i < size; ++i) {
+        QLatin1String entity;
+        switch (text[i].unicode()) {
+        case '&':  entity = QLatin1String("&amp;"); break;
+        case '<':  entity = QLatin1String("&lt;"); break;
+        case '>':  entity = QLatin1String("&gt;"); break;
+        case '"':  entity = QLatin1String("&quot;"); break;
+        case '\'': entity = QLatin1String("&#39;"); break;
+        default:   continue;
+        }
+
+        out += text.mid(runStart, i - runStart);
+        out += entity;
+        runStart = i + 1;
+    }
+
+    out += text.mid(runStart);
+}
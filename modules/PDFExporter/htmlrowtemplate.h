@@ -0,0 +1,54 @@
+#ifndef HTMLROWTEMPLATE_H
+#define HTMLROWTEMPLATE_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+// A table row template compiled once into literal and placeholder segments,
+// so expanding a row is a few appends instead of arg()/replace() passes.
+//   {{0}}, {{1}}, ...  cell of that column, HTML escaped (missing cells are empty)
+//   {{zebra}}          background colour of the row (even/odd)
+//   {{row}}            1-based row number
+class HtmlRowTemplate
+{
+public:
+    HtmlRowTemplate();
+
+    // Returns false (see getLastError()) on an unknown or unterminated placeholder
+    bool compile(const QString &source);
+
+    // <tr style='background-color: {{zebra}};'><td>{{0}}</td>...</tr>
+    static QString defaultSource(int columns);
+
+    void setZebraColors(const QString &evenColor, const QString &oddColor);
+
+    void appendRow(QString &out, const QStringList &cells, qsizetype rowIndex) const;
+
+    // Characters of a row without the cell values, for reserving output
+    qsizetype fixedSize() const;
+
+    QString getLastError() const;
+
+    // Escape &, <, >, " and ' in one pass over text
+    static void appendEscaped(QString &out, QStringView text);
+
+private:
+    enum SegmentKind { Literal, Cell, Zebra, RowNumber };
+
+    struct Segment
+    {
+        SegmentKind kind;
+        int value;   // column for Cell, offset into m_literals for Literal
+        int length;  // Literal only
+    };
+
+    QString m_literals; // all literal text back to back
+    QVector<Segment> m_segments;
+    QString m_zebraEvenColor;
+    QString m_zebraOddColor;
+    QString m_lastError;
+};
+
+#endif // HTMLROWTEMPLATE_H
@@ -1,4 +1,33 @@
 #include "pdfexporter.h"
+#include "helpers/logging.h"
+#include "helpers/perfcounters.h"
+#include "helpers/tracer.h"
+#include <QStringBuilder>
+#include <QThread>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QPdfWriter>
+#include <QCryptographicHash>
+#include <QThreadPool>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+// Below this row count splitting the layout over threads doesn't pay off
+constexpr qsizetype PARALLEL_LAYOUT_MIN_ROWS = 5000;
+
+// Same as QPrinter::HighResolution
+constexpr int PDF_RESOLUTION = 1200;
+
+// Bump when the output for the same inputs changes, old cache entries are then never hit
+constexpr int REPORT_CACHE_VERSION = 1;
+
+void addHashField(QCryptographicHash &hash, const QString &text)
+{
+    hash.addData(QByteArrayView(reinterpret_cast<const char *>(text.utf16()), text.size() * sizeof(QChar)));
+    hash.addData(QByteArrayView("\0\0", 2)); // keeps "ab","c" apart from "a","bc"
+}
+}
 
 PDFExporter::PDFExporter(QObject *parent)
     : QObject{parent}
@@ -6,14 +35,94 @@ PDFExporter::PDFExporter(QObject *parent)
     , m_dateFormat("dd MMMM yyyy, hh:mm:ss")
     , m_pageSize(QPageSize::A4)
     , m_orientation(QPageLayout::Portrait)
+    , m_rowCount(0)
     , m_headerColor("#D3D3D3")
     , m_zebraEvenColor("#FFFFFF")
     , m_zebraOddColor("#F0F0F0")
+    , m_renderBackend(AutoBackend)
+    , m_layoutThreadCount(0)
+    , m_textCacheSize(4096)
+    , m_reportCache(nullptr)
+    , m_cancelFlag(nullptr)
+    , m_streamExpectedRows(0)
+    , m_lastExportPageCount(0)
+    , m_lastExportRowCount(0)
 {
 }
 
 PDFExporter::~PDFExporter()
 {
+    // A stream that was never closed is unfinished: discard it, an existing
+    // file under the same name is left untouched
+    if (isExportOpen()) {
+        cancelExport();
+    }
+}
+
+void PDFExporter::setRenderBackend(RenderBackend backend)
+{
+    m_renderBackend = backend;
+}
+
+void PDFExporter::setLayoutThreadCount(int count)
+{
+    m_layoutThreadCount = qMax(0, count);
+}
+
+void PDFExporter::setTextCacheSize(int entries)
+{
+    m_textCacheSize = qMax(0, entries);
+}
+
+void PDFExporter::setCancelFlag(const std::atomic<bool> *flag)
+{
+    m_cancelFlag = flag;
+}
+
+bool PDFExporter::isCancelled() const
+{
+    return m_cancelFlag && m_cancelFlag->load(std::memory_order_relaxed);
+}
+
+void PDFExporter::setReportCache(ReportCache *cache)
+{
+    m_reportCache = cache;
+}
+
+QString PDFExporter::contentHash() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+
+    // The shown date is hashed as text: the key is taken before rendering, so it
+    // never names an older date than the file stored under it
+    addHashField(hash, QString::number(REPORT_CACHE_VERSION));
+    addHashField(hash, m_title);
+    addHashField(hash, m_showDate ? generatedDateText() : QString());
+    addHashField(hash, QString::number(int(m_pageSize)) + '/' + QString::number(int(m_orientation)));
+    addHashField(hash, QString::number(int(usePainterBackend())));
+    addHashField(hash, m_headerColor + '/' + m_zebraEvenColor + '/' + m_zebraOddColor);
+    addHashField(hash, m_customHtml);
+    addHashField(hash, m_prefixHtml);
+    addHashField(hash, m_suffixHtml);
+    addHashField(hash, m_rowTemplate);
+
+    for (const QString &header : m_headers) {
+        addHashField(hash, header);
+    }
+
+    const qsizetype rows = tableRowCount();
+    addHashField(hash, QString::number(rows));
+
+    QStringList cells;
+    for (qsizetype i = 0; i < rows; ++i) {
+        cellsAt(i, cells);
+        for (const QString &cell : std::as_const(cells)) {
+            addHashField(hash, cell);
+        }
+        hash.addData(QByteArrayView("\n", 1));
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
 }
 
 void PDFExporter::setTitle(const QString &title)
@@ -49,6 +158,8 @@ void PDFExporter::setTableHeaders(const QStringList &headers)
 void PDFExporter::setTableData(const QList<QStringList> &data)
 {
     m_data = data;
+    m_rowCount = 0;
+    m_rowWriter = nullptr;
 }
 
 void PDFExporter::setHeaderColor(const QString &color)
@@ -62,6 +173,18 @@ void PDFExporter::setZebraColors(const QString &evenColor, const QString &oddCol
     m_zebraOddColor = oddColor;
 }
 
+bool PDFExporter::setRowTemplate(const QString &rowTemplate)
+{
+    HtmlRowTemplate compiled;
+    if (!rowTemplate.isEmpty() && !compiled.compile(rowTemplate)) {
+        qCWarning(lcPdf) << "PDFExporter: Invalid row template:" << compiled.getLastError();
+        return false;
+    }
+
+    m_rowTemplate = rowTemplate;
+    return true;
+}
+
 void PDFExporter::setCustomHtml(const QString &html)
 {
     m_customHtml = html;
@@ -77,222 +200,626 @@ void PDFExporter::setSuffixHtml(const QString &html)
     m_suffixHtml = html;
 }
 
-QString PDFExporter::escapeHtml(const QString &text) const
+bool PDFExporter::hasTableData() const
+{
+    return !m_data.isEmpty() || (m_rowWriter && m_rowCount > 0);
+}
+
+QString PDFExporter::generatedDateText() const
+{
+    return QDateTime::currentDateTime().toString(m_dateFormat);
+}
+
+QString PDFExporter::escapeHtml(const QString &text)
 {
-    QString escaped = text;
-    escaped.replace("&", "&amp;");
-    escaped.replace("<", "&lt;");
-    escaped.replace(">", "&gt;");
-    escaped.replace("\"", "&quot;");
-    escaped.replace("'", "&#39;");
+    QString escaped;
+    escaped.reserve(text.size() + 16);
+    HtmlRowTemplate::appendEscaped(escaped, text);
     return escaped;
 }
 
 QString PDFExporter::generateHtml()
 {
+    TRACE_SPAN("pdf", "PDFExporter::generateHtml");
+
+    QElapsedTimer timer;
+    timer.start();
+
     QString html;
+    html.reserve(estimateHtmlSize());
 
     // Start HTML with proper styling
-    html += "<html><head><style>";
-    html += "body { font-family: Arial, sans-serif; }";
-    html += "h1 { color: #333333; margin-bottom: 10px; }";
-    html += "p { color: #333333; margin: 5px 0; }";
-    html += "table { width: 100%; border-collapse: collapse; margin-top: 15px; table-layout: fixed; }";
-    html += "th, td { border: 1px solid #000000; padding: 8px; text-align: left; word-wrap: break-word; }";
-    html += "th { font-weight: bold; }";
-    html += "hr { border: 1px solid #CCCCCC; margin: 15px 0; }";
-    html += "</style></head><body>";
+    html += QLatin1String("<html><head><style>"
+                          "body { font-family: Arial, sans-serif; }"
+                          "h1 { color: #333333; margin-bottom: 10px; }"
+                          "p { color: #333333; margin: 5px 0; }"
+                          "table { width: 100%; border-collapse: collapse; margin-top: 15px; table-layout: fixed; }"
+                          "th, td { border: 1px solid #000000; padding: 8px; text-align: left; word-wrap: break-word; }"
+                          "th { font-weight: bold; }"
+                          "hr { border: 1px solid #CCCCCC; margin: 15px 0; }"
+                          "</style></head><body>");
 
     // Title
     if (!m_title.isEmpty()) {
-        html += QString("<h1>%1</h1>").arg(escapeHtml(m_title));
+        html += QLatin1String("<h1>") % escapeHtml(m_title) % QLatin1String("</h1>");
     }
 
     // Date
     if (m_showDate) {
-        QString currentDate = QDateTime::currentDateTime().toString(m_dateFormat);
-        html += QString("<p>Tanggal Dibuat: %1</p>").arg(currentDate);
+        html += QLatin1String("<p>Tanggal Dibuat: ")
+                % generatedDateText()
+                % QLatin1String("</p>");
     }
 
-    html += "<hr/>";
+    html += QLatin1String("<hr/>");
 
     // Prefix HTML
-    if (!m_prefixHtml.isEmpty()) {
-        html += m_prefixHtml;
-    }
+    html += m_prefixHtml;
 
     // Main content: Custom HTML or Table
     if (!m_customHtml.isEmpty()) {
         html += m_customHtml;
-    } else if (!m_headers.isEmpty() && !m_data.isEmpty()) {
-        html += generateTableHtml();
+    } else if (!m_headers.isEmpty() && hasTableData()) {
+        appendTableHtml(html);
     }
 
     // Suffix HTML
-    if (!m_suffixHtml.isEmpty()) {
-        html += m_suffixHtml;
-    }
+    html += m_suffixHtml;
+
+    html += QLatin1String("</body></html>");
 
-    html += "</body></html>";
+    const qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+    const double megabytes = html.size() * sizeof(QChar) / (1024.0 * 1024.0);
+    qCDebug(lcPdf) << "PDFExporter: generated" << megabytes << "MB of HTML in" << elapsed << "ms ("
+                   << megabytes * 1000.0 / elapsed << "MB/s )";
 
     m_lastGeneratedHtml = html;
     return html;
 }
 
-QString PDFExporter::generateTableHtml()
+qsizetype PDFExporter::estimateHtmlSize() const
+{
+    qsizetype size = 1024 + m_title.size() + m_prefixHtml.size() + m_suffixHtml.size() + m_customHtml.size();
+
+    if (!m_customHtml.isEmpty() || m_headers.isEmpty()) {
+        return size;
+    }
+
+    HtmlRowTemplate rowTemplate;
+    if (!compileRowTemplate(rowTemplate)) {
+        return size;
+    }
+
+    // Average cell text from the first rows, plus a little for escaping
+    const qsizetype rows = tableRowCount();
+    const qsizetype sampleRows = qMin<qsizetype>(rows, 64);
+    qsizetype sampleChars = 0;
+    QStringList cells;
+    for (qsizetype i = 0; i < sampleRows; ++i) {
+        cellsAt(i, cells);
+        for (const QString &cell : std::as_const(cells)) {
+            sampleChars += cell.size();
+        }
+    }
+
+    const qsizetype rowText = sampleRows > 0 ? sampleChars / sampleRows : 0;
+    size += 64 * m_headers.size(); // header row
+    size += rows * (rowTemplate.fixedSize() + rowText + rowText / 8);
+    return size;
+}
+
+bool PDFExporter::compileRowTemplate(HtmlRowTemplate &rowTemplate) const
 {
-    QString tableHtml;
+    rowTemplate.setZebraColors(m_zebraEvenColor, m_zebraOddColor);
+    return rowTemplate.compile(m_rowTemplate.isEmpty() ? HtmlRowTemplate::defaultSource(m_headers.size())
+                                                       : m_rowTemplate);
+}
+
+void PDFExporter::appendTableHtml(QString &html) const
+{
+    HtmlRowTemplate rowTemplate;
+    if (!compileRowTemplate(rowTemplate)) {
+        qCWarning(lcPdf) << "PDFExporter: Invalid row template:" << rowTemplate.getLastError();
+        return;
+    }
 
-    tableHtml += "<table width='100%'>";
+    html += QLatin1String("<table width='100%'>");
 
     // Header row
     if (!m_headers.isEmpty()) {
-        tableHtml += QString("<tr style='background-color: %1;'>").arg(m_headerColor);
+        html += QLatin1String("<tr style='background-color: ") % m_headerColor % QLatin1String(";'>");
         for (const QString &header : m_headers) {
-            tableHtml += QString("<th>%1</th>").arg(escapeHtml(header.toUpper()));
+            html += QLatin1String("<th>");
+            HtmlRowTemplate::appendEscaped(html, header.toUpper());
+            html += QLatin1String("</th>");
         }
-        tableHtml += "</tr>";
+        html += QLatin1String("</tr>");
     }
 
-    // Data rows with zebra striping
-    int rowCount = 0;
-    for (const QStringList &row : m_data) {
-        QString rowColor = (rowCount % 2 == 0) ? m_zebraEvenColor : m_zebraOddColor;
-        tableHtml += QString("<tr style='background-color: %1;'>").arg(rowColor);
+    // Data rows with zebra striping, expanded from the compiled template
+    QStringList cells;
+    cells.reserve(m_headers.size());
+    const qsizetype rows = tableRowCount();
+    for (qsizetype i = 0; i < rows; ++i) {
+        cellsAt(i, cells);
+        rowTemplate.appendRow(html, cells, i);
+    }
 
-        // Handle column count mismatch gracefully
-        int colCount = qMin(row.size(), m_headers.size());
-        for (int i = 0; i < colCount; ++i) {
-            tableHtml += QString("<td>%1</td>").arg(escapeHtml(row[i]));
-        }
+    html += QLatin1String("</table>");
+}
 
-        // Fill missing columns with empty cells
-        for (int i = colCount; i < m_headers.size(); ++i) {
-            tableHtml += "<td></td>";
+bool PDFExporter::exportToPdf(const QString &filePath)
+{
+    TRACE_SPAN("pdf", "PDFExporter::exportToPdf");
+
+    if (filePath.isEmpty()) {
+        qCWarning(lcPdf) << "PDFExporter: Empty file path provided";
+        return false;
+    }
+
+    emit exportStarted();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Unchanged report: copy the PDF generated last time
+    QString cacheKey;
+    if (m_reportCache) {
+        cacheKey = contentHash();
+        if (m_reportCache->fetchPdf(cacheKey, filePath)) {
+            qCDebug(lcPdf) << "PDFExporter: PDF served from the report cache";
+            PerfCounters::recordExport("pdf", tableRowCount(), QFileInfo(filePath).size(), timer.elapsed());
+            emit exportFinished(true, filePath);
+            return true;
         }
+    }
+
+    // Written to a temporary file and renamed on commit, so an existing
+    // report is never left half overwritten
+    QSaveFile file(filePath);
+    bool success = file.open(QIODevice::WriteOnly) && exportToDevice(&file);
+
+    if (success) {
+        success = file.commit();
+    } else {
+        file.cancelWriting();
+    }
 
-        tableHtml += "</tr>";
-        rowCount++;
+    if (success && m_reportCache) {
+        m_reportCache->storePdf(cacheKey, filePath);
     }
 
-    tableHtml += "</table>";
+    qCDebug(lcPdf) << "PDFExporter: PDF exported to" << filePath << (success ? "" : "(failed)");
 
-    return tableHtml;
+    if (success) {
+        PerfCounters::recordExport("pdf", tableRowCount(), QFileInfo(filePath).size(), timer.elapsed());
+    }
+
+    emit exportFinished(success, filePath);
+
+    return success;
+}
+
+bool PDFExporter::exportToHtml(const QString &filePath)
+{
+    TRACE_SPAN("pdf", "PDFExporter::exportToHtml");
+
+    if (filePath.isEmpty()) {
+        qCWarning(lcPdf) << "PDFExporter: Empty file path provided";
+        return false;
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcPdf) << "PDFExporter: Cannot open" << filePath << ":" << file.errorString();
+        return false;
+    }
+
+    const QByteArray utf8 = generateHtml().toUtf8();
+    if (file.write(utf8) != utf8.size()) {
+        file.cancelWriting();
+        return false;
+    }
+
+    qCDebug(lcPdf) << "PDFExporter: HTML exported to" << filePath;
+    return file.commit();
 }
 
-bool PDFExporter::preview(QWidget *parent)
+bool PDFExporter::exportToDevice(QIODevice *device)
 {
-    // Generate HTML content
-    QString htmlContent = generateHtml();
+    TRACE_SPAN("pdf", "PDFExporter::exportToDevice");
+
+    QPdfWriter writer(device);
+    writer.setResolution(PDF_RESOLUTION);
+    writer.setPageLayout(pdfPageLayout());
+    writer.setTitle(m_title);
+
+    if (usePainterBackend()) {
+        return renderTable(&writer);
+    }
 
-    // Create QTextDocument
     QTextDocument doc;
-    doc.setHtml(htmlContent);
+    doc.setHtml(generateHtml());
+    doc.print(&writer);
 
-    // Setup printer for preview
-    QPrinter printer(QPrinter::HighResolution);
-    printer.setPageSize(QPageSize(m_pageSize));
-    printer.setPageOrientation(m_orientation);
+    emit pageFinished(doc.pageCount(), tableRowCount(), tableRowCount());
+    return !isCancelled();
+}
 
-    // Create preview dialog
-    QPrintPreviewDialog previewDialog(&printer, parent);
-    previewDialog.setWindowTitle(m_title.isEmpty() ? "Preview PDF" : "Preview: " + m_title);
+std::shared_ptr<ReportLayout> PDFExporter::createLayout() const
+{
+    TRACE_SPAN("pdf", "PDFExporter::createLayout");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // The layout keeps its own (implicitly shared) copy of the rows
+    ReportLayout::CellSource cells;
+    if (m_rowWriter) {
+        cells = [rowWriter = m_rowWriter](qsizetype index, QStringList &out) {
+            StringListCellWriter writer(out);
+            rowWriter(index, writer);
+            writer.finish();
+        };
+    } else {
+        cells = [data = m_data](qsizetype index, QStringList &out) {
+            out = data.at(index);
+        };
+    }
 
-    // Connect paint signal
-    QObject::connect(&previewDialog, &QPrintPreviewDialog::paintRequested,
-                     [&doc](QPrinter *currentPrinter) {
-                         doc.print(currentPrinter);
-                     });
+    auto layout = std::make_shared<ReportLayout>(pdfPageLayout(), PDF_RESOLUTION, tableRowCount(), std::move(cells));
+    configureRenderer(layout->renderer());
 
-    qDebug() << "PDFExporter: Displaying preview...";
+    const int threads = layoutThreadCount();
+    if (threads > 1 && tableRowCount() >= PARALLEL_LAYOUT_MIN_ROWS) {
+        layout->setup();
+        layout->paginate(measureRowsParallel(layout->renderer(), threads));
+    } else {
+        layout->paginate();
+    }
 
-    // Show preview dialog (blocking)
-    int result = previewDialog.exec();
+    qCDebug(lcPdf) << "PDFExporter: paginated" << layout->rowCount() << "rows into" << layout->pageCount()
+                   << "pages in" << timer.elapsed() << "ms";
 
-    emit previewClosed();
+    return layout;
+}
 
-    return (result == QDialog::Accepted);
+QPageLayout PDFExporter::pdfPageLayout() const
+{
+    return QPageLayout(QPageSize(m_pageSize), m_orientation,
+                       QMarginsF(10, 10, 10, 10), QPageLayout::Millimeter);
 }
 
-bool PDFExporter::exportToPdf(const QString &filePath)
+bool PDFExporter::usePainterBackend() const
+{
+    if (m_renderBackend == HtmlBackend) {
+        return false;
+    }
+
+    if (m_renderBackend == PainterBackend) {
+        return true;
+    }
+
+    // HTML fragments and row templates can only be laid out by QTextDocument
+    return m_customHtml.isEmpty() && m_prefixHtml.isEmpty() && m_suffixHtml.isEmpty()
+           && m_rowTemplate.isEmpty();
+}
+
+void PDFExporter::configureRenderer(ReportTableRenderer &renderer) const
+{
+    renderer.setTitle(m_title);
+    if (m_showDate) {
+        renderer.setSubtitle(QString("Tanggal Dibuat: %1").arg(generatedDateText()));
+    }
+    renderer.setHeaders(m_headers);
+    renderer.setHeaderColor(QColor(m_headerColor));
+    renderer.setZebraColors(QColor(m_zebraEvenColor), QColor(m_zebraOddColor));
+    renderer.setTextCacheSize(m_textCacheSize);
+}
+
+bool PDFExporter::renderTable(QPagedPaintDevice *device)
 {
+    TRACE_SPAN("pdf", "PDFExporter::renderTable");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ReportTableRenderer renderer;
+    configureRenderer(renderer);
+
+    if (!renderer.begin(device)) {
+        qCWarning(lcPdf) << "PDFExporter: Cannot start painting on the output device";
+        return false;
+    }
+
+    bool success = true;
+    const int threads = layoutThreadCount();
+    const qsizetype rows = tableRowCount();
+
+    // Large reports: measure every row on the pool first, then paint in order.
+    // Page breaks follow from the known heights, same as measuring while painting.
+    QVector<int> heights;
+    if (threads > 1 && rows >= PARALLEL_LAYOUT_MIN_ROWS) {
+        QElapsedTimer layoutTimer;
+        layoutTimer.start();
+        heights = measureRowsParallel(renderer, threads);
+        qCDebug(lcPdf) << "PDFExporter: measured" << rows << "rows on" << threads << "threads in"
+                       << layoutTimer.elapsed() << "ms";
+    }
+
+    QStringList cells;
+    cells.reserve(m_headers.size());
+    int page = renderer.pageCount();
+
+    for (qsizetype i = 0; i < rows; ++i) {
+        if (isCancelled()) {
+            qCDebug(lcPdf) << "PDFExporter: rendering cancelled at row" << i;
+            success = false;
+            break;
+        }
+
+        cellsAt(i, cells);
+        success = heights.isEmpty() ? renderer.addRow(cells) : renderer.addRow(cells, heights[i]);
+        if (!success) {
+            break;
+        }
+
+        // Row i opened a new page, the previous one is done
+        if (renderer.pageCount() != page) {
+            emit pageFinished(page, i, rows);
+            page = renderer.pageCount();
+        }
+    }
+
+    if (success) {
+        emit pageFinished(page, rows, rows);
+    }
+
+    success = renderer.end() && success;
+    m_lastExportRowCount = renderer.rowCount();
+    m_lastExportPageCount = renderer.pageCount();
+
+    const qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+    qCDebug(lcPdf) << "PDFExporter: painted" << renderer.rowCount() << "rows on" << renderer.pageCount()
+                   << "pages in" << elapsed << "ms (" << renderer.pageCount() * 1000.0 / elapsed << "pages/s)";
+
+    if (m_textCacheSize > 0) {
+        const ReportTextCache &cache = renderer.textCache();
+        const qint64 lookups = qMax<qint64>(1, cache.hits() + cache.misses());
+        qCDebug(lcPdf) << "PDFExporter: text cache" << cache.hits() << "hits," << cache.misses() << "misses ("
+                       << cache.hits() * 100.0 / lookups << "% ), " << cache.size() << "entries";
+    } else {
+        qCDebug(lcPdf) << "PDFExporter: text cache disabled";
+    }
+
+    return success;
+}
+
+bool PDFExporter::openExport(const QString &filePath, qsizetype expectedRows)
+{
+    TRACE_SPAN("pdf", "PDFExporter::openExport");
+
+    if (isExportOpen()) {
+        qCWarning(lcPdf) << "PDFExporter: An export is already open";
+        return false;
+    }
+
     if (filePath.isEmpty()) {
-        qWarning() << "PDFExporter: Empty file path provided";
+        qCWarning(lcPdf) << "PDFExporter: Empty file path provided";
+        return false;
+    }
+
+    // QPdfWriter instead of QPrinter: no print system lookup, so streams may
+    // also be opened on worker threads (one exporter per thread)
+    m_streamFile.reset(new QSaveFile(filePath));
+    if (!m_streamFile->open(QIODevice::WriteOnly)) {
+        qCWarning(lcPdf) << "PDFExporter: Cannot open" << filePath << ":" << m_streamFile->errorString();
+        m_streamFile.reset();
         return false;
     }
 
+    m_streamWriter.reset(new QPdfWriter(m_streamFile.get()));
+    m_streamWriter->setResolution(PDF_RESOLUTION);
+    m_streamWriter->setPageLayout(pdfPageLayout());
+    m_streamWriter->setTitle(m_title);
+
+    m_streamRenderer.reset(new ReportTableRenderer());
+    configureRenderer(*m_streamRenderer);
+
+    if (!m_streamRenderer->begin(m_streamWriter.get())) {
+        qCWarning(lcPdf) << "PDFExporter: Cannot start painting on" << filePath;
+        m_streamRenderer.reset();
+        m_streamWriter.reset();
+        m_streamFile->cancelWriting();
+        m_streamFile.reset();
+        return false;
+    }
+
+    m_streamFilePath = filePath;
+    m_streamExpectedRows = expectedRows;
+    m_streamCells.reserve(m_headers.size());
+    m_streamTimer.start();
+
     emit exportStarted();
+    return true;
+}
 
-    // Generate HTML content
-    QString htmlContent = generateHtml();
+bool PDFExporter::writeRow(const QStringList &row)
+{
+    if (!isExportOpen()) {
+        qCWarning(lcPdf) << "PDFExporter: Cannot write row, the export is not open";
+        return false;
+    }
 
-    // Create QTextDocument
-    QTextDocument doc;
-    doc.setHtml(htmlContent);
+    // A row that does not fit starts a new page, the rows before it are on finished pages
+    const int pages = m_streamRenderer->pageCount();
+    const bool written = m_streamRenderer->addRow(row);
+    if (m_streamRenderer->pageCount() > pages) {
+        emit pageFinished(pages, m_streamRenderer->rowCount() - 1, m_streamExpectedRows);
+    }
+    return written;
+}
+
+bool PDFExporter::writeGroupHeader(const QString &label)
+{
+    if (!isExportOpen()) {
+        qCWarning(lcPdf) << "PDFExporter: Cannot write group header, the export is not open";
+        return false;
+    }
+
+    const int pages = m_streamRenderer->pageCount();
+    const bool written = m_streamRenderer->addGroupHeader(label);
+    if (m_streamRenderer->pageCount() > pages) {
+        emit pageFinished(pages, m_streamRenderer->rowCount(), m_streamExpectedRows);
+    }
+    return written;
+}
+
+bool PDFExporter::writeSummaryPage(const QString &title, const QStringList &headers, const QList<QStringList> &rows)
+{
+    if (!isExportOpen()) {
+        qCWarning(lcPdf) << "PDFExporter: Cannot write summary page, the export is not open";
+        return false;
+    }
 
-    // Setup printer for PDF export
-    QPrinter printer(QPrinter::HighResolution);
-    printer.setOutputFormat(QPrinter::PdfFormat);
-    printer.setOutputFileName(filePath);
-    printer.setPageSize(QPageSize(m_pageSize));
-    printer.setPageOrientation(m_orientation);
+    return m_streamRenderer->addSummaryPage(title, headers, rows);
+}
 
-    // Print to PDF
-    doc.print(&printer);
+bool PDFExporter::closeExport()
+{
+    TRACE_SPAN("pdf", "PDFExporter::closeExport");
 
-    qDebug() << "PDFExporter: PDF exported to" << filePath;
+    if (!isExportOpen()) {
+        return false;
+    }
 
-    emit exportFinished(true, filePath);
+    // Ending the painter finishes the last page and the PDF trailer
+    bool success = m_streamRenderer->end();
 
-    return true;
+    m_lastExportRowCount = m_streamRenderer->rowCount();
+    m_lastExportPageCount = m_streamRenderer->pageCount();
+    if (success) {
+        emit pageFinished(m_lastExportPageCount, m_lastExportRowCount, m_streamExpectedRows);
+    }
+
+    qCDebug(lcPdf) << "PDFExporter: streamed" << m_lastExportRowCount << "rows on"
+                   << m_lastExportPageCount << "pages to" << m_streamFilePath
+                   << "in" << m_streamTimer.elapsed() << "ms";
+
+    m_streamRenderer.reset();
+    m_streamWriter.reset(); // flushes the trailer into the file
+
+    // The file only appears under its name once it is complete
+    if (success) {
+        success = m_streamFile->commit();
+    } else {
+        m_streamFile->cancelWriting();
+    }
+    m_streamFile.reset();
+
+    const QString filePath = m_streamFilePath;
+    m_streamFilePath.clear();
+
+    if (success) {
+        PerfCounters::recordExport("pdf", m_lastExportRowCount, QFileInfo(filePath).size(), m_streamTimer.elapsed());
+    }
+
+    emit exportFinished(success, filePath);
+    return success;
 }
 
-bool PDFExporter::previewAndExport(QWidget *parent)
+void PDFExporter::cancelExport()
 {
-    // Generate HTML content once
-    QString htmlContent = generateHtml();
+    if (!isExportOpen()) {
+        return;
+    }
 
-    // Create QTextDocument
-    QTextDocument doc;
-    doc.setHtml(htmlContent);
+    m_streamRenderer->end();
+    m_streamRenderer.reset();
+    m_streamWriter.reset();
 
-    // Setup printer for preview
-    QPrinter printer(QPrinter::HighResolution);
-    printer.setPageSize(QPageSize(m_pageSize));
-    printer.setPageOrientation(m_orientation);
+    // Nothing was renamed yet, the temporary file is simply removed
+    m_streamFile->cancelWriting();
+    m_streamFile.reset();
 
-    // Create preview dialog
-    QPrintPreviewDialog previewDialog(&printer, parent);
-    previewDialog.setWindowTitle(m_title.isEmpty() ? "Preview & Export PDF" : "Preview: " + m_title);
+    const QString filePath = m_streamFilePath;
+    m_streamFilePath.clear();
 
-    // Connect paint signal
-    QObject::connect(&previewDialog, &QPrintPreviewDialog::paintRequested,
-                     [&doc](QPrinter *currentPrinter) {
-                         doc.print(currentPrinter);
-                     });
+    emit exportFinished(false, filePath);
+}
+
+bool PDFExporter::isExportOpen() const
+{
+    return m_streamRenderer != nullptr;
+}
+
+int PDFExporter::lastExportPageCount() const
+{
+    return m_lastExportPageCount;
+}
 
-    qDebug() << "PDFExporter: Displaying preview...";
+qsizetype PDFExporter::lastExportRowCount() const
+{
+    return m_lastExportRowCount;
+}
 
-    // Show preview dialog
-    int result = previewDialog.exec();
+qsizetype PDFExporter::tableRowCount() const
+{
+    return m_rowWriter ? m_rowCount : m_data.size();
+}
 
-    emit previewClosed();
+void PDFExporter::cellsAt(qsizetype index, QStringList &cells) const
+{
+    if (m_rowWriter) {
+        StringListCellWriter writer(cells);
+        m_rowWriter(index, writer);
+        writer.finish();
+    } else {
+        cells = m_data.at(index);
+    }
+}
 
-    // If user closed preview, ask to save
-    if (result == QDialog::Accepted || result == QDialog::Rejected) {
-        QString filePath = QFileDialog::getSaveFileName(
-            parent,
-            "Simpan PDF",
-            QDir::homePath() + "/" + (m_title.isEmpty() ? "document" : m_title) + ".pdf",
-            "PDF Files (*.pdf)"
-            );
+QVector<int> PDFExporter::measureRowsParallel(const ReportTableRenderer &renderer, int threads) const
+{
+    TRACE_SPAN("pdf", "PDFExporter::measureRowsParallel");
+
+    const qsizetype rows = tableRowCount();
+    QVector<int> heights(rows);
+    int *heightsOut = heights.data();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    // A few blocks per thread keeps the threads busy when some rows wrap
+    const qsizetype blockCount = qMin<qsizetype>(rows, qsizetype(threads) * 4);
+    QList<QFuture<void>> blocks;
+    blocks.reserve(blockCount);
+
+    for (qsizetype b = 0; b < blockCount; ++b) {
+        const qsizetype first = rows * b / blockCount;
+        const qsizetype last = rows * (b + 1) / blockCount;
+
+        blocks.append(QtConcurrent::run(&pool, [this, &renderer, heightsOut, first, last]() {
+            TRACE_SPAN("pdf", "PDFExporter::measureBlock");
+            const QFontMetrics metrics = renderer.createFontMetrics();
+            QStringList cells;
+            for (qsizetype i = first; i < last; ++i) {
+                cellsAt(i, cells);
+                heightsOut[i] = renderer.rowHeight(metrics, cells);
+            }
+        }));
+    }
 
-        if (!filePath.isEmpty()) {
-            return exportToPdf(filePath);
-        }
+    for (QFuture<void> &block : blocks) {
+        block.waitForFinished();
     }
 
-    return false;
+    return heights;
+}
+
+int PDFExporter::layoutThreadCount() const
+{
+    return m_layoutThreadCount > 0 ? m_layoutThreadCount : qMax(1, QThread::idealThreadCount());
 }
 
 QString PDFExporter::getGeneratedHtml() const
@@ -305,6 +832,8 @@ void PDFExporter::clearData()
     m_title.clear();
     m_headers.clear();
     m_data.clear();
+    m_rowCount = 0;
+    m_rowWriter = nullptr;
     m_customHtml.clear();
     m_prefixHtml.clear();
     m_suffixHtml.clear();
@@ -6,22 +6,118 @@
 #include <QStringList>
 #include <QVariantList>
 #include <QTextDocument>
-#include <QPrinter>
-#include <QPrintPreviewDialog>
+#include <QPdfWriter>
+#include <QSaveFile>
 #include <QDateTime>
 #include <QDebug>
-#include <QFileDialog>
-#include <QMessageBox>
 #include <QPageSize>
+#include <QElapsedTimer>
 #include <functional>
+#include <memory>
+#include <atomic>
+#include "reporttablerenderer.h"
+#include "reportlayout.h"
+#include "htmlrowtemplate.h"
+#include "reportcache.h"
+
+class QWidget;
+
+// Receives the cells of one typed row, implemented by each report output path.
+// Row adapters (e.g. StudentsRowAdapter) call writeField once per column.
+class ReportCellWriter
+{
+public:
+    virtual ~ReportCellWriter() = default;
+
+    virtual void writeField(const QString &text) = 0;
+    virtual void writeField(qint64 value) = 0;
+    void writeField(int value) { writeField(qint64(value)); }
+};
+
+// Collects the cells of one typed row into a reusable list (painter backend).
+// The cells of the previous row are overwritten in place: text is shared, not
+// copied, and numbers are formatted into the old cell's buffer, so a row only
+// allocates when that buffer is still referenced elsewhere (e.g. by a new text
+// cache entry). Call finish() after the last field.
+class StringListCellWriter : public ReportCellWriter
+{
+public:
+    explicit StringListCellWriter(QStringList &cells) : m_cells(cells), m_column(0) {}
+
+    using ReportCellWriter::writeField;
+
+    void writeField(const QString &text) override
+    {
+        if (m_column < m_cells.size()) {
+            m_cells[m_column] = text;
+        } else {
+            m_cells.append(text);
+        }
+        ++m_column;
+    }
+
+    void writeField(qint64 value) override
+    {
+        if (m_column < m_cells.size()) {
+            m_cells[m_column].setNum(value);
+        } else {
+            m_cells.append(QString::number(value));
+        }
+        ++m_column;
+    }
+
+    // Drops the cells left over from a longer previous row
+    void finish()
+    {
+        if (m_column < m_cells.size()) {
+            m_cells.resize(m_column);
+        }
+    }
+
+private:
+    QStringList &m_cells;
+    qsizetype m_column;
+};
 
 class PDFExporter : public QObject
 {
     Q_OBJECT
 public:
+    // How the report is laid out
+    enum RenderBackend {
+        AutoBackend,     // painter, unless custom/prefix/suffix HTML is set
+        PainterBackend,  // ReportTableRenderer, paints row by row with QPainter
+        HtmlBackend      // HTML + QTextDocument (the whole table is laid out in memory)
+    };
+
     explicit PDFExporter(QObject *parent = nullptr);
     ~PDFExporter();
 
+    void setRenderBackend(RenderBackend backend);
+
+    // Threads measuring rows for the painter backend (default: 0 = QThread::idealThreadCount()).
+    // Large reports measure every row in parallel first, then paint the
+    // pre-measured rows in order. 1 measures while painting.
+    void setLayoutThreadCount(int count);
+
+    // Entries of the shaped text cache of the painter backend (default: 4096).
+    // Repeated cell values and header labels are shaped once; 0 disables the cache.
+    void setTextCacheSize(int entries);
+
+    // Disk cache for generated PDFs and preview pages (not owned, nullptr = off).
+    // Reports with the same contentHash() are copied from the cache.
+    void setReportCache(ReportCache *cache);
+
+    // SHA-256 (hex) of everything the output depends on: title, headers, rows,
+    // colours, page settings, HTML fragments and template. With setShowDate(true)
+    // the formatted generation date is part of it too, so a cached report is only
+    // reused while it would show the same date (e.g. the same day for "dd MMMM yyyy").
+    QString contentHash() const;
+
+    // Rendering stops at the next row once *flag becomes true (the export then
+    // fails). The flag is owned by the caller, e.g. PDFExportJob.
+    void setCancelFlag(const std::atomic<bool> *flag);
+
     // Configuration methods
     void setTitle(const QString &title);
     void setShowDate(bool show);
@@ -32,9 +128,25 @@ public:
     // Table-based export
     void setTableHeaders(const QStringList &headers);
     void setTableData(const QList<QStringList> &data);
+
+    // Typed rows, written cell by cell through adapter(row, writer) when the
+    // report is generated. rows is shared (not deep copied) until then.
+    template <typename Row, typename Adapter>
+    void setTableRows(const QList<Row> &rows, Adapter adapter)
+    {
+        m_data.clear();
+        m_rowCount = rows.size();
+        m_rowWriter = [rows, adapter](qsizetype index, ReportCellWriter &writer) {
+            adapter(rows.at(index), writer);
+        };
+    }
     void setHeaderColor(const QString &color);
     void setZebraColors(const QString &evenColor, const QString &oddColor);
 
+    // Row template of the HTML table, see HtmlRowTemplate for the placeholders
+    // (empty = one <td> per header). Returns false if the template does not compile.
+    bool setRowTemplate(const QString &rowTemplate);
+
     // Custom HTML export
     void setCustomHtml(const QString &html);
 
@@ -43,23 +155,75 @@ public:
     void setSuffixHtml(const QString &html);  // Content after table
 
     // Export methods
+    // preview() is GUI only (pdfexporterpreview.cpp); with the painter backend
+    // its export button writes the previewed pages without laying them out again
     bool preview(QWidget *parent = nullptr);
-    bool exportToPdf(const QString &filePath);
-    bool previewAndExport(QWidget *parent = nullptr);
+    bool exportToPdf(const QString &filePath); // atomic: temp file, renamed when complete
+    bool exportToDevice(QIODevice *device);    // PDF into any open device
+    bool exportToHtml(const QString &filePath); // standalone HTML report, UTF-8
+
+    // Paginate the table once (painter backend) for previewing, printing or
+    // exporting the same pages later, also from other threads
+    std::shared_ptr<ReportLayout> createLayout() const;
+
+    // Streaming export: open, push rows (e.g. straight from a DB cursor), close.
+    // Rows are painted as they arrive and every finished page is written to the
+    // file, so memory stays flat whatever the row count. Title, headers and
+    // colours must be set before openExport(). pageFinished is emitted for every
+    // finished page with expectedRows (e.g. from a COUNT) as rowCount, 0 if unknown.
+    bool openExport(const QString &filePath, qsizetype expectedRows = 0);
+    bool writeRow(const QStringList &row);
+    template <typename Row, typename Adapter>
+    bool writeRow(const Row &row, Adapter adapter)
+    {
+        StringListCellWriter writer(m_streamCells);
+        adapter(row, writer);
+        writer.finish();
+        return writeRow(m_streamCells);
+    }
+    // Grouped reports: a band before the rows of each group, and a page with
+    // a separate table (e.g. counts per group) usually written last
+    bool writeGroupHeader(const QString &label);
+    bool writeSummaryPage(const QString &title, const QStringList &headers, const QList<QStringList> &rows);
+    bool closeExport(); // commits the file (temporary file renamed when complete)
+    // closes the stream without writing the file, also done by the destructor
+    // for a stream that was never closed
+    void cancelExport();
+    bool isExportOpen() const;
+
+    // Pages and rows of the last closed stream or painter backend export
+    int lastExportPageCount() const;
+    qsizetype lastExportRowCount() const;
 
     // Utility
-    QString getGeneratedHtml() const;
+    QString getGeneratedHtml() const; // HTML backend only
     void clearData();
 
 signals:
     void exportStarted();
     void exportFinished(bool success, const QString &filePath);
+    // Page page is complete, rowsDone of rowCount rows are on finished pages.
+    // Emitted from the thread doing the export.
+    void pageFinished(int page, qsizetype rowsDone, qsizetype rowCount);
     void previewClosed();
 
 private:
     // HTML generation
     QString generateHtml();
-    QString generateTableHtml();
+    void appendTableHtml(QString &html) const;
+    qsizetype estimateHtmlSize() const;
+    bool compileRowTemplate(HtmlRowTemplate &rowTemplate) const;
+
+    // Painter rendering
+    bool usePainterBackend() const;
+    QPageLayout pdfPageLayout() const;
+    void configureRenderer(ReportTableRenderer &renderer) const;
+    bool renderTable(QPagedPaintDevice *device);
+    qsizetype tableRowCount() const;
+    void cellsAt(qsizetype index, QStringList &cells) const;
+    QVector<int> measureRowsParallel(const ReportTableRenderer &renderer, int threads) const;
+    int layoutThreadCount() const;
+    bool isCancelled() const;
 
     // Data members
     QString m_title;
@@ -71,18 +235,41 @@ private:
     QStringList m_headers;
     QList<QStringList> m_data;
 
+    // Typed rows set with setTableRows()
+    qsizetype m_rowCount;
+    std::function<void(qsizetype, ReportCellWriter &)> m_rowWriter;
+
     QString m_headerColor;
     QString m_zebraEvenColor;
     QString m_zebraOddColor;
 
+    QString m_rowTemplate;
     QString m_customHtml;
     QString m_prefixHtml;
     QString m_suffixHtml;
 
     QString m_lastGeneratedHtml;
+    RenderBackend m_renderBackend;
+    int m_layoutThreadCount;
+    int m_textCacheSize;
+    ReportCache *m_reportCache;
+    const std::atomic<bool> *m_cancelFlag;
+
+    // Streaming export state
+    std::unique_ptr<QSaveFile> m_streamFile;
+    std::unique_ptr<QPdfWriter> m_streamWriter;
+    std::unique_ptr<ReportTableRenderer> m_streamRenderer;
+    QStringList m_streamCells;
+    QString m_streamFilePath;
+    qsizetype m_streamExpectedRows;
+    QElapsedTimer m_streamTimer;
+    int m_lastExportPageCount;
+    qsizetype m_lastExportRowCount;
 
     // Helper methods
-    QString escapeHtml(const QString &text) const;
+    bool hasTableData() const;
+    QString generatedDateText() const;
+    static QString escapeHtml(const QString &text);
 };
 
 #endif // PDFEXPORTER_H
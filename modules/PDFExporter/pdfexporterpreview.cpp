@@ -0,0 +1,71 @@
+#include "pdfexporter.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+#include <QPrinter>
+#include <QPrintPreviewDialog>
+#include "reportpreviewdialog.h"
+
+// The preview of PDFExporter, the only part needing QtWidgets and
+// QtPrintSupport. Built with the GUI application only (PDFExporterPreview.pri),
+// the headless core library and CLI leave this file out.
+
+bool PDFExporter::preview(QWidget *parent)
+{
+    TRACE_SPAN("pdf", "PDFExporter::preview");
+
+    // Painter backend: paginate once, pages are rendered on demand while scrolling
+    if (usePainterBackend()) {
+        // Key before layout: it holds the shown date, see contentHash()
+        const QString cacheKey = m_reportCache ? contentHash() : QString();
+
+        ReportPreviewDialog previewDialog(createLayout(), parent);
+        previewDialog.setWindowTitle(m_title.isEmpty() ? "Preview PDF" : "Preview: " + m_title);
+
+        // Pages rendered for an earlier preview of the same report come from disk
+        if (m_reportCache) {
+            previewDialog.setPageImageCache(m_reportCache, cacheKey);
+        }
+
+        qCDebug(lcPdf) << "PDFExporter: Displaying preview...";
+        const int result = previewDialog.exec();
+
+        emit previewClosed();
+
+        if (!previewDialog.exportedFilePath().isEmpty()) {
+            if (m_reportCache) {
+                m_reportCache->storePdf(cacheKey, previewDialog.exportedFilePath());
+            }
+            emit exportFinished(true, previewDialog.exportedFilePath());
+        }
+
+        return (result == QDialog::Accepted);
+    }
+
+    // HTML backend: the document is laid out once, the dialog prints it on every repaint
+    QTextDocument doc;
+    doc.setHtml(generateHtml());
+
+    // Setup printer for preview
+    QPrinter printer(QPrinter::HighResolution);
+    printer.setPageSize(QPageSize(m_pageSize));
+    printer.setPageOrientation(m_orientation);
+
+    // Create preview dialog
+    QPrintPreviewDialog previewDialog(&printer, parent);
+    previewDialog.setWindowTitle(m_title.isEmpty() ? "Preview PDF" : "Preview: " + m_title);
+
+    // Connect paint signal
+    QObject::connect(&previewDialog, &QPrintPreviewDialog::paintRequested,
+                     [&doc](QPrinter *currentPrinter) {
+                         doc.print(currentPrinter);
+                     });
+
+    qCDebug(lcPdf) << "PDFExporter: Displaying preview...";
+
+    // Show preview dialog (blocking)
+    int result = previewDialog.exec();
+
+    emit previewClosed();
+
+    return (result == QDialog::Accepted);
+}
@@ -0,0 +1,210 @@
+#include "pdfexportjob.h"
+#include "helpers/databasemanager.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+#include <QtConcurrent/QtConcurrentRun>
+
+PDFExportJob::PDFExportJob(QObject *parent)
+    : QObject{parent}
+    , m_tableName("mahasiswa")
+    , m_groupedByKelas(false)
+    , m_exportedRowCount(0)
+    , m_exportedGroupCount(0)
+    , m_cancelled(false)
+{
+    m_exporter.setCancelFlag(&m_cancelled);
+
+    // Emitted on the worker thread, the job's signals are queued to its owner
+    connect(&m_exporter, &PDFExporter::pageFinished, this,
+            [this](int page, qsizetype rowsDone, qsizetype rowCount) {
+                emit pageFinished(page, rowsDone, rowCount);
+            }, Qt::DirectConnection);
+
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, &PDFExportJob::onWorkerFinished);
+}
+
+PDFExportJob::~PDFExportJob()
+{
+    if (isRunning()) {
+        cancel();
+        m_future.waitForFinished();
+    }
+}
+
+PDFExporter &PDFExportJob::exporter()
+{
+    return m_exporter;
+}
+
+void PDFExportJob::setDatabaseSource(const QString &databasePath, const QString &tableName)
+{
+    m_databasePath = databasePath;
+    m_tableName = tableName;
+}
+
+void PDFExportJob::setGroupedByKelas(bool grouped)
+{
+    m_groupedByKelas = grouped;
+}
+
+bool PDFExportJob::start(const QString &filePath)
+{
+    if (isRunning()) {
+        m_lastError = "An export is already running";
+        return false;
+    }
+
+    if (filePath.isEmpty()) {
+        m_lastError = "Empty file path provided";
+        return false;
+    }
+
+    m_cancelled.store(false);
+    m_filePath = filePath;
+    m_lastError.clear();
+    m_exportedRowCount = 0;
+    m_exportedGroupCount = 0;
+
+    m_future = QtConcurrent::run([this, filePath]() {
+        return run(filePath);
+    });
+    m_watcher.setFuture(m_future);
+
+    return true;
+}
+
+void PDFExportJob::cancel()
+{
+    m_cancelled.store(true);
+}
+
+bool PDFExportJob::isRunning() const
+{
+    return m_future.isRunning();
+}
+
+QString PDFExportJob::getLastError() const
+{
+    return m_lastError;
+}
+
+qint64 PDFExportJob::exportedRowCount() const
+{
+    return m_exportedRowCount;
+}
+
+int PDFExportJob::exportedGroupCount() const
+{
+    return m_exportedGroupCount;
+}
+
+bool PDFExportJob::run(const QString &filePath)
+{
+    // Both paths write through QSaveFile: the temporary file is discarded
+    // unless every page was written
+    bool success;
+    if (m_databasePath.isEmpty()) {
+        success = m_exporter.exportToPdf(filePath);
+        if (success) {
+            m_exportedRowCount = m_exporter.lastExportRowCount();
+        }
+    } else {
+        // A QSqlDatabase connection belongs to the thread that opened it
+        DatabaseManager db(m_databasePath, QString("pdfexport_%1").arg(quintptr(this), 0, 16), true);
+        if (db.isDatabaseOpen()) {
+            success = streamFromDatabase(db, filePath);
+        } else {
+            success = false;
+            m_lastError = "Cannot open database " + m_databasePath;
+        }
+    }
+
+    // A cancel arriving after the last page is too late, the file is complete
+    if (!success && m_cancelled.load()) {
+        m_lastError = "Export cancelled";
+    } else if (!success && m_lastError.isEmpty()) {
+        m_lastError = "Failed to write " + filePath;
+    }
+
+    return success;
+}
+
+bool PDFExportJob::streamFromDatabase(DatabaseManager &db, const QString &filePath)
+{
+    TRACE_SPAN("pdf", "PDFExportJob::streamFromDatabase");
+
+    // The counts per kelas come from the kelas index: they give the progress
+    // total without reading the rows twice
+    QList<StudentsGroupStruct> groups;
+    if (!db.selectGroupSummary(m_tableName, groups)) {
+        m_lastError = "Cannot read " + m_tableName;
+        return false;
+    }
+
+    qint64 total = 0;
+    for (const StudentsGroupStruct &group : std::as_const(groups)) {
+        total += group.count;
+    }
+
+    if (total == 0) {
+        m_lastError = "No rows to export";
+        return false;
+    }
+
+    if (!m_exporter.openExport(filePath, total)) {
+        m_lastError = "Cannot create " + filePath;
+        return false;
+    }
+
+    bool written = true;
+    const auto writeStudent = [&](const StudentsDataStruct &student) {
+        written = !m_cancelled.load(std::memory_order_relaxed)
+                  && m_exporter.writeRow(student, StudentsRowAdapter());
+        return written;
+    };
+
+    bool read;
+    QList<QStringList> summaryRows;
+    if (m_groupedByKelas) {
+        // Grouping, order and counts per kelas are done by SQLite
+        read = db.selectRecordsGrouped(m_tableName,
+            [&](const StudentsGroupStruct &group) {
+                const QString kelas = group.kelas.isEmpty() ? QString("(tanpa kelas)") : group.kelas;
+                summaryRows.append(QStringList() << kelas << QString::number(group.count));
+                written = m_exporter.writeGroupHeader(QString("Kelas %1 (%2 mahasiswa)").arg(kelas).arg(group.count));
+                return written;
+            },
+            writeStudent);
+
+        if (read && written) {
+            summaryRows.append(QStringList() << "TOTAL" << QString::number(total));
+            written = m_exporter.writeSummaryPage("Ringkasan per Kelas",
+                                                  QStringList() << "kelas" << "jumlah mahasiswa", summaryRows);
+        }
+    } else {
+        read = db.selectRecordsStreamed(m_tableName, QString(), QVariantMap(), writeStudent);
+    }
+
+    if (!read || !written || m_cancelled.load()) {
+        m_exporter.cancelExport();
+        if (!read) {
+            m_lastError = "Cannot read the rows of " + m_tableName;
+        }
+        return false;
+    }
+
+    if (!m_exporter.closeExport()) {
+        return false;
+    }
+
+    m_exportedRowCount = m_exporter.lastExportRowCount();
+    m_exportedGroupCount = m_groupedByKelas ? int(summaryRows.size()) - 1 : 0;
+    return true;
+}
+
+void PDFExportJob::onWorkerFinished()
+{
+    // The future is finished, so m_lastError is no longer touched by the worker
+    const bool success = m_future.result();
+    emit finished(success, !success && m_cancelled.load(), m_filePath);
+}
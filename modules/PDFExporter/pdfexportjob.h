@@ -0,0 +1,71 @@
+#ifndef PDFEXPORTJOB_H
+#define PDFEXPORTJOB_H
+
+#include <QObject>
+#include <QString>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <atomic>
+#include "pdfexporter.h"
+
+class DatabaseManager;
+
+// Runs PDFExporter::exportToPdf on a worker thread.
+// Configure exporter() (title, headers, rows) before start() and leave it alone
+// until finished(); the rows given to it are read from the worker thread.
+// With setDatabaseSource() the worker reads the rows itself instead, through
+// its own read-only connection, and streams them from the cursor into the PDF.
+// The file is written to a temporary file and only renamed to filePath once the
+// whole document is complete, a cancelled or failed job leaves no file behind.
+class PDFExportJob : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PDFExportJob(QObject *parent = nullptr);
+    ~PDFExportJob(); // cancels a running job and waits for it
+
+    PDFExporter &exporter();
+
+    // Rows come from tableName of the database file instead of exporter()'s rows
+    void setDatabaseSource(const QString &databasePath, const QString &tableName = "mahasiswa");
+    // With a database source: rows ordered per kelas, a band before every kelas
+    // and a summary page with the count per kelas at the end
+    void setGroupedByKelas(bool grouped);
+
+    // Start exporting to filePath, returns false if a job is already running
+    bool start(const QString &filePath);
+
+    // Ask the running job to stop, it finishes with cancelled = true
+    void cancel();
+
+    bool isRunning() const;
+    QString getLastError() const;
+
+    // Rows and kelas groups of the last successful export
+    qint64 exportedRowCount() const;
+    int exportedGroupCount() const;
+
+signals:
+    // Queued to the thread owning the job
+    void pageFinished(int page, qint64 rowsDone, qint64 rowCount);
+    void finished(bool success, bool cancelled, const QString &filePath);
+
+private:
+    bool run(const QString &filePath);
+    bool streamFromDatabase(DatabaseManager &db, const QString &filePath);
+    void onWorkerFinished();
+
+    PDFExporter m_exporter;
+    QString m_databasePath;
+    QString m_tableName;
+    bool m_groupedByKelas;
+    qint64 m_exportedRowCount;
+    int m_exportedGroupCount;
+    QFuture<bool> m_future;
+    QFutureWatcher<bool> m_watcher;
+    std::atomic<bool> m_cancelled;
+    QString m_filePath;
+    QString m_lastError;
+};
+
+#endif // PDFEXPORTJOB_H
@@ -0,0 +1,350 @@
+#include "reportbatchjob.h"
+#include "pdfexporter.h"
+#include "helpers/databasemanager.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+const char SUMMARY_FILE_NAME[] = "ringkasan_laporan.csv";
+
+QString csvField(const QString &text)
+{
+    if (!text.contains(',') && !text.contains('"') && !text.contains('\n')) {
+        return text;
+    }
+    return '"' + QString(text).replace('"', "\"\"") + '"';
+}
+}
+
+ReportBatchJob::ReportBatchJob(QObject *parent)
+    : QObject{parent}
+    , m_tableName("mahasiswa")
+    , m_title("Laporan Mahasiswa Kelas %1")
+    , m_headers(QStringList() << "id" << "nama" << "npm" << "kelas")
+    , m_threadCount(0)
+    , m_elapsedMs(0)
+    , m_cancelled(false)
+{
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, &ReportBatchJob::onWorkerFinished);
+}
+
+ReportBatchJob::~ReportBatchJob()
+{
+    if (isRunning()) {
+        cancel();
+        m_future.waitForFinished();
+    }
+}
+
+void ReportBatchJob::setDatabasePath(const QString &path)
+{
+    m_databasePath = path;
+}
+
+void ReportBatchJob::setTableName(const QString &tableName)
+{
+    m_tableName = tableName;
+}
+
+void ReportBatchJob::setTitle(const QString &title)
+{
+    m_title = title;
+}
+
+void ReportBatchJob::setTableHeaders(const QStringList &headers)
+{
+    m_headers = headers;
+}
+
+void ReportBatchJob::setThreadCount(int count)
+{
+    m_threadCount = qMax(0, count);
+}
+
+bool ReportBatchJob::start(const QList<StudentsGroupStruct> &groups, const QString &directory)
+{
+    if (isRunning()) {
+        m_lastError = "A batch is already running";
+        return false;
+    }
+
+    if (m_databasePath.isEmpty()) {
+        m_lastError = "No database path set";
+        return false;
+    }
+
+    QDir dir(directory);
+    if (directory.isEmpty() || !dir.exists()) {
+        m_lastError = "Output directory does not exist: " + directory;
+        return false;
+    }
+
+    // File names are decided here, so two groups that sanitize to the same
+    // name (e.g. "A/1" and "A 1") never write the same file from two threads
+    m_files.clear();
+    QSet<QString> usedNames;
+    QSet<QString> seenGroups;
+    for (const StudentsGroupStruct &group : groups) {
+        // NULL and '' come as two groups with the same (empty) name, one file holds both
+        if (seenGroups.contains(group.kelas)) {
+            continue;
+        }
+        seenGroups.insert(group.kelas);
+
+        const QString base = fileNameFor(group.kelas);
+        QString name = base;
+        for (int n = 2; usedNames.contains(name.toLower()); ++n) {
+            name = QString("%1_%2").arg(base).arg(n);
+        }
+        usedNames.insert(name.toLower());
+
+        ReportBatchFile file;
+        file.group = group.kelas;
+        file.filePath = dir.filePath(name + ".pdf");
+        m_files.append(file);
+    }
+
+    m_directory = dir.absolutePath();
+    m_summaryFilePath.clear();
+    m_elapsedMs = 0;
+    m_lastError.clear();
+    m_cancelled.store(false);
+
+    m_future = QtConcurrent::run([this]() {
+        return run();
+    });
+    m_watcher.setFuture(m_future);
+
+    return true;
+}
+
+void ReportBatchJob::cancel()
+{
+    m_cancelled.store(true);
+}
+
+bool ReportBatchJob::isRunning() const
+{
+    return m_future.isRunning();
+}
+
+QList<ReportBatchFile> ReportBatchJob::results() const
+{
+    return m_files;
+}
+
+qint64 ReportBatchJob::elapsedMs() const
+{
+    return m_elapsedMs;
+}
+
+QString ReportBatchJob::summaryFilePath() const
+{
+    return m_summaryFilePath;
+}
+
+QString ReportBatchJob::getLastError() const
+{
+    return m_lastError;
+}
+
+bool ReportBatchJob::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const int total = m_files.size();
+    const int threads = qMin(threadCount(), qMax(1, total));
+
+    // Shared cursor: every thread claims the next group until none is left.
+    // Each group has its own element of m_files, threads never touch the same one.
+    std::atomic<int> nextFile(0);
+    std::atomic<int> done(0);
+    ReportBatchFile *files = m_files.data();
+
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+
+        QList<QFuture<void>> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.append(QtConcurrent::run(&pool, [&, t]() {
+                // A QSqlDatabase connection belongs to the thread that opened it
+                DatabaseManager db(m_databasePath,
+                                   QString("reportbatch_%1_%2").arg(quintptr(this), 0, 16).arg(t),
+                                   true);
+
+                int index;
+                while (!m_cancelled.load() && (index = nextFile.fetch_add(1)) < total) {
+                    ReportBatchFile &file = files[index];
+
+                    if (db.isDatabaseOpen()) {
+                        writeGroup(db, file);
+                    } else {
+                        file.error = "Cannot open database " + m_databasePath;
+                    }
+
+                    emit fileFinished(file, done.fetch_add(1) + 1, total);
+                }
+            }));
+        }
+
+        for (QFuture<void> &worker : workers) {
+            worker.waitForFinished();
+        }
+    }
+
+    m_elapsedMs = timer.elapsed();
+
+    qint64 rows = 0;
+    int pages = 0;
+    bool success = !m_cancelled.load();
+    for (const ReportBatchFile &file : std::as_const(m_files)) {
+        rows += file.rows;
+        pages += file.pages;
+        if (!file.success) {
+            success = false;
+            if (m_lastError.isEmpty() && !file.error.isEmpty()) {
+                m_lastError = file.group + ": " + file.error;
+            }
+        }
+    }
+
+    qCDebug(lcPdf) << "ReportBatchJob:" << total << "files," << rows << "rows," << pages << "pages with"
+                   << threads << "threads in" << m_elapsedMs << "ms ("
+                   << (m_elapsedMs > 0 ? total * 1000.0 / m_elapsedMs : 0.0) << "files/s,"
+                   << (m_elapsedMs > 0 ? pages * 1000.0 / m_elapsedMs : 0.0) << "pages/s)";
+
+    if (m_cancelled.load()) {
+        m_lastError = "Batch cancelled";
+        return false;
+    }
+
+    // Written even when some files failed, it says which ones
+    if (!writeSummary()) {
+        success = false;
+    }
+
+    return success;
+}
+
+void ReportBatchJob::writeGroup(DatabaseManager &db, ReportBatchFile &file)
+{
+    TRACE_SPAN("pdf", "ReportBatchJob::writeGroup");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QString label = file.group.isEmpty() ? QString("(tanpa kelas)") : file.group;
+
+    PDFExporter exporter;
+    exporter.setTitle(m_title.arg(label));
+    exporter.setTableHeaders(m_headers);
+
+    if (!exporter.openExport(file.filePath)) {
+        file.error = "Cannot create " + file.filePath;
+        file.elapsedMs = timer.elapsed();
+        return;
+    }
+
+    // The empty group holds both NULL and '' (see start()).
+    // kelas = :kelas ORDER BY nama walks idx_mahasiswa_kelas_nama, no sort needed.
+    QString condition;
+    QVariantMap bindValues;
+    if (file.group.isEmpty()) {
+        condition = "(kelas IS NULL OR kelas = '') ORDER BY nama";
+    } else {
+        condition = "kelas = :kelas ORDER BY nama";
+        bindValues.insert(":kelas", file.group);
+    }
+
+    bool written = true;
+    const bool read = db.selectRecordsStreamed(m_tableName, condition, bindValues,
+        [&](const StudentsDataStruct &student) {
+            if (m_cancelled.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            written = exporter.writeRow(student, StudentsRowAdapter());
+            return written;
+        });
+
+    if (!read || !written || m_cancelled.load()) {
+        exporter.cancelExport();
+        file.error = m_cancelled.load() ? QString("Cancelled")
+                   : !read ? QString("Cannot read the rows of this group")
+                           : QString("Failed to write ") + file.filePath;
+    } else if (!exporter.closeExport()) {
+        file.error = "Failed to write " + file.filePath;
+    } else {
+        file.success = true;
+        file.rows = exporter.lastExportRowCount();
+        file.pages = exporter.lastExportPageCount();
+    }
+
+    file.elapsedMs = timer.elapsed();
+}
+
+bool ReportBatchJob::writeSummary()
+{
+    TRACE_SPAN("pdf", "ReportBatchJob::writeSummary");
+
+    const QString filePath = QDir(m_directory).filePath(SUMMARY_FILE_NAME);
+
+    QSaveFile summary(filePath);
+    if (!summary.open(QIODevice::WriteOnly)) {
+        m_lastError = "Cannot write summary " + filePath + ": " + summary.errorString();
+        return false;
+    }
+
+    QString text = "kelas,file,rows,pages,ms,status\n";
+    for (const ReportBatchFile &file : std::as_const(m_files)) {
+        text += csvField(file.group) + ','
+              + csvField(QFileInfo(file.filePath).fileName()) + ','
+              + QString::number(file.rows) + ','
+              + QString::number(file.pages) + ','
+              + QString::number(file.elapsedMs) + ','
+              + csvField(file.success ? QString("ok") : file.error) + '\n';
+    }
+
+    const QByteArray utf8 = text.toUtf8();
+    if (summary.write(utf8) != utf8.size() || !summary.commit()) {
+        m_lastError = "Cannot write summary " + filePath;
+        return false;
+    }
+
+    m_summaryFilePath = filePath;
+    return true;
+}
+
+int ReportBatchJob::threadCount() const
+{
+    return m_threadCount > 0 ? m_threadCount : qMax(1, QThread::idealThreadCount());
+}
+
+QString ReportBatchJob::fileNameFor(const QString &group)
+{
+    static const QRegularExpression unsafe("[^A-Za-z0-9_-]+");
+
+    QString name = group.trimmed();
+    name.replace(unsafe, "_");
+    if (name.isEmpty() || name == "_") {
+        name = "tanpa_kelas";
+    }
+    return "kelas_" + name;
+}
+
+void ReportBatchJob::onWorkerFinished()
+{
+    // The future is finished, m_files and m_lastError are no longer touched by the workers
+    emit finished(m_future.result(), m_cancelled.load());
+}
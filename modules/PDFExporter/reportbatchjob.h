@@ -0,0 +1,92 @@
+#ifndef REPORTBATCHJOB_H
+#define REPORTBATCHJOB_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <atomic>
+#include "helpers/Environments.h"
+
+class DatabaseManager;
+
+// Outcome of one file of a batch
+struct ReportBatchFile
+{
+    QString group;     // kelas the file is about
+    QString filePath;
+    qint64 rows = 0;
+    int pages = 0;
+    qint64 elapsedMs = 0;
+    bool success = false;
+    QString error;
+};
+
+// Writes one PDF report per group (kelas) into a directory, several files at
+// a time. Every worker thread opens its own read-only connection to the
+// database and streams its groups straight from the cursor into the PDF, so
+// nothing but the current page is kept in memory and throughput grows with
+// the number of threads. A summary (rows, pages, time per file) is written
+// next to the reports when the batch is done.
+class ReportBatchJob : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ReportBatchJob(QObject *parent = nullptr);
+    ~ReportBatchJob(); // cancels a running batch and waits for it
+
+    // Configure before start()
+    void setDatabasePath(const QString &path);
+    void setTableName(const QString &tableName);
+    void setTitle(const QString &title); // %1 is replaced by the group name
+    void setTableHeaders(const QStringList &headers);
+    void setThreadCount(int count);      // default: 0 = QThread::idealThreadCount()
+
+    // Start writing one file per group (e.g. from DatabaseManager::selectGroupSummary)
+    // into directory. Returns false if a batch is already running.
+    bool start(const QList<StudentsGroupStruct> &groups, const QString &directory);
+
+    // Files being written are discarded, the batch finishes with cancelled = true
+    void cancel();
+
+    bool isRunning() const;
+
+    // Valid after finished()
+    QList<ReportBatchFile> results() const;
+    qint64 elapsedMs() const;
+    QString summaryFilePath() const;
+    QString getLastError() const;
+
+signals:
+    // Queued to the thread owning the job, done of total files are finished
+    void fileFinished(const ReportBatchFile &file, int done, int total);
+    void finished(bool success, bool cancelled);
+
+private:
+    bool run();
+    void writeGroup(DatabaseManager &db, ReportBatchFile &file);
+    bool writeSummary();
+    int threadCount() const;
+    static QString fileNameFor(const QString &group);
+    void onWorkerFinished();
+
+    QString m_databasePath;
+    QString m_tableName;
+    QString m_title;
+    QStringList m_headers;
+    int m_threadCount;
+
+    QString m_directory;
+    QList<ReportBatchFile> m_files;
+    qint64 m_elapsedMs;
+    QString m_summaryFilePath;
+    QString m_lastError;
+
+    QFuture<bool> m_future;
+    QFutureWatcher<bool> m_watcher;
+    std::atomic<bool> m_cancelled;
+};
+
+#endif // REPORTBATCHJOB_H
@@ -0,0 +1,254 @@
+#include "reportcache.h"
+#include "helpers/logging.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QImageWriter>
+#include <QBuffer>
+#include <QDebug>
+#include <algorithm>
+#include "helpers/Environments.h"
+#include "helpers/tracer.h"
+
+ReportCache::ReportCache(const QString &directory, qint64 maxBytes)
+    : m_dir(directory)
+    , m_maxBytes(maxBytes)
+    , m_sizeBytes(0)
+    , m_hits(0)
+    , m_misses(0)
+{
+    m_sizeBytes = scanSize();
+}
+
+QString ReportCache::defaultDirectory()
+{
+    return QString("%1/%2/reportcache").arg(QDir::homePath(), AppEnv::APP_HOMEDIR_NAME);
+}
+
+bool ReportCache::fetchPdf(const QString &key, const QString &filePath)
+{
+    TRACE_SPAN("pdf", "ReportCache::fetchPdf");
+
+    QMutexLocker locker(&m_mutex);
+
+    QFile cached(pdfPath(key));
+    if (!cached.open(QIODevice::ReadOnly)) {
+        ++m_misses;
+        return false;
+    }
+
+    // Through QSaveFile, an existing report is only replaced by a complete copy
+    QSaveFile out(filePath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        m_lastError = "Cannot write " + filePath + ": " + out.errorString();
+        return false;
+    }
+
+    while (!cached.atEnd()) {
+        const QByteArray block = cached.read(1024 * 1024);
+        if (block.isEmpty() || out.write(block) != block.size()) {
+            m_lastError = "Cannot copy cached report to " + filePath;
+            out.cancelWriting();
+            return false;
+        }
+    }
+
+    if (!out.commit()) {
+        m_lastError = "Cannot write " + filePath + ": " + out.errorString();
+        return false;
+    }
+
+    cached.close();
+    touch(pdfPath(key));
+    ++m_hits;
+    return true;
+}
+
+bool ReportCache::storePdf(const QString &key, const QString &sourceFilePath)
+{
+    TRACE_SPAN("pdf", "ReportCache::storePdf");
+
+    QMutexLocker locker(&m_mutex);
+
+    if (!ensureDirectory()) {
+        return false;
+    }
+
+    const QString target = pdfPath(key);
+    const qint64 oldSize = QFileInfo(target).size();
+    QFile::remove(target);
+
+    if (!QFile::copy(sourceFilePath, target)) {
+        m_lastError = "Cannot copy " + sourceFilePath + " into the report cache";
+        m_sizeBytes -= oldSize;
+        return false;
+    }
+
+    added(QFileInfo(target).size() - oldSize);
+    return true;
+}
+
+QImage ReportCache::loadPageImage(const QString &key, int page, int width)
+{
+    TRACE_SPAN("pdf", "ReportCache::loadPageImage");
+
+    QMutexLocker locker(&m_mutex);
+
+    const QString path = pageImagePath(key, page, width);
+    QImage image;
+    if (!QFileInfo::exists(path) || !image.load(path, "PNG")) {
+        ++m_misses;
+        return QImage();
+    }
+
+    touch(path);
+    ++m_hits;
+    return image;
+}
+
+bool ReportCache::storePageImage(const QString &key, int page, int width, const QImage &image)
+{
+    TRACE_SPAN("pdf", "ReportCache::storePageImage");
+
+    // Encoding is the slow part, done before taking the lock
+    QByteArray png;
+    {
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        QImageWriter writer(&buffer, "PNG");
+        writer.setCompression(1); // fast, the cache is bounded anyway
+        if (!writer.write(image)) {
+            return false;
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    if (!ensureDirectory()) {
+        return false;
+    }
+
+    QSaveFile file(pageImagePath(key, page, width));
+    if (!file.open(QIODevice::WriteOnly) || file.write(png) != png.size() || !file.commit()) {
+        m_lastError = "Cannot write page image: " + file.errorString();
+        return false;
+    }
+
+    added(png.size());
+    return true;
+}
+
+void ReportCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QFileInfoList files = m_dir.entryInfoList(QDir::Files);
+    for (const QFileInfo &info : files) {
+        QFile::remove(info.absoluteFilePath());
+    }
+
+    m_sizeBytes = 0;
+    m_hits = 0;
+    m_misses = 0;
+}
+
+qint64 ReportCache::sizeBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_sizeBytes;
+}
+
+qint64 ReportCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+qint64 ReportCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+QString ReportCache::getLastError() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lastError;
+}
+
+QString ReportCache::pdfPath(const QString &key) const
+{
+    return m_dir.filePath(key + ".pdf");
+}
+
+QString ReportCache::pageImagePath(const QString &key, int page, int width) const
+{
+    return m_dir.filePath(QString("%1_p%2_w%3.png").arg(key).arg(page).arg(width));
+}
+
+bool ReportCache::ensureDirectory()
+{
+    if (m_dir.exists() || m_dir.mkpath(".")) {
+        return true;
+    }
+
+    m_lastError = "Cannot create report cache directory " + m_dir.path();
+    return false;
+}
+
+void ReportCache::touch(const QString &path)
+{
+    // Modification time is the LRU clock of the eviction
+    QFile file(path);
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+}
+
+void ReportCache::added(qint64 bytes)
+{
+    m_sizeBytes += bytes;
+    if (m_sizeBytes > m_maxBytes) {
+        evict();
+    }
+}
+
+void ReportCache::evict()
+{
+    // Oldest first, down to 90% of the limit so eviction does not run on every store
+    QFileInfoList files = m_dir.entryInfoList(QDir::Files);
+    std::sort(files.begin(), files.end(), [](const QFileInfo &a, const QFileInfo &b) {
+        return a.lastModified() < b.lastModified();
+    });
+
+    qint64 size = 0;
+    for (const QFileInfo &info : std::as_const(files)) {
+        size += info.size();
+    }
+
+    const qint64 target = m_maxBytes * 9 / 10;
+    int removed = 0;
+    for (const QFileInfo &info : std::as_const(files)) {
+        if (size <= target) {
+            break;
+        }
+        if (QFile::remove(info.absoluteFilePath())) {
+            size -= info.size();
+            ++removed;
+        }
+    }
+
+    m_sizeBytes = size;
+    qCDebug(lcPdf) << "ReportCache: evicted" << removed << "files," << size / 1024 << "KB left";
+}
+
+qint64 ReportCache::scanSize() const
+{
+    qint64 size = 0;
+    const QFileInfoList files = m_dir.entryInfoList(QDir::Files);
+    for (const QFileInfo &info : files) {
+        size += info.size();
+    }
+    return size;
+}
@@ -0,0 +1,56 @@
+#ifndef REPORTCACHE_H
+#define REPORTCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <QDir>
+
+// Disk cache of generated reports, addressed by the hash of everything that
+// goes into a report (PDFExporter::contentHash()). Holds finished PDFs and
+// rendered preview pages; an unchanged report is copied instead of generated.
+// The least recently used files are evicted once the cache grows beyond
+// maxBytes. All methods are thread safe.
+class ReportCache
+{
+public:
+    explicit ReportCache(const QString &directory = defaultDirectory(), qint64 maxBytes = 256 * 1024 * 1024);
+
+    // ~/.crudMahasiswa/reportcache
+    static QString defaultDirectory();
+
+    // Copy the cached PDF for key to filePath (atomically), false on a miss
+    bool fetchPdf(const QString &key, const QString &filePath);
+    bool storePdf(const QString &key, const QString &sourceFilePath);
+
+    // Preview page rendered at width pixels, null image on a miss
+    QImage loadPageImage(const QString &key, int page, int width);
+    bool storePageImage(const QString &key, int page, int width, const QImage &image);
+
+    void clear();
+
+    qint64 sizeBytes() const;
+    qint64 hits() const;
+    qint64 misses() const;
+    QString getLastError() const;
+
+private:
+    QString pdfPath(const QString &key) const;
+    QString pageImagePath(const QString &key, int page, int width) const;
+    bool ensureDirectory();
+    void touch(const QString &path);
+    void added(qint64 bytes);
+    void evict();
+    qint64 scanSize() const;
+
+    mutable QMutex m_mutex;
+    QDir m_dir;
+    qint64 m_maxBytes;
+    qint64 m_sizeBytes;
+    qint64 m_hits;
+    qint64 m_misses;
+    QString m_lastError;
+};
+
+#endif // REPORTCACHE_H
@@ -0,0 +1,202 @@
+#include "reportlayout.h"
+#include "helpers/logging.h"
+#include "helpers/tracer.h"
+#include <QPainter>
+#include <QPdfWriter>
+#include <QSaveFile>
+#include <QDebug>
+
+ReportLayout::ReportLayout(const QPageLayout &pageLayout, int resolution, qsizetype rowCount, CellSource cells)
+    : m_pageLayout(pageLayout)
+    , m_resolution(resolution)
+    , m_metricsDevice(1, 1, QImage::Format_RGB32)
+    , m_rowCount(rowCount)
+    , m_cells(std::move(cells))
+{
+    m_paintRect = m_pageLayout.paintRectPixels(m_resolution);
+
+    m_metricsDevice.setDotsPerMeterX(qRound(m_resolution / 0.0254));
+    m_metricsDevice.setDotsPerMeterY(qRound(m_resolution / 0.0254));
+}
+
+ReportTableRenderer &ReportLayout::renderer()
+{
+    return m_renderer;
+}
+
+void ReportLayout::setup()
+{
+    m_renderer.setup(&m_metricsDevice, QRect(QPoint(0, 0), m_paintRect.size()));
+}
+
+void ReportLayout::paginate()
+{
+    TRACE_SPAN("pdf", "ReportLayout::paginate");
+
+    setup();
+
+    QVector<int> heights(m_rowCount);
+    QStringList cells;
+    for (qsizetype i = 0; i < m_rowCount; ++i) {
+        m_cells(i, cells);
+        heights[i] = m_renderer.rowHeight(cells);
+    }
+
+    paginate(heights);
+}
+
+void ReportLayout::paginate(const QVector<int> &heights)
+{
+    m_heights = heights;
+    m_pages.clear();
+
+    // Same breaks as ReportTableRenderer::addRow()
+    const int header = m_renderer.headerRowHeight();
+    PageSpan page = {0, 0};
+    int y = m_renderer.contentTop(true) + header;
+
+    for (qsizetype i = 0; i < m_rowCount; ++i) {
+        if (y + m_heights[i] > m_renderer.contentBottom() && page.rowCount > 0) {
+            m_pages.append(page);
+            page = {i, 0};
+            y = m_renderer.contentTop(false) + header;
+        }
+
+        y += m_heights[i];
+        ++page.rowCount;
+    }
+
+    m_pages.append(page); // the last (or only, maybe empty) page
+}
+
+int ReportLayout::pageCount() const
+{
+    return m_pages.size();
+}
+
+qsizetype ReportLayout::rowCount() const
+{
+    return m_rowCount;
+}
+
+int ReportLayout::resolution() const
+{
+    return m_resolution;
+}
+
+QPageLayout ReportLayout::pageLayout() const
+{
+    return m_pageLayout;
+}
+
+QSize ReportLayout::pageSizePixels() const
+{
+    return m_pageLayout.fullRectPixels(m_resolution).size();
+}
+
+int ReportLayout::textCacheSize() const
+{
+    return m_renderer.textCacheSize();
+}
+
+void ReportLayout::paintPage(QPainter *painter, int page, ReportTextCache *cache) const
+{
+    if (page < 0 || page >= m_pages.size()) {
+        return;
+    }
+
+    const PageSpan &span = m_pages[page];
+
+    if (page == 0) {
+        m_renderer.paintTitleBlock(painter);
+    }
+
+    int y = m_renderer.contentTop(page == 0);
+    m_renderer.paintHeaderRow(painter, y, cache);
+    y += m_renderer.headerRowHeight();
+
+    QStringList cells;
+    for (qsizetype i = span.firstRow; i < span.firstRow + span.rowCount; ++i) {
+        m_cells(i, cells);
+        m_renderer.paintRow(painter, y, m_heights[i], cells, i, cache);
+        y += m_heights[i];
+    }
+}
+
+QImage ReportLayout::renderPage(int page, qreal scale, ReportTextCache *cache) const
+{
+    TRACE_SPAN("pdf", "ReportLayout::renderPage");
+
+    const QSize size = pageSizePixels() * scale;
+    QImage image(size.expandedTo(QSize(1, 1)), QImage::Format_RGB32);
+    image.fill(Qt::white);
+
+    // Fonts resolve against the image resolution, so text keeps the layout
+    // size in layout pixels and is scaled down with everything else
+    image.setDotsPerMeterX(m_metricsDevice.dotsPerMeterX());
+    image.setDotsPerMeterY(m_metricsDevice.dotsPerMeterY());
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.scale(scale, scale);
+    painter.translate(m_paintRect.topLeft());
+    paintPage(&painter, page, cache);
+    painter.end();
+
+    return image;
+}
+
+bool ReportLayout::print(QPagedPaintDevice *device, const std::atomic<bool> *cancel) const
+{
+    TRACE_SPAN("pdf", "ReportLayout::print");
+
+    QPainter painter;
+    if (!painter.begin(device)) {
+        qCWarning(lcPdf) << "ReportLayout: Cannot start painting on the output device";
+        return false;
+    }
+
+    ReportTextCache textCache(m_renderer.textCacheSize());
+    ReportTextCache *cache = m_renderer.textCacheSize() > 0 ? &textCache : nullptr;
+
+    for (int page = 0; page < m_pages.size(); ++page) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            painter.end();
+            return false;
+        }
+
+        if (page > 0 && !device->newPage()) {
+            painter.end();
+            return false;
+        }
+
+        paintPage(&painter, page, cache);
+    }
+
+    return painter.end();
+}
+
+bool ReportLayout::exportToPdf(const QString &filePath) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcPdf) << "ReportLayout: Cannot open" << filePath << ":" << file.errorString();
+        return false;
+    }
+
+    bool success;
+    {
+        QPdfWriter writer(&file);
+        writer.setResolution(m_resolution);
+        writer.setPageLayout(m_pageLayout);
+        success = print(&writer);
+    }
+
+    if (!success) {
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
+}
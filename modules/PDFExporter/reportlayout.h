@@ -0,0 +1,74 @@
+#ifndef REPORTLAYOUT_H
+#define REPORTLAYOUT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QImage>
+#include <QPageLayout>
+#include <QPagedPaintDevice>
+#include <functional>
+#include <atomic>
+#include "reporttablerenderer.h"
+
+// A report table broken into pages once, then painted page by page as often as
+// needed: preview images at any zoom, printing, PDF export. All painting
+// methods are const and may run on worker threads at the same time.
+class ReportLayout
+{
+public:
+    // Fills cells with the cells of row index (must be callable from any thread)
+    using CellSource = std::function<void(qsizetype index, QStringList &cells)>;
+
+    ReportLayout(const QPageLayout &pageLayout, int resolution, qsizetype rowCount, CellSource cells);
+
+    // Configure appearance here, then call paginate()
+    ReportTableRenderer &renderer();
+
+    // Fonts and columns for the page, after this renderer() can measure rows
+    void setup();
+
+    // Break the rows into pages (sizes in device pixels of resolution).
+    // The second form takes heights measured beforehand with a set up renderer().
+    void paginate();
+    void paginate(const QVector<int> &heights);
+
+    int pageCount() const;
+    qsizetype rowCount() const;
+    int resolution() const;
+    QPageLayout pageLayout() const;
+    QSize pageSizePixels() const; // whole page including margins
+    int textCacheSize() const;    // as configured on renderer()
+
+    // Paint page with the painter origin at the top left of the printable area
+    // cache: shaped text cache of the calling thread, or nullptr
+    void paintPage(QPainter *painter, int page, ReportTextCache *cache = nullptr) const;
+
+    // Whole page (white margins included) scaled by scale, e.g. for a preview
+    QImage renderPage(int page, qreal scale, ReportTextCache *cache = nullptr) const;
+
+    // Paint every page onto a device set up with pageLayout() and resolution()
+    bool print(QPagedPaintDevice *device, const std::atomic<bool> *cancel = nullptr) const;
+
+    // Write the pages to filePath (temporary file renamed when complete)
+    bool exportToPdf(const QString &filePath) const;
+
+private:
+    struct PageSpan
+    {
+        qsizetype firstRow;
+        qsizetype rowCount;
+    };
+
+    QPageLayout m_pageLayout;
+    int m_resolution;
+    QRect m_paintRect;       // printable area inside the page
+    QImage m_metricsDevice;  // resolution only, fonts resolve against it
+    ReportTableRenderer m_renderer;
+    qsizetype m_rowCount;
+    CellSource m_cells;
+    QVector<int> m_heights;
+    QVector<PageSpan> m_pages;
+};
+
+#endif // REPORTLAYOUT_H
@@ -0,0 +1,83 @@
+#include "reportpreviewdialog.h"
+#include "helpers/logging.h"
+#include <QVBoxLayout>
+#include <QToolBar>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QDebug>
+
+ReportPreviewDialog::ReportPreviewDialog(std::shared_ptr<const ReportLayout> layout, QWidget *parent)
+    : QDialog{parent}
+    , m_layout(std::move(layout))
+    , m_preview(new ReportPreviewWidget(this))
+    , m_pageLabel(new QLabel(this))
+{
+    QToolBar *toolBar = new QToolBar(this);
+    toolBar->addAction("Zoom Out", m_preview, &ReportPreviewWidget::zoomOut);
+    toolBar->addAction("Zoom In", m_preview, &ReportPreviewWidget::zoomIn);
+    toolBar->addAction("Fit Width", m_preview, &ReportPreviewWidget::fitWidth);
+    toolBar->addSeparator();
+    toolBar->addAction("Export PDF", this, &ReportPreviewDialog::exportPdf);
+    toolBar->addSeparator();
+    toolBar->addWidget(m_pageLabel);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(0, 0, 0, 0);
+    mainLayout->setSpacing(0);
+    mainLayout->addWidget(toolBar);
+    mainLayout->addWidget(m_preview);
+
+    connect(m_preview, &ReportPreviewWidget::currentPageChanged, this, &ReportPreviewDialog::updatePageLabel);
+
+    m_preview->setReportLayout(m_layout);
+    updatePageLabel();
+
+    resize(900, 1000);
+}
+
+void ReportPreviewDialog::setPageImageCache(ReportCache *cache, const QString &key)
+{
+    m_preview->setPageImageCache(cache, key);
+}
+
+QString ReportPreviewDialog::exportedFilePath() const
+{
+    return m_exportedFilePath;
+}
+
+void ReportPreviewDialog::exportPdf()
+{
+    QString filePath = QFileDialog::getSaveFileName(this, "Simpan PDF", QDir::homePath(), "PDF Files (*.pdf)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    if (!filePath.endsWith(".pdf", Qt::CaseInsensitive)) {
+        filePath += ".pdf";
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool success = m_layout->exportToPdf(filePath);
+    QApplication::restoreOverrideCursor();
+
+    qCDebug(lcPdf) << "ReportPreviewDialog: exported" << m_layout->pageCount() << "pages from the preview layout in"
+                   << timer.elapsed() << "ms";
+
+    if (!success) {
+        QMessageBox::critical(this, "Error", "Gagal menyimpan PDF ke " + filePath);
+        return;
+    }
+
+    m_exportedFilePath = filePath;
+    accept();
+}
+
+void ReportPreviewDialog::updatePageLabel()
+{
+    m_pageLabel->setText(QString("  Halaman %1 / %2").arg(m_preview->currentPage() + 1).arg(m_layout->pageCount()));
+}
@@ -0,0 +1,36 @@
+#ifndef REPORTPREVIEWDIALOG_H
+#define REPORTPREVIEWDIALOG_H
+
+#include <QDialog>
+#include <QLabel>
+#include <memory>
+#include "reportlayout.h"
+#include "reportpreviewwidget.h"
+#include "reportcache.h"
+
+// Preview window for a ReportLayout with zoom controls and "Export PDF",
+// which writes the already paginated layout instead of laying it out again.
+class ReportPreviewDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit ReportPreviewDialog(std::shared_ptr<const ReportLayout> layout, QWidget *parent = nullptr);
+
+    // See ReportPreviewWidget::setPageImageCache()
+    void setPageImageCache(ReportCache *cache, const QString &key);
+
+    // File written by the last successful export, empty if none
+    QString exportedFilePath() const;
+
+private slots:
+    void exportPdf();
+    void updatePageLabel();
+
+private:
+    std::shared_ptr<const ReportLayout> m_layout;
+    ReportPreviewWidget *m_preview;
+    QLabel *m_pageLabel;
+    QString m_exportedFilePath;
+};
+
+#endif // REPORTPREVIEWDIALOG_H
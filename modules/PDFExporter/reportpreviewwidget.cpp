@@ -0,0 +1,328 @@
+#include "reportpreviewwidget.h"
+#include <QPainter>
+#include <QScrollBar>
+#include <QWheelEvent>
+
+namespace {
+constexpr int PAGE_GAP = 16;      // between pages and around them
+constexpr qreal MIN_ZOOM = 0.1;
+constexpr qreal MAX_ZOOM = 4.0;
+constexpr qreal ZOOM_STEP = 1.25;
+}
+
+ReportPreviewWidget::ReportPreviewWidget(QWidget *parent)
+    : QAbstractScrollArea{parent}
+    , m_zoom(1.0)
+    , m_fitWidth(true)
+    , m_currentPage(0)
+    , m_diskCache(nullptr)
+    , m_generation(0)
+    , m_cacheHits(0)
+    , m_cacheMisses(0)
+{
+    m_cache.setMaxCost(64 * 1024);
+
+    // Pages are rendered one or two at a time, the rest of the pool is not needed
+    m_pool.setMaxThreadCount(2);
+
+    viewport()->setBackgroundRole(QPalette::Dark);
+    viewport()->setAutoFillBackground(true);
+    verticalScrollBar()->setSingleStep(PAGE_GAP * 2);
+}
+
+ReportPreviewWidget::~ReportPreviewWidget()
+{
+    // Queued results for a deleted widget are discarded by Qt
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void ReportPreviewWidget::setReportLayout(std::shared_ptr<const ReportLayout> layout)
+{
+    m_layout = std::move(layout);
+    m_cache.clear();
+    m_pending.clear();
+    ++m_generation;
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
+    m_currentPage = 0;
+
+    if (m_fitWidth) {
+        fitWidth();
+    } else {
+        updateScrollBars();
+        viewport()->update();
+    }
+}
+
+std::shared_ptr<const ReportLayout> ReportPreviewWidget::reportLayout() const
+{
+    return m_layout;
+}
+
+void ReportPreviewWidget::setZoom(qreal zoom)
+{
+    zoom = qBound(MIN_ZOOM, zoom, MAX_ZOOM);
+    if (qFuzzyCompare(zoom, m_zoom)) {
+        return;
+    }
+
+    // Keep the same part of the document in view
+    const qreal position = verticalScrollBar()->maximum() > 0
+        ? qreal(verticalScrollBar()->value()) / verticalScrollBar()->maximum() : 0.0;
+
+    m_zoom = zoom;
+    m_pending.clear();
+    ++m_generation;
+
+    updateScrollBars();
+    verticalScrollBar()->setValue(qRound(position * verticalScrollBar()->maximum()));
+    viewport()->update();
+
+    emit zoomChanged(m_zoom);
+}
+
+qreal ReportPreviewWidget::zoom() const
+{
+    return m_zoom;
+}
+
+void ReportPreviewWidget::setPageImageCache(ReportCache *cache, const QString &key)
+{
+    m_diskCache = cache;
+    m_diskCacheKey = key;
+}
+
+void ReportPreviewWidget::setCacheSize(int megabytes)
+{
+    m_cache.setMaxCost(qMax(1, megabytes) * 1024);
+}
+
+int ReportPreviewWidget::currentPage() const
+{
+    return m_currentPage;
+}
+
+qint64 ReportPreviewWidget::cacheHits() const
+{
+    return m_cacheHits;
+}
+
+qint64 ReportPreviewWidget::cacheMisses() const
+{
+    return m_cacheMisses;
+}
+
+void ReportPreviewWidget::zoomIn()
+{
+    m_fitWidth = false;
+    setZoom(m_zoom * ZOOM_STEP);
+}
+
+void ReportPreviewWidget::zoomOut()
+{
+    m_fitWidth = false;
+    setZoom(m_zoom / ZOOM_STEP);
+}
+
+void ReportPreviewWidget::fitWidth()
+{
+    m_fitWidth = true;
+
+    if (!m_layout) {
+        return;
+    }
+
+    // Page width at 100% in device independent pixels
+    const qreal pageWidth = m_layout->pageSizePixels().width() * logicalDpiX() / qreal(m_layout->resolution());
+    const int available = viewport()->width() - 2 * PAGE_GAP;
+
+    if (pageWidth > 0 && available > 0) {
+        setZoom(available / pageWidth);
+    }
+    updateScrollBars();
+}
+
+void ReportPreviewWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(viewport());
+
+    if (!m_layout || m_layout->pageCount() == 0) {
+        return;
+    }
+
+    const QSize pageSize = pageDisplaySize();
+    const int stride = pageStride();
+    const int top = verticalScrollBar()->value();
+    const int left = qMax(PAGE_GAP, (viewport()->width() - pageSize.width()) / 2) - horizontalScrollBar()->value();
+
+    const int first = qMax(0, (top - PAGE_GAP) / stride);
+    const int last = qMin(m_layout->pageCount() - 1, (top + viewport()->height()) / stride);
+
+    for (int page = first; page <= last; ++page) {
+        const QRect pageRect(QPoint(left, PAGE_GAP + page * stride - top), pageSize);
+
+        if (const QImage *image = m_cache.object(cacheKey(page))) {
+            ++m_cacheHits;
+            painter.drawImage(pageRect, *image);
+        } else {
+            ++m_cacheMisses;
+            painter.fillRect(pageRect, Qt::white);
+            requestPage(page);
+        }
+
+        painter.setPen(palette().color(QPalette::Shadow));
+        painter.drawRect(pageRect.adjusted(0, 0, -1, -1));
+    }
+
+    // Pre-render the page right below the view, scrolling down is the usual case
+    if (last + 1 < m_layout->pageCount() && !m_cache.contains(cacheKey(last + 1))) {
+        requestPage(last + 1);
+    }
+}
+
+void ReportPreviewWidget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+
+    if (m_fitWidth) {
+        fitWidth();
+    } else {
+        updateScrollBars();
+    }
+}
+
+void ReportPreviewWidget::wheelEvent(QWheelEvent *event)
+{
+    if (event->modifiers() & Qt::ControlModifier) {
+        if (event->angleDelta().y() > 0) {
+            zoomIn();
+        } else if (event->angleDelta().y() < 0) {
+            zoomOut();
+        }
+        event->accept();
+        return;
+    }
+
+    QAbstractScrollArea::wheelEvent(event);
+}
+
+void ReportPreviewWidget::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx)
+    Q_UNUSED(dy)
+
+    updateCurrentPage();
+    viewport()->update();
+}
+
+qreal ReportPreviewWidget::pageScale() const
+{
+    return m_layout ? m_zoom * logicalDpiX() / qreal(m_layout->resolution()) : m_zoom;
+}
+
+QSize ReportPreviewWidget::pageDisplaySize() const
+{
+    return m_layout ? m_layout->pageSizePixels() * pageScale() : QSize();
+}
+
+int ReportPreviewWidget::pageStride() const
+{
+    return qMax(1, pageDisplaySize().height() + PAGE_GAP);
+}
+
+quint64 ReportPreviewWidget::cacheKey(int page) const
+{
+    // Same page at another zoom is another image
+    return (quint64(qRound(m_zoom * 1000)) << 32) | quint32(page);
+}
+
+void ReportPreviewWidget::updateScrollBars()
+{
+    if (!m_layout) {
+        verticalScrollBar()->setRange(0, 0);
+        horizontalScrollBar()->setRange(0, 0);
+        return;
+    }
+
+    const QSize pageSize = pageDisplaySize();
+    const int contentHeight = PAGE_GAP + m_layout->pageCount() * pageStride();
+    const int contentWidth = pageSize.width() + 2 * PAGE_GAP;
+
+    verticalScrollBar()->setPageStep(viewport()->height());
+    verticalScrollBar()->setRange(0, qMax(0, contentHeight - viewport()->height()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setRange(0, qMax(0, contentWidth - viewport()->width()));
+
+    updateCurrentPage();
+}
+
+void ReportPreviewWidget::requestPage(int page)
+{
+    const quint64 key = cacheKey(page);
+    if (m_pending.contains(key)) {
+        return;
+    }
+    m_pending.insert(key);
+
+    const std::shared_ptr<const ReportLayout> layout = m_layout;
+    const qreal scale = pageScale() * devicePixelRatioF();
+    const qreal ratio = devicePixelRatioF();
+    const int generation = m_generation;
+
+    ReportCache *diskCache = m_diskCache;
+    const QString diskKey = m_diskCacheKey;
+
+    m_pool.start([this, layout, page, scale, ratio, generation, diskCache, diskKey]() {
+        // Glyph runs belong to the thread that shaped them, one cache per pool thread
+        thread_local ReportTextCache textCache;
+
+        const int width = qRound(layout->pageSizePixels().width() * scale);
+        QImage image = diskCache ? diskCache->loadPageImage(diskKey, page, width) : QImage();
+        const bool rendered = image.isNull();
+
+        if (rendered) {
+            image = layout->renderPage(page, scale, layout->textCacheSize() > 0 ? &textCache : nullptr);
+        }
+        image.setDevicePixelRatio(ratio);
+
+        QMetaObject::invokeMethod(this, [this, page, generation, image]() {
+            pageRendered(page, generation, image);
+        }, Qt::QueuedConnection);
+
+        // Written after the page is shown, the view does not wait for the encoder
+        if (rendered && diskCache) {
+            diskCache->storePageImage(diskKey, page, width, image);
+        }
+    });
+}
+
+void ReportPreviewWidget::pageRendered(int page, int generation, const QImage &image)
+{
+    if (generation != m_generation) {
+        return; // zoom or layout changed meanwhile
+    }
+
+    const quint64 key = cacheKey(page);
+    m_pending.remove(key);
+    m_cache.insert(key, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+
+    viewport()->update();
+}
+
+void ReportPreviewWidget::updateCurrentPage()
+{
+    if (!m_layout) {
+        return;
+    }
+
+    const int middle = verticalScrollBar()->value() + viewport()->height() / 2;
+    const int page = qBound(0, middle / pageStride(), m_layout->pageCount() - 1);
+
+    if (page != m_currentPage) {
+        m_currentPage = page;
+        emit currentPageChanged(m_currentPage);
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef REPORTPREVIEWWIDGET_H
+#define REPORTPREVIEWWIDGET_H
+
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QSet>
+#include <QImage>
+#include <QThreadPool>
+#include <memory>
+#include "reportlayout.h"
+#include "reportcache.h"
+
+// Scrollable preview of a ReportLayout. Only the pages in view are rendered,
+// on a worker thread, and the images are kept in an LRU cache bounded in
+// memory. Zooming renders the visible pages again, nothing is laid out twice.
+class ReportPreviewWidget : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    explicit ReportPreviewWidget(QWidget *parent = nullptr);
+    ~ReportPreviewWidget(); // waits for pages being rendered
+
+    void setReportLayout(std::shared_ptr<const ReportLayout> layout);
+    std::shared_ptr<const ReportLayout> reportLayout() const;
+
+    // 1.0 = 100% (page at its physical size on screen)
+    void setZoom(qreal zoom);
+    qreal zoom() const;
+
+    // Also keep rendered pages in a disk cache under key (the report's content
+    // hash), so reopening an unchanged report does not render them again
+    void setPageImageCache(ReportCache *cache, const QString &key);
+
+    // Memory used by cached page images (default: 64 MB)
+    void setCacheSize(int megabytes);
+
+    int currentPage() const;
+
+    // Cache statistics since the layout was set
+    qint64 cacheHits() const;
+    qint64 cacheMisses() const;
+
+public slots:
+    void zoomIn();
+    void zoomOut();
+    void fitWidth();
+
+signals:
+    void currentPageChanged(int page);
+    void zoomChanged(qreal zoom);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    qreal pageScale() const;      // layout pixels to device independent pixels
+    QSize pageDisplaySize() const;
+    int pageStride() const;       // page height plus the gap below it
+    quint64 cacheKey(int page) const;
+    void updateScrollBars();
+    void requestPage(int page);
+    void pageRendered(int page, int generation, const QImage &image);
+    void updateCurrentPage();
+
+    std::shared_ptr<const ReportLayout> m_layout;
+    qreal m_zoom;
+    bool m_fitWidth;
+    int m_currentPage;
+
+    QCache<quint64, QImage> m_cache; // cost in KB
+    ReportCache *m_diskCache;
+    QString m_diskCacheKey;
+    QSet<quint64> m_pending;
+    QThreadPool m_pool;
+    int m_generation; // bumped on zoom/layout changes, stale renders are dropped
+    qint64 m_cacheHits;
+    qint64 m_cacheMisses;
+};
+
+#endif // REPORTPREVIEWWIDGET_H
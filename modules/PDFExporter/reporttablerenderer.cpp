@@ -0,0 +1,440 @@
+#include "reporttablerenderer.h"
+#include <QPageLayout>
+
+ReportTableRenderer::ReportTableRenderer()
+    : m_headerColor("#D3D3D3")
+    , m_zebraEvenColor("#FFFFFF")
+    , m_zebraOddColor("#F0F0F0")
+    , m_font("Arial", 10)
+    , m_device(nullptr)
+    , m_dpiX(96)
+    , m_dpiY(96)
+    , m_padding(1)
+    , m_lineWidth(1)
+    , m_titleHeight(0)
+    , m_headerHeight(0)
+    , m_textCacheSize(4096)
+    , m_pagedDevice(nullptr)
+    , m_y(0)
+    , m_rowsOnPage(0)
+    , m_pageCount(0)
+    , m_rowCount(0)
+{
+}
+
+void ReportTableRenderer::setTitle(const QString &title)
+{
+    m_title = title;
+}
+
+void ReportTableRenderer::setSubtitle(const QString &subtitle)
+{
+    m_subtitle = subtitle;
+}
+
+void ReportTableRenderer::setHeaders(const QStringList &headers)
+{
+    m_headers = headers;
+
+    m_headerLabels.clear();
+    for (const QString &header : headers) {
+        m_headerLabels.append(header.toUpper());
+    }
+}
+
+void ReportTableRenderer::setHeaderColor(const QColor &color)
+{
+    m_headerColor = color;
+}
+
+void ReportTableRenderer::setZebraColors(const QColor &evenColor, const QColor &oddColor)
+{
+    m_zebraEvenColor = evenColor;
+    m_zebraOddColor = oddColor;
+}
+
+void ReportTableRenderer::setFont(const QFont &font)
+{
+    m_font = font;
+}
+
+void ReportTableRenderer::setTextCacheSize(int entries)
+{
+    m_textCacheSize = qMax(0, entries);
+    m_textCache.setMaxEntries(m_textCacheSize);
+}
+
+int ReportTableRenderer::textCacheSize() const
+{
+    return m_textCacheSize;
+}
+
+const ReportTextCache &ReportTableRenderer::textCache() const
+{
+    return m_textCache;
+}
+
+void ReportTableRenderer::setup(QPaintDevice *device, const QRect &pageRect)
+{
+    m_device = device;
+    m_pageRect = pageRect;
+    m_dpiX = device->logicalDpiX();
+    m_dpiY = device->logicalDpiY();
+
+    // Paddings are given in 96 dpi pixels, like the HTML stylesheet
+    const qreal scale = device->logicalDpiY() / 96.0;
+    m_padding = qMax(1, qRound(6 * scale));
+    m_lineWidth = qMax(1, qRound(scale));
+
+    m_titleFont = m_font;
+    m_titleFont.setPointSizeF(m_font.pointSizeF() * 1.8);
+    m_titleFont.setBold(true);
+
+    m_headerFont = m_font;
+    m_headerFont.setBold(true);
+
+    setColumns(m_headers);
+
+    // Title, date line and separator on the first page
+    m_titleHeight = 0;
+    if (!m_title.isEmpty()) {
+        m_titleHeight += QFontMetrics(m_titleFont, device).height() + m_padding;
+    }
+    if (!m_subtitle.isEmpty()) {
+        m_titleHeight += QFontMetrics(m_font, device).height() + m_padding;
+    }
+    m_titleHeight += 3 * m_padding; // separator line with spacing around it
+
+}
+
+void ReportTableRenderer::setColumns(const QStringList &headers)
+{
+    m_headerLabels.clear();
+    for (const QString &header : headers) {
+        m_headerLabels.append(header.toUpper());
+    }
+
+    // Equal column widths, same as the HTML table (table-layout: fixed)
+    const int columns = qMax(1, int(headers.size()));
+    m_columnX.clear();
+    m_columnX.reserve(columns + 1);
+    for (int i = 0; i <= columns; ++i) {
+        m_columnX.append(m_pageRect.left() + int(qint64(m_pageRect.width()) * i / columns));
+    }
+
+    m_headerHeight = measureRow(QFontMetrics(m_headerFont, m_device), m_headerLabels);
+}
+
+int ReportTableRenderer::titleBlockHeight() const
+{
+    return m_titleHeight;
+}
+
+int ReportTableRenderer::headerRowHeight() const
+{
+    return m_headerHeight;
+}
+
+int ReportTableRenderer::rowHeight(const QStringList &cells) const
+{
+    return rowHeight(QFontMetrics(m_font, m_device), cells);
+}
+
+int ReportTableRenderer::rowHeight(const QFontMetrics &metrics, const QStringList &cells) const
+{
+    const int height = measureRow(metrics, cells);
+
+    // A row never gets taller than an empty page, longer text is clipped
+    return qMin(height, m_pageRect.height() - m_headerHeight);
+}
+
+QFontMetrics ReportTableRenderer::createFontMetrics() const
+{
+    // A tiny image with the device resolution, so the metrics match the output
+    // device without touching it from another thread
+    QImage probe(1, 1, QImage::Format_RGB32);
+    probe.setDotsPerMeterX(qRound(m_dpiX / 0.0254));
+    probe.setDotsPerMeterY(qRound(m_dpiY / 0.0254));
+    return QFontMetrics(m_font, &probe);
+}
+
+int ReportTableRenderer::contentTop(bool firstPage) const
+{
+    return m_pageRect.top() + (firstPage ? m_titleHeight : 0);
+}
+
+int ReportTableRenderer::contentBottom() const
+{
+    return m_pageRect.top() + m_pageRect.height();
+}
+
+void ReportTableRenderer::paintTitleBlock(QPainter *painter) const
+{
+    int y = m_pageRect.top();
+    const int left = m_pageRect.left();
+    const int width = m_pageRect.width();
+
+    painter->setPen(QColor("#333333"));
+
+    if (!m_title.isEmpty()) {
+        const int height = QFontMetrics(m_titleFont, m_device).height();
+        painter->setFont(m_titleFont);
+        painter->drawText(QRect(left, y, width, height), Qt::AlignLeft | Qt::AlignVCenter, m_title);
+        y += height + m_padding;
+    }
+
+    if (!m_subtitle.isEmpty()) {
+        const int height = QFontMetrics(m_font, m_device).height();
+        painter->setFont(m_font);
+        painter->drawText(QRect(left, y, width, height), Qt::AlignLeft | Qt::AlignVCenter, m_subtitle);
+        y += height + m_padding;
+    }
+
+    // <hr/>
+    y += m_padding;
+    painter->setPen(QPen(QColor("#CCCCCC"), m_lineWidth));
+    painter->drawLine(left, y, left + width, y);
+}
+
+void ReportTableRenderer::paintHeaderRow(QPainter *painter, int y, ReportTextCache *cache) const
+{
+    paintCells(painter, y, m_headerHeight, m_headerLabels, m_headerColor, m_headerFont, cache);
+}
+
+void ReportTableRenderer::paintRow(QPainter *painter, int y, int height, const QStringList &cells, qsizetype rowIndex,
+                                   ReportTextCache *cache) const
+{
+    paintCells(painter, y, height, cells, (rowIndex % 2 == 0) ? m_zebraEvenColor : m_zebraOddColor, m_font, cache);
+}
+
+bool ReportTableRenderer::begin(QPagedPaintDevice *device)
+{
+    m_pagedDevice = device;
+
+    if (!m_painter.begin(device)) {
+        return false;
+    }
+
+    // Painter coordinates start at the top left of the printable area
+    const QRect paintRect = device->pageLayout().paintRectPixels(device->logicalDpiX());
+    setup(device, QRect(QPoint(0, 0), paintRect.size()));
+
+    m_pageCount = 1;
+    m_rowCount = 0;
+    m_rowsOnPage = 0;
+
+    m_textCache.clear();
+
+    paintTitleBlock(&m_painter);
+    m_y = contentTop(true);
+    paintHeaderRow(&m_painter, m_y, streamTextCache());
+    m_y += m_headerHeight;
+
+    return true;
+}
+
+bool ReportTableRenderer::addRow(const QStringList &cells)
+{
+    if (!m_painter.isActive()) {
+        return false;
+    }
+
+    return addRow(cells, rowHeight(cells));
+}
+
+bool ReportTableRenderer::addRow(const QStringList &cells, int height)
+{
+    if (!m_painter.isActive()) {
+        return false;
+    }
+
+    if (m_y + height > contentBottom() && m_rowsOnPage > 0) {
+        if (!newPage()) {
+            return false;
+        }
+    }
+
+    paintRow(&m_painter, m_y, height, cells, m_rowCount, streamTextCache());
+    m_y += height;
+    ++m_rowsOnPage;
+    ++m_rowCount;
+
+    return true;
+}
+
+bool ReportTableRenderer::addGroupHeader(const QString &label)
+{
+    if (!m_painter.isActive()) {
+        return false;
+    }
+
+    const QFontMetrics metrics(m_headerFont, m_device);
+    const int width = m_pageRect.width() - 2 * m_padding;
+    const int textHeight = label.isEmpty() ? metrics.height()
+                                           : metrics.boundingRect(QRect(0, 0, width, 1 << 24), Qt::TextWordWrap, label).height();
+    const int height = qMin(textHeight + 2 * m_padding, m_pageRect.height() / 2);
+
+    // Keep the band together with at least one row of its group
+    const int withFirstRow = height + QFontMetrics(m_font, m_device).height() + 2 * m_padding;
+    if (m_y + withFirstRow > contentBottom() && m_rowsOnPage > 0) {
+        if (!newPage()) {
+            return false;
+        }
+    }
+
+    const QRect band(m_pageRect.left(), m_y, m_pageRect.width(), height);
+    m_painter.fillRect(band, m_headerColor.darker(110));
+    m_painter.setPen(QPen(Qt::black, m_lineWidth));
+    m_painter.drawRect(band);
+    m_painter.setFont(m_headerFont);
+    m_painter.drawText(band.adjusted(m_padding, m_padding, -m_padding, -m_padding),
+                       Qt::AlignLeft | Qt::AlignVCenter | Qt::TextWordWrap, label);
+
+    m_y += height;
+    ++m_rowsOnPage;
+
+    return true;
+}
+
+bool ReportTableRenderer::addSummaryPage(const QString &title, const QStringList &headers, const QList<QStringList> &rows)
+{
+    if (!m_painter.isActive() || !m_pagedDevice->newPage()) {
+        return false;
+    }
+    ++m_pageCount;
+
+    // Title of the summary, then its own table
+    const int titleHeight = QFontMetrics(m_titleFont, m_device).height();
+    m_painter.setPen(QColor("#333333"));
+    m_painter.setFont(m_titleFont);
+    m_painter.drawText(QRect(m_pageRect.left(), m_pageRect.top(), m_pageRect.width(), titleHeight),
+                       Qt::AlignLeft | Qt::AlignVCenter, title);
+
+    const QStringList savedHeaders = m_headers;
+    setColumns(headers);
+
+    m_y = m_pageRect.top() + titleHeight + 2 * m_padding;
+    paintHeaderRow(&m_painter, m_y, streamTextCache());
+    m_y += m_headerHeight;
+    m_rowsOnPage = 0;
+
+    bool success = true;
+    for (qsizetype i = 0; i < rows.size() && success; ++i) {
+        const int height = rowHeight(rows[i]);
+        if (m_y + height > contentBottom() && m_rowsOnPage > 0) {
+            success = newPage();
+        }
+        if (success) {
+            paintRow(&m_painter, m_y, height, rows[i], i, streamTextCache());
+            m_y += height;
+            ++m_rowsOnPage;
+        }
+    }
+
+    // Back to the report columns for anything added afterwards
+    setColumns(savedHeaders);
+    return success;
+}
+
+bool ReportTableRenderer::end()
+{
+    if (!m_painter.isActive()) {
+        return false;
+    }
+
+    return m_painter.end();
+}
+
+int ReportTableRenderer::pageCount() const
+{
+    return m_pageCount;
+}
+
+qsizetype ReportTableRenderer::rowCount() const
+{
+    return m_rowCount;
+}
+
+int ReportTableRenderer::measureCell(const QFontMetrics &metrics, const QString &text, int column) const
+{
+    const int available = qMax(1, m_columnX[column + 1] - m_columnX[column] - 2 * m_padding);
+
+    // Most cells fit on one line, skip the word wrap layout for them
+    if (text.isEmpty() || (metrics.horizontalAdvance(text) <= available && !text.contains('\n'))) {
+        return metrics.height();
+    }
+
+    return metrics.boundingRect(QRect(0, 0, available, 1 << 24), Qt::TextWordWrap, text).height();
+}
+
+int ReportTableRenderer::measureRow(const QFontMetrics &metrics, const QStringList &cells) const
+{
+    int height = metrics.height();
+    const int columns = m_columnX.size() - 1;
+
+    for (int i = 0; i < qMin(columns, int(cells.size())); ++i) {
+        height = qMax(height, measureCell(metrics, cells[i], i));
+    }
+
+    return height + 2 * m_padding;
+}
+
+void ReportTableRenderer::paintCells(QPainter *painter, int y, int height, const QStringList &cells,
+                                     const QColor &background, const QFont &font, ReportTextCache *cache) const
+{
+    const int columns = m_columnX.size() - 1;
+    const QRect rowRect(m_columnX.first(), y, m_columnX.last() - m_columnX.first(), height);
+
+    painter->fillRect(rowRect, background);
+    painter->setFont(font);
+    painter->setPen(QPen(Qt::black, m_lineWidth));
+
+    const QString fontKey = cache ? ReportTextCache::fontKey(font, painter->device()) : QString();
+
+    for (int i = 0; i < columns; ++i) {
+        const QRect cellRect(m_columnX[i], y, m_columnX[i + 1] - m_columnX[i], height);
+        painter->drawRect(cellRect);
+
+        // Handle column count mismatch gracefully, missing cells stay empty
+        if (i >= cells.size() || cells[i].isEmpty()) {
+            continue;
+        }
+
+        const QRect textRect = cellRect.adjusted(m_padding, m_padding, -m_padding, -m_padding);
+
+        if (!cache) {
+            painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextWordWrap, cells[i]);
+            continue;
+        }
+
+        // Vertically centred like Qt::AlignVCenter
+        const ReportTextCache::ShapedText *shaped =
+            cache->shapedText(cells[i], font, fontKey, textRect.width(), painter->device());
+        const QPointF origin(textRect.left(), textRect.top() + (textRect.height() - shaped->height) / 2);
+
+        for (const QGlyphRun &run : shaped->glyphRuns) {
+            painter->drawGlyphRun(origin, run);
+        }
+    }
+}
+
+ReportTextCache *ReportTableRenderer::streamTextCache()
+{
+    return m_textCacheSize > 0 ? &m_textCache : nullptr;
+}
+
+bool ReportTableRenderer::newPage()
+{
+    if (!m_pagedDevice->newPage()) {
+        return false;
+    }
+
+    ++m_pageCount;
+    m_rowsOnPage = 0;
+
+    m_y = contentTop(false);
+    paintHeaderRow(&m_painter, m_y, streamTextCache());
+    m_y += m_headerHeight;
+
+    return true;
+}
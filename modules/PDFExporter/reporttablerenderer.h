@@ -0,0 +1,119 @@
+#ifndef REPORTTABLERENDERER_H
+#define REPORTTABLERENDERER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QColor>
+#include <QFont>
+#include <QFontMetrics>
+#include <QRect>
+#include <QPainter>
+#include <QPagedPaintDevice>
+#include <QImage>
+#include "reporttextcache.h"
+
+// Paints a report table straight onto a paged device (QPrinter, QPdfWriter) with
+// QPainter: rows are measured with QFontMetrics, pages are broken by the renderer
+// itself and the header row is repeated on every page. Nothing but the current
+// row is kept in memory, unlike the QTextDocument path which lays out the whole
+// table before printing.
+class ReportTableRenderer
+{
+public:
+    ReportTableRenderer();
+
+    // Appearance, same options as PDFExporter
+    void setTitle(const QString &title);
+    void setSubtitle(const QString &subtitle);
+    void setHeaders(const QStringList &headers);
+    void setHeaderColor(const QColor &color);
+    void setZebraColors(const QColor &evenColor, const QColor &oddColor);
+    void setFont(const QFont &font);
+
+    // Entries of the shaped text cache used by begin()/addRow() (default: 4096, 0 = no cache)
+    void setTextCacheSize(int entries);
+    int textCacheSize() const;
+    const ReportTextCache &textCache() const;
+
+    // Compute fonts, paddings and column edges for pageRect (device pixels) of device
+    void setup(QPaintDevice *device, const QRect &pageRect);
+
+    // Layout in device pixels (valid after setup)
+    int titleBlockHeight() const;
+    int headerRowHeight() const;
+    int rowHeight(const QStringList &cells) const;
+    // Same, with metrics from createFontMetrics(). Font engines are per thread,
+    // so every thread measuring rows needs its own metrics.
+    int rowHeight(const QFontMetrics &metrics, const QStringList &cells) const;
+    QFontMetrics createFontMetrics() const;
+    int contentTop(bool firstPage) const;
+    int contentBottom() const;
+
+    // Painting primitives, also used by callers that paginate on their own.
+    // With a cache, cell text is drawn from cached glyph runs (cache of the painting thread).
+    void paintTitleBlock(QPainter *painter) const;
+    void paintHeaderRow(QPainter *painter, int y, ReportTextCache *cache = nullptr) const;
+    void paintRow(QPainter *painter, int y, int height, const QStringList &cells, qsizetype rowIndex,
+                  ReportTextCache *cache = nullptr) const;
+
+    // --- Streaming onto a paged device ---
+    // begin() paints the title block and the first header row, addRow() starts a
+    // new page (with the header row) whenever the row does not fit anymore.
+    bool begin(QPagedPaintDevice *device);
+    bool addRow(const QStringList &cells);
+    bool addRow(const QStringList &cells, int height); // height measured beforehand
+    // Full width band starting a group of rows (e.g. one kelas), never left
+    // alone at the bottom of a page
+    bool addGroupHeader(const QString &label);
+    // A new page with its own title and table (e.g. per group counts),
+    // the page header is repeated if the table does not fit on one page
+    bool addSummaryPage(const QString &title, const QStringList &headers, const QList<QStringList> &rows);
+    bool end();
+
+    int pageCount() const;
+    qsizetype rowCount() const;
+
+private:
+    int measureCell(const QFontMetrics &metrics, const QString &text, int column) const;
+    int measureRow(const QFontMetrics &metrics, const QStringList &cells) const;
+    void setColumns(const QStringList &headers);
+    void paintCells(QPainter *painter, int y, int height, const QStringList &cells,
+                    const QColor &background, const QFont &font, ReportTextCache *cache) const;
+    bool newPage();
+    ReportTextCache *streamTextCache();
+
+    QString m_title;
+    QString m_subtitle;
+    QStringList m_headers;
+    QStringList m_headerLabels; // upper-cased like the HTML report
+    QColor m_headerColor;
+    QColor m_zebraEvenColor;
+    QColor m_zebraOddColor;
+    QFont m_font;
+
+    // Layout
+    QPaintDevice *m_device;
+    QRect m_pageRect;
+    int m_dpiX;
+    int m_dpiY;
+    QFont m_titleFont;
+    QFont m_headerFont;
+    QVector<int> m_columnX; // column edges, size = columns + 1
+    int m_padding;
+    int m_lineWidth;
+    int m_titleHeight;
+    int m_headerHeight;
+
+    // Streaming state
+    QPainter m_painter;
+    ReportTextCache m_textCache;
+    int m_textCacheSize;
+    QPagedPaintDevice *m_pagedDevice;
+    int m_y;
+    int m_rowsOnPage;
+    int m_pageCount;
+    qsizetype m_rowCount;
+};
+
+#endif // REPORTTABLERENDERER_H
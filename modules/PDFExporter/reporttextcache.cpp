@@ -0,0 +1,89 @@
+#include "reporttextcache.h"
+#include <QTextLayout>
+#include <QTextOption>
+
+ReportTextCache::ReportTextCache(int maxEntries)
+    : m_cache(qMax(1, maxEntries))
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+const ReportTextCache::ShapedText *ReportTextCache::shapedText(const QString &text, const QFont &font,
+                                                               const QString &fontKey, int width,
+                                                               QPaintDevice *device)
+{
+    const Key key = {text, fontKey, width};
+
+    if (ShapedText *cached = m_cache.object(key)) {
+        ++m_hits;
+        return cached;
+    }
+
+    ++m_misses;
+    ShapedText *shaped = shape(text, font, width, device);
+
+    // QCache takes ownership; the entry stays valid until the next insert
+    m_cache.insert(key, shaped);
+    return shaped;
+}
+
+QString ReportTextCache::fontKey(const QFont &font, const QPaintDevice *device)
+{
+    // Glyph positions depend on the resolution the text was shaped for
+    return font.key() + QLatin1Char('@') + QString::number(device ? device->logicalDpiY() : 0);
+}
+
+void ReportTextCache::setMaxEntries(int maxEntries)
+{
+    m_cache.setMaxCost(qMax(1, maxEntries));
+}
+
+void ReportTextCache::clear()
+{
+    m_cache.clear();
+    m_hits = 0;
+    m_misses = 0;
+}
+
+qint64 ReportTextCache::hits() const
+{
+    return m_hits;
+}
+
+qint64 ReportTextCache::misses() const
+{
+    return m_misses;
+}
+
+qsizetype ReportTextCache::size() const
+{
+    return m_cache.size();
+}
+
+ReportTextCache::ShapedText *ReportTextCache::shape(const QString &text, const QFont &font, int width,
+                                                    QPaintDevice *device)
+{
+    // Same line breaking as QPainter::drawText(..., Qt::TextWordWrap, ...)
+    QString layoutText = text;
+    layoutText.replace(QLatin1Char('\n'), QChar::LineSeparator);
+
+    QTextLayout layout(layoutText, font, device);
+    QTextOption option(Qt::AlignLeft);
+    option.setWrapMode(QTextOption::WordWrap);
+    layout.setTextOption(option);
+
+    qreal height = 0;
+    layout.beginLayout();
+    for (QTextLine line = layout.createLine(); line.isValid(); line = layout.createLine()) {
+        line.setLineWidth(width);
+        line.setPosition(QPointF(0, height));
+        height += line.height();
+    }
+    layout.endLayout();
+
+    ShapedText *shaped = new ShapedText();
+    shaped->glyphRuns = layout.glyphRuns();
+    shaped->height = height;
+    return shaped;
+}
@@ -0,0 +1,66 @@
+#ifndef REPORTTEXTCACHE_H
+#define REPORTTEXTCACHE_H
+
+#include <QString>
+#include <QList>
+#include <QFont>
+#include <QCache>
+#include <QGlyphRun>
+#include <QPaintDevice>
+#include <QHashFunctions>
+
+// Cell text shaped once with QTextLayout and kept as glyph runs, keyed by
+// (text, font, width). Report cells repeat a lot (kelas values, the header row
+// on every page), drawing a cached run skips shaping and line breaking.
+// Glyph runs hold font engines of the thread that shaped them, so a cache
+// must only be used from one thread at a time (one cache per painting thread).
+class ReportTextCache
+{
+public:
+    struct ShapedText
+    {
+        QList<QGlyphRun> glyphRuns; // positions relative to the top left of the text
+        qreal height = 0;
+    };
+
+    explicit ReportTextCache(int maxEntries = 4096);
+
+    // fontKey identifies font together with the device resolution, see fontKey()
+    const ShapedText *shapedText(const QString &text, const QFont &font, const QString &fontKey,
+                                 int width, QPaintDevice *device);
+
+    static QString fontKey(const QFont &font, const QPaintDevice *device);
+
+    void setMaxEntries(int maxEntries);
+    void clear();
+
+    qint64 hits() const;
+    qint64 misses() const;
+    qsizetype size() const;
+
+private:
+    struct Key
+    {
+        QString text;
+        QString fontKey;
+        int width;
+
+        bool operator==(const Key &other) const
+        {
+            return width == other.width && text == other.text && fontKey == other.fontKey;
+        }
+
+        friend size_t qHash(const Key &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.text, key.fontKey, key.width);
+        }
+    };
+
+    static ShapedText *shape(const QString &text, const QFont &font, int width, QPaintDevice *device);
+
+    QCache<Key, ShapedText> m_cache;
+    qint64 m_hits;
+    qint64 m_misses;
+};
+
+#endif // REPORTTEXTCACHE_H
@@ -0,0 +1,22 @@
+TEMPLATE = app
+TARGET = tst_core
+
+QT += testlib
+QT -= widgets
+
+CONFIG += c++17 console testcase release
+CONFIG -= app_bundle
+
+VERSION += 1.0
+
+DEFINES += APP_NAME=\\\"CRUDMahasiswa\\\"
+DEFINES += APP_VERSION=\\\"$$VERSION\\\"
+
+include(../../../core/corelib.pri)
+
+SOURCES += \
+    ../../../cli/syntheticstudents.cpp \
+    tst_core.cpp
+
+HEADERS += \
+    ../../../cli/syntheticstudents.h
@@ -0,0 +1,399 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QScopedPointer>
+#include "cli/syntheticstudents.h"
+#include "helpers/databasemanager.h"
+#include "modules/CSVExporter/csvexporter.h"
+#include "modules/CSVImporter/csvimporter.h"
+
+// Correctness of the core code: CSV parsing (also against CSVExporter's
+// output and the parallel parser against setThreadCount(1)), the change log
+// behind incremental exports and keyset paging.
+// Every test works on files in its own temporary directory.
+class TestCore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void csvParser_data();
+    void csvParser();
+    void csvRoundTrip();
+    void csvParallelMatchesSerial();
+    void importParallelMatchesSerial();
+
+    void changeLog();
+    void changeLogWatermarkAfterPrune();
+    void changeLogIdleWithoutExport();
+
+    void pagination();
+
+private:
+    bool writeFile(const QString &fileName, const QByteArray &content);
+    QByteArray readFile(const QString &fileName);
+    DatabaseManager *openDatabase();
+    bool insertStudents(const QVector<StudentsDataStruct> &rows);
+    static QStringList formatRows(const QVector<StudentsDataStruct> &rows);
+    // Over 1 MB (the parallel parser's minimum) of rows with every quoting case
+    static QByteArray trickyCsv(int rows);
+
+    QScopedPointer<QTemporaryDir> m_dir;
+    QScopedPointer<DatabaseManager> m_db;
+};
+
+void TestCore::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+void TestCore::cleanup()
+{
+    // Closes the connection before the directory goes
+    m_db.reset();
+    m_dir.reset();
+}
+
+bool TestCore::writeFile(const QString &fileName, const QByteArray &content)
+{
+    QFile file(m_dir->filePath(fileName));
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+QByteArray TestCore::readFile(const QString &fileName)
+{
+    QFile file(m_dir->filePath(fileName));
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+DatabaseManager *TestCore::openDatabase()
+{
+    m_db.reset();
+    m_db.reset(new DatabaseManager(m_dir->filePath("test.db")));
+    return m_db->isDatabaseOpen() ? m_db.get() : nullptr;
+}
+
+bool TestCore::insertStudents(const QVector<StudentsDataStruct> &rows)
+{
+    return m_db->beginTransaction() && m_db->insertStudentsBatch("mahasiswa", rows) && m_db->commitTransaction();
+}
+
+QStringList TestCore::formatRows(const QVector<StudentsDataStruct> &rows)
+{
+    QStringList formatted;
+    for (const StudentsDataStruct &row : rows)
+        formatted << row.nama + '|' + row.npm + '|' + row.kelas;
+    return formatted;
+}
+
+void TestCore::csvParser_data()
+{
+    QTest::addColumn<QByteArray>("content");
+    QTest::addColumn<QString>("delimiter");
+    QTest::addColumn<QStringList>("expected");
+    QTest::addColumn<int>("rejected");
+
+    QTest::newRow("plain") << QByteArray("nama,npm,kelas\nBudi,123,TI-1A\nSari,456,TI-1B\n") << ","
+                           << QStringList { "Budi|123|TI-1A", "Sari|456|TI-1B" } << 0;
+    QTest::newRow("no final line break") << QByteArray("nama,npm,kelas\nBudi,123,TI-1A") << ","
+                                         << QStringList { "Budi|123|TI-1A" } << 0;
+    QTest::newRow("quoted delimiter") << QByteArray("nama,npm,kelas\n\"Budi, S.Kom\",123,TI-1A\n") << ","
+                                      << QStringList { "Budi, S.Kom|123|TI-1A" } << 0;
+    QTest::newRow("escaped quotes") << QByteArray("nama,npm,kelas\n\"Budi \"\"B\"\"\",123,TI-1A\n") << ","
+                                    << QStringList { "Budi \"B\"|123|TI-1A" } << 0;
+    QTest::newRow("line break in quotes") << QByteArray("nama,npm,kelas\n\"Budi\nSantoso\",123,TI-1A\n") << ","
+                                          << QStringList { "Budi\nSantoso|123|TI-1A" } << 0;
+    QTest::newRow("crlf") << QByteArray("nama,npm,kelas\r\nBudi,123,TI-1A\r\nSari,456,TI-1B\r\n") << ","
+                          << QStringList { "Budi|123|TI-1A", "Sari|456|TI-1B" } << 0;
+    QTest::newRow("utf-8 bom") << QByteArray("\xEF\xBB\xBFnama,npm,kelas\nBudi,123,TI-1A\n") << ","
+                               << QStringList { "Budi|123|TI-1A" } << 0;
+    QTest::newRow("exporter layout") << QByteArray("id;nama;npm;kelas\n7;Budi;123;TI-1A\n") << ";"
+                                     << QStringList { "Budi|123|TI-1A" } << 0;
+    QTest::newRow("header order") << QByteArray("kelas,NPM,Nama\nTI-1A,123,Budi\n") << ","
+                                  << QStringList { "Budi|123|TI-1A" } << 0;
+    QTest::newRow("multi-character delimiter") << QByteArray("nama||npm||kelas\nBudi||123||TI-1A\n") << "||"
+                                               << QStringList { "Budi|123|TI-1A" } << 0;
+    QTest::newRow("blank lines") << QByteArray("nama,npm,kelas\n\nBudi,123,TI-1A\n\n") << ","
+                                 << QStringList { "Budi|123|TI-1A" } << 0;
+    QTest::newRow("invalid rows") << QByteArray("nama,npm,kelas\nBudi,12a,TI-1A\n,456,TI-1B\nSari,789\n"
+                                                "Eka,321,TI-2A\n") << ","
+                                  << QStringList { "Eka|321|TI-2A" } << 3;
+    QTest::newRow("stray quote in unquoted field") << QByteArray("nama,npm,kelas\nBudi O\"Neil,123,TI-1A\nSari,456,TI-1B\n")
+                                                   << "," << QStringList { "Budi O\"Neil|123|TI-1A", "Sari|456|TI-1B" } << 0;
+    QTest::newRow("line with only quotes") << QByteArray("nama,npm,kelas\n\"\"\nBudi,123,TI-1A\n") << ","
+                                           << QStringList { "Budi|123|TI-1A" } << 1;
+    QTest::newRow("text after closing quote") << QByteArray("nama,npm,kelas\n\"Budi\"x,123,TI-1A\nSari,456,TI-1B\n")
+                                              << "," << QStringList { "Sari|456|TI-1B" } << 1;
+}
+
+void TestCore::csvParser()
+{
+    QFETCH(QByteArray, content);
+    QFETCH(QString, delimiter);
+    QFETCH(QStringList, expected);
+    QFETCH(int, rejected);
+
+    QVERIFY(writeFile("input.csv", content));
+
+    CSVImporter importer;
+    importer.setDelimiter(delimiter);
+    importer.setFilePath(m_dir->filePath("input.csv"));
+
+    QVector<StudentsDataStruct> rows;
+    QVERIFY2(importer.parseData(rows), qPrintable(importer.getLastError()));
+    QCOMPARE(formatRows(rows), expected);
+    QCOMPARE(importer.getLastStats().rowsRejected, qint64(rejected));
+    QCOMPARE(importer.getLastStats().rowsRead, qint64(expected.size() + rejected));
+}
+
+void TestCore::csvRoundTrip()
+{
+    QVector<StudentsDataStruct> rows = SyntheticStudents().generate(1000);
+    // Fields that need quoting on the way out
+    rows[0].nama = "Budi; \"Santoso\"";
+    rows[1].nama = "Sari\nLestari";
+
+    CSVExporter exporter;
+    exporter.setDelimiter(";");
+    exporter.setFilePath(m_dir->filePath("export.csv"));
+    QVERIFY2(exporter.exportRows(rows, StudentsRowAdapter(), QStringList { "id", "nama", "npm", "kelas" }),
+             qPrintable(exporter.getLastError()));
+
+    CSVImporter importer;
+    importer.setDelimiter(";");
+    importer.setFilePath(m_dir->filePath("export.csv"));
+
+    QVector<StudentsDataStruct> imported;
+    QVERIFY2(importer.parseData(imported), qPrintable(importer.getLastError()));
+    QCOMPARE(importer.getLastStats().rowsRejected, qint64(0));
+    QCOMPARE(formatRows(imported), formatRows(rows));
+}
+
+QByteArray TestCore::trickyCsv(int rows)
+{
+    const QVector<StudentsDataStruct> students = SyntheticStudents().generate(rows);
+
+    QByteArray csv = "nama;npm;kelas\n";
+    for (int i = 0; i < rows; ++i) {
+        const StudentsDataStruct &student = students[i];
+        switch (i % 8) {
+        case 0: // stray quote, flips naive quote parity
+            csv += student.nama.toUtf8() + " O\"Neil;" + student.npm.toUtf8() + ';' + student.kelas.toUtf8() + '\n';
+            break;
+        case 1: // quoted line break
+            csv += '"' + student.nama.toUtf8() + "\nS.Kom\";" + student.npm.toUtf8() + ';' + student.kelas.toUtf8() + '\n';
+            break;
+        case 2: // escaped quotes and a delimiter inside quotes
+            csv += "\"" + student.nama.toUtf8() + " \"\"B; C\"\"\";" + student.npm.toUtf8() + ';'
+                   + student.kelas.toUtf8() + "\r\n";
+            break;
+        case 3: // empty record and blank line
+            csv += "\"\"\n\n" + student.nama.toUtf8() + ';' + student.npm.toUtf8() + ';' + student.kelas.toUtf8() + '\n';
+            break;
+        case 4: // rejected: npm is not numeric
+            csv += student.nama.toUtf8() + ";12x;" + student.kelas.toUtf8() + '\n';
+            break;
+        case 5: // malformed: text after the closing quote
+            csv += '"' + student.nama.toUtf8() + "\"x;" + student.npm.toUtf8() + ';' + student.kelas.toUtf8() + '\n';
+            break;
+        default:
+            csv += student.nama.toUtf8() + ';' + student.npm.toUtf8() + ';' + student.kelas.toUtf8() + '\n';
+            break;
+        }
+    }
+    return csv;
+}
+
+void TestCore::csvParallelMatchesSerial()
+{
+    const QByteArray csv = trickyCsv(60000);
+    QVERIFY(csv.size() > (1 << 20));
+    QVERIFY(writeFile("tricky.csv", csv));
+
+    CSVImporter serial;
+    serial.setDelimiter(";");
+    serial.setFilePath(m_dir->filePath("tricky.csv"));
+    serial.setThreadCount(1);
+
+    QVector<StudentsDataStruct> expected;
+    QVERIFY2(serial.parseData(expected), qPrintable(serial.getLastError()));
+    QVERIFY(serial.getLastStats().rowsRejected > 0);
+
+    for (int threads : { 2, 3, 8 }) {
+        CSVImporter parallel;
+        parallel.setDelimiter(";");
+        parallel.setFilePath(m_dir->filePath("tricky.csv"));
+        parallel.setThreadCount(threads);
+
+        QVector<StudentsDataStruct> rows;
+        QVERIFY2(parallel.parseData(rows), qPrintable(parallel.getLastError()));
+        QCOMPARE(formatRows(rows), formatRows(expected));
+        QCOMPARE(parallel.getLastStats().rowsRead, serial.getLastStats().rowsRead);
+        QCOMPARE(parallel.getLastStats().rowsRejected, serial.getLastStats().rowsRejected);
+        // Same line numbers, so the chunks start where the serial parser's records do
+        QCOMPARE(parallel.getRejectedRows(), serial.getRejectedRows());
+    }
+}
+
+void TestCore::importParallelMatchesSerial()
+{
+    QVERIFY(writeFile("tricky.csv", trickyCsv(60000)));
+
+    auto importWith = [this](int threads, QList<StudentsDataStruct> &imported, CSVImporter::ImportStats &stats) {
+        QVERIFY(openDatabase());
+
+        CSVImporter importer;
+        importer.setDelimiter(";");
+        importer.setFilePath(m_dir->filePath("tricky.csv"));
+        importer.setThreadCount(threads);
+        importer.setBatchSize(1000);
+
+        qint64 progressCalls = 0;
+        connect(&importer, &CSVImporter::importProgress, this, [&progressCalls]() { ++progressCalls; });
+
+        QVERIFY2(importer.importData(m_db.get()), qPrintable(importer.getLastError()));
+        stats = importer.getLastStats();
+        imported = m_db->selectRecords("mahasiswa", QStringList { "id", "nama", "npm", "kelas" });
+        QVERIFY(progressCalls > 0);
+
+        m_db.reset();
+        QVERIFY(QFile::remove(m_dir->filePath("test.db")));
+    };
+
+    QList<StudentsDataStruct> serialRows;
+    CSVImporter::ImportStats serialStats;
+    importWith(1, serialRows, serialStats);
+    if (QTest::currentTestFailed())
+        return;
+
+    QList<StudentsDataStruct> parallelRows;
+    CSVImporter::ImportStats parallelStats;
+    importWith(4, parallelRows, parallelStats);
+    if (QTest::currentTestFailed())
+        return;
+
+    QCOMPARE(parallelStats.rowsInserted, serialStats.rowsInserted);
+    QCOMPARE(parallelStats.rowsRejected, serialStats.rowsRejected);
+    QCOMPARE(formatRows(QVector<StudentsDataStruct>(parallelRows.cbegin(), parallelRows.cend())),
+             formatRows(QVector<StudentsDataStruct>(serialRows.cbegin(), serialRows.cend())));
+}
+
+void TestCore::changeLog()
+{
+    QVERIFY(openDatabase());
+    QVERIFY(insertStudents(SyntheticStudents().generate(10)));
+
+    CSVExporter exporter;
+    exporter.setDelimiter(";");
+
+    // Never run: a successful read with no watermark
+    qint64 watermark = 0;
+    QVERIFY(m_db->exportWatermark("test", watermark));
+    QCOMPARE(watermark, qint64(-1));
+
+    // First run: every row as an insert
+    exporter.setFilePath(m_dir->filePath("changes1.csv"));
+    QVERIFY2(exporter.exportChanges(m_db.get(), "test"), qPrintable(exporter.getLastError()));
+    QCOMPARE(exporter.getLastRowCount(), qint64(10));
+
+    const QList<StudentsDataStruct> before = m_db->selectRecords("mahasiswa", QStringList { "id", "nama", "npm", "kelas" });
+    QCOMPARE(before.size(), 10);
+
+    QVariantMap update { { "npm", "999" } };
+    QVERIFY(m_db->updateRecord("mahasiswa", update, "id = :patokan_id",
+                               QVariantMap { { ":patokan_id", before[2].id } }));
+    QVERIFY(m_db->deleteRecord("mahasiswa", "id = :patokan_id", QVariantMap { { ":patokan_id", before[5].id } }));
+    const qint64 newId = m_db->insertRecord("mahasiswa", QVariantMap { { "nama", "Budi Baru" }, { "npm", "123" },
+                                                                      { "kelas", "TI-1A" } });
+    QVERIFY(newId > 0);
+
+    // Second run: only the three changes, in change order
+    exporter.setFilePath(m_dir->filePath("changes2.csv"));
+    QVERIFY2(exporter.exportChanges(m_db.get(), "test"), qPrintable(exporter.getLastError()));
+    QCOMPARE(exporter.getLastRowCount(), qint64(3));
+
+    const QList<QByteArray> lines = readFile("changes2.csv").trimmed().split('\n');
+    QCOMPARE(lines.size(), 4);
+    QVERIFY(lines[1].startsWith("update;" + QByteArray::number(before[2].id) + ';'));
+    QVERIFY(lines[1].contains(";999;"));
+    QVERIFY(lines[2].startsWith("delete;" + QByteArray::number(before[5].id) + ';'));
+    QVERIFY(lines[3].startsWith("insert;" + QByteArray::number(newId) + ";Budi Baru;"));
+
+    // Third run: nothing changed
+    exporter.setFilePath(m_dir->filePath("changes3.csv"));
+    QVERIFY2(exporter.exportChanges(m_db.get(), "test"), qPrintable(exporter.getLastError()));
+    QCOMPARE(exporter.getLastRowCount(), qint64(0));
+}
+
+void TestCore::changeLogWatermarkAfterPrune()
+{
+    QVERIFY(openDatabase());
+    QVERIFY(insertStudents(SyntheticStudents().generate(5)));
+
+    CSVExporter exporter;
+    exporter.setFilePath(m_dir->filePath("changes.csv"));
+    QVERIFY(exporter.exportChanges(m_db.get(), "test"));
+
+    QVERIFY(m_db->insertRecord("mahasiswa", QVariantMap { { "nama", "Budi Baru" }, { "npm", "123" },
+                                                         { "kelas", "TI-1A" } }) > 0);
+    QVERIFY(exporter.exportChanges(m_db.get(), "test"));
+    qint64 watermark = -1;
+    QVERIFY(m_db->exportWatermark("test", watermark));
+    QVERIFY(watermark > 0);
+
+    // The log is pruned up to the watermark, an idle run must not move it back
+    QVERIFY(exporter.exportChanges(m_db.get(), "test"));
+    qint64 idleWatermark = -1;
+    QVERIFY(m_db->exportWatermark("test", idleWatermark));
+    QCOMPARE(idleWatermark, watermark);
+    QCOMPARE(exporter.getLastRowCount(), qint64(0));
+}
+
+void TestCore::changeLogIdleWithoutExport()
+{
+    QVERIFY(openDatabase());
+    QVERIFY(insertStudents(SyntheticStudents().generate(5)));
+
+    // No export registered: the triggers log nothing, so the first export starts from a snapshot
+    QList<StudentChangeStruct> changes;
+    qint64 upToSeq = -1;
+    QVERIFY(m_db->selectChangesSince("mahasiswa", 0, changes, upToSeq));
+    QVERIFY(changes.isEmpty());
+    QCOMPARE(upToSeq, qint64(0));
+}
+
+void TestCore::pagination()
+{
+    QVERIFY(openDatabase());
+    const QVector<StudentsDataStruct> students = SyntheticStudents().generate(2500);
+    QVERIFY(insertStudents(students));
+
+    QList<StudentsDataStruct> all;
+    QList<int> pageSizes;
+    qint64 afterId = 0;
+
+    while (true) {
+        QList<StudentsDataStruct> page;
+        QVERIFY(m_db->selectRecordsPage("mahasiswa", afterId, 1000, page));
+        pageSizes << page.size();
+        if (page.isEmpty())
+            break;
+
+        QVERIFY(page.first().id > afterId);
+        all.append(page);
+        afterId = page.last().id;
+        if (page.size() < 1000)
+            break;
+    }
+
+    QCOMPARE(pageSizes, (QList<int> { 1000, 1000, 500 }));
+    QCOMPARE(all.size(), students.size());
+    for (qsizetype i = 1; i < all.size(); ++i)
+        QVERIFY(all[i].id > all[i - 1].id);
+    QCOMPARE(formatRows(QVector<StudentsDataStruct>(all.cbegin(), all.cend())), formatRows(students));
+}
+
+QTEST_GUILESS_MAIN(TestCore)
+#include "tst_core.moc"
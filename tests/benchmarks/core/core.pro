@@ -0,0 +1,23 @@
+TEMPLATE = app
+TARGET = tst_bench_core
+
+QT += testlib
+QT -= widgets
+
+# Not a testcase: "make check" stays fast, run it by hand
+CONFIG += c++17 console release
+CONFIG -= app_bundle
+
+VERSION += 1.0
+
+DEFINES += APP_NAME=\\\"CRUDMahasiswa\\\"
+DEFINES += APP_VERSION=\\\"$$VERSION\\\"
+
+include(../../../core/corelib.pri)
+
+SOURCES += \
+    ../../../cli/syntheticstudents.cpp \
+    tst_bench_core.cpp
+
+HEADERS += \
+    ../../../cli/syntheticstudents.h
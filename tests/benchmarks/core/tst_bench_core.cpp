@@ -0,0 +1,341 @@
+#include <QtTest>
+#include <QGuiApplication>
+#include <QSortFilterProxyModel>
+#include <QTemporaryDir>
+#include <QScopedPointer>
+#include "cli/syntheticstudents.h"
+#include "helpers/databasemanager.h"
+#include "models/tablemodel.h"
+#include "modules/CSVExporter/csvexporter.h"
+#include "modules/PDFExporter/pdfexporter.h"
+
+// QBENCHMARK cases of the core code on SyntheticStudents rows, the same
+// cases as "crudmahasiswa-cli bench" but with QtTest's result formats:
+//   ./tst_bench_core -csv -o results.csv,csv
+//   ./tst_bench_core -o results.xml,xml
+// Row counts come from CRUDMAHASISWA_BENCH_ROWS (default: 1000,10000,100000),
+// e.g. CRUDMAHASISWA_BENCH_ROWS=1000000,5000000 for the large runs.
+class BenchCore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void insert_data();
+    void insert();
+    void select_data();
+    void select();
+    void selectPaged_data();
+    void selectPaged();
+    void modelLoad_data();
+    void modelLoad();
+    void modelScroll_data();
+    void modelScroll();
+    void modelFilter_data();
+    void modelFilter();
+    void modelSort_data();
+    void modelSort();
+    void csvExport_data();
+    void csvExport();
+    void pdfRender_data();
+    void pdfRender();
+
+private:
+    void addRowCounts();
+    // Database with rowCount rows and its rows in m_selected, rebuilt when the count changes
+    void prepare(qint64 rowCount);
+    void freshDatabase();
+    bool insertAll(const QVector<StudentsDataStruct> &rows);
+
+    QScopedPointer<QTemporaryDir> m_dir;
+    QScopedPointer<DatabaseManager> m_db;
+    qint64 m_preparedRows = -1;
+    QVector<StudentsDataStruct> m_generated;
+    QList<StudentsDataStruct> m_selected;
+};
+
+namespace {
+// pdf-render is capped like in "crudmahasiswa-cli bench"
+constexpr qint64 PDF_MAX_ROWS = 20000;
+const QStringList COLUMNS { "id", "nama", "npm", "kelas" };
+}
+
+void BenchCore::initTestCase()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+void BenchCore::cleanupTestCase()
+{
+    m_db.reset();
+    m_dir.reset();
+}
+
+void BenchCore::addRowCounts()
+{
+    QTest::addColumn<qint64>("rows");
+
+    const QByteArray counts = qEnvironmentVariableIsSet("CRUDMAHASISWA_BENCH_ROWS")
+                                  ? qgetenv("CRUDMAHASISWA_BENCH_ROWS")
+                                  : QByteArray("1000,10000,100000");
+    for (const QByteArray &count : counts.split(',')) {
+        const qint64 rows = count.trimmed().toLongLong();
+        if (rows > 0)
+            QTest::addRow("%lld", rows) << rows;
+    }
+}
+
+void BenchCore::freshDatabase()
+{
+    m_db.reset(); // closes the default connection before the file goes
+    const QString path = m_dir->filePath("bench.db");
+    QFile::remove(path);
+    QFile::remove(path + "-journal");
+    m_db.reset(new DatabaseManager(path));
+    m_preparedRows = -1;
+}
+
+bool BenchCore::insertAll(const QVector<StudentsDataStruct> &rows)
+{
+    // One transaction, batches like the CSV importer
+    if (!m_db->beginTransaction())
+        return false;
+    for (qsizetype i = 0; i < rows.size(); i += 50000) {
+        if (!m_db->insertStudentsBatch("mahasiswa", rows.mid(i, 50000))) {
+            m_db->rollbackTransaction();
+            return false;
+        }
+    }
+    return m_db->commitTransaction();
+}
+
+void BenchCore::prepare(qint64 rowCount)
+{
+    if (m_preparedRows == rowCount)
+        return;
+
+    m_generated = SyntheticStudents().generate(rowCount);
+    freshDatabase();
+    QVERIFY(m_db->isDatabaseOpen());
+    QVERIFY(insertAll(m_generated));
+    m_selected = m_db->selectRecords("mahasiswa", COLUMNS);
+    QCOMPARE(qint64(m_selected.size()), rowCount);
+    m_preparedRows = rowCount;
+}
+
+void BenchCore::insert_data()
+{
+    addRowCounts();
+}
+
+void BenchCore::insert()
+{
+    QFETCH(qint64, rows);
+    const QVector<StudentsDataStruct> students = SyntheticStudents().generate(rows);
+    freshDatabase();
+
+    // Once: a second run would only hit the UNIQUE constraint
+    bool ok = false;
+    QBENCHMARK_ONCE {
+        ok = insertAll(students);
+    }
+    QVERIFY(ok);
+}
+
+void BenchCore::select_data()
+{
+    addRowCounts();
+}
+
+void BenchCore::select()
+{
+    QFETCH(qint64, rows);
+    prepare(rows);
+
+    QList<StudentsDataStruct> selected;
+    QBENCHMARK {
+        selected = m_db->selectRecords("mahasiswa", COLUMNS);
+    }
+    QCOMPARE(qint64(selected.size()), rows);
+}
+
+void BenchCore::selectPaged_data()
+{
+    addRowCounts();
+}
+
+void BenchCore::selectPaged()
+{
+    QFETCH(qint64, rows);
+    prepare(rows);
+
+    // Same page size as StudentsLoadJob
+    qint64 count = 0;
+    QBENCHMARK {
+        count = 0;
+        qint64 afterId = 0;
+        QList<StudentsDataStruct> page;
+        do {
+            page.clear();
+            m_db->selectRecordsPage("mahasiswa", afterId, 5000, page);
+            count += page.size();
+            if (!page.isEmpty())
+                afterId = page.last().id;
+        } while (page.size() == 5000);
+    }
+    QCOMPARE(count, rows);
+}
+
+void BenchCore::modelLoad_data()
+{
+    addRowCounts();
+}
+
+void BenchCore::modelLoad()
+{
+    QFETCH(qint64, rows);
+    prepare(rows);
+
+    TableModel model;
+    model.setColumns(QStringList() << "Nama" << "NPM" << "Kelas");
+    QBENCHMARK {
+        model.setTableData(m_selected);
+    }
+    QCOMPARE(qint64(model.rowCount()), rows);
+}
+
+void BenchCore::modelScroll_data()
+{
+    addRowCounts();
+}
+
+void BenchCore::modelScroll()
+{
+    QFETCH(qint64, rows);
+    prepare(rows);
+
+    TableModel model;
+    model.setColumns(QStringList() << "Nama" << "NPM" << "Kelas");
+    model.setTableData(m_selected);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    // Every cell once through the proxy, as a view scrolled top to bottom reads them
+    qsizetype characters = 0;
+    QBENCHMARK {
+        characters = 0;
+        const int columnCount = proxy.columnCount();
+        for (int row = 0; row < proxy.rowCount(); ++row) {
+            for (int column = 0; column < columnCount; ++column)
+                characters += proxy.data(proxy.index(row, column)).toString().size();
+        }
+    }
+    QVERIFY(characters > 0);
+}
+
+void BenchCore::modelFilter_data()
+{
+    addRowCounts();
+}
+
+void BenchCore::modelFilter()
+{
+    QFETCH(qint64, rows);
+    prepare(rows);
+
+    TableModel model;
+    model.setColumns(QStringList() << "Nama" << "NPM" << "Kelas");
+    model.setTableData(m_selected);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    QBENCHMARK {
+        proxy.setFilterRegularExpression(QString());
+        proxy.setFilterRegularExpression("Sari");
+    }
+    QVERIFY(proxy.rowCount() <= rows);
+}
+
+void BenchCore::modelSort_data()
+{
+    addRowCounts();
+}
+
+void BenchCore::modelSort()
+{
+    QFETCH(qint64, rows);
+    prepare(rows);
+
+    TableModel model;
+    model.setColumns(QStringList() << "Nama" << "NPM" << "Kelas");
+    model.setTableData(m_selected);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    QBENCHMARK {
+        proxy.sort(-1);
+        proxy.sort(0, Qt::AscendingOrder);
+    }
+    QCOMPARE(qint64(proxy.rowCount()), rows);
+}
+
+void BenchCore::csvExport_data()
+{
+    addRowCounts();
+}
+
+void BenchCore::csvExport()
+{
+    QFETCH(qint64, rows);
+    prepare(rows);
+
+    CSVExporter exporter;
+    exporter.setDelimiter(";");
+    exporter.setFilePath(m_dir->filePath("bench.csv"));
+
+    bool ok = false;
+    QBENCHMARK {
+        ok = exporter.exportRows(m_selected, StudentsRowAdapter(), COLUMNS);
+    }
+    QVERIFY2(ok, qPrintable(exporter.getLastError()));
+}
+
+void BenchCore::pdfRender_data()
+{
+    addRowCounts();
+}
+
+void BenchCore::pdfRender()
+{
+    QFETCH(qint64, rows);
+    prepare(rows);
+
+    const qint64 pdfRows = qMin(rows, PDF_MAX_ROWS);
+    PDFExporter exporter;
+    exporter.setTitle("Benchmark");
+    exporter.setTableHeaders(COLUMNS);
+    exporter.setTableRows(m_selected.mid(0, pdfRows), StudentsRowAdapter());
+
+    bool ok = false;
+    QBENCHMARK {
+        ok = exporter.exportToPdf(m_dir->filePath("bench.pdf"));
+    }
+    QVERIFY(ok);
+}
+
+// PDF text shaping needs a QGuiApplication, the offscreen plugin is enough without a display
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+    BenchCore benchmark;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "tst_bench_core.moc"
@@ -0,0 +1,9 @@
+# Qt Test targets, built by CRUDMahasiswaHeadless.pro and run with "make check".
+#   auto        correctness: CSV parser, change log, pagination
+#   benchmarks  QBENCHMARK cases, e.g. ./tst_bench_core -csv -o results.csv,csv
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    auto/core \
+    benchmarks/core
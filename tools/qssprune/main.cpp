@@ -0,0 +1,40 @@
+#include "../../helpers/stylesheet.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QSaveFile>
+#include <QTextStream>
+
+// Writes <output.qss>: the generated header (rule counts and dropped classes,
+// read back by AppStyle::loadStyleSheet) followed by the pruned rules.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    QTextStream err(stderr);
+
+    if (args.size() != 3) {
+        err << "usage: qssprune <input.qss> <output.qss>" << Qt::endl;
+        return 2;
+    }
+
+    QFile input(args.at(1));
+    if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        err << "error: cannot read " << args.at(1) << ": " << input.errorString() << Qt::endl;
+        return 1;
+    }
+
+    AppStyle::PruneStats stats;
+    const QString pruned = AppStyle::pruneStyleSheet(QString::fromUtf8(input.readAll()),
+                                                     AppStyle::usedWidgetClasses(), &stats);
+
+    QSaveFile output(args.at(2));
+    const QByteArray data = (AppStyle::generatedHeader(stats) + pruned).toUtf8();
+    if (!output.open(QIODevice::WriteOnly) || output.write(data) != data.size() || !output.commit()) {
+        err << "error: cannot write " << args.at(2) << ": " << output.errorString() << Qt::endl;
+        return 1;
+    }
+
+    err << "qssprune: " << stats.keptRules << " of " << stats.rules << " rules, " << stats.outputBytes
+        << " of " << stats.inputBytes << " bytes, dropped " << stats.droppedClasses.join(' ') << Qt::endl;
+    return 0;
+}
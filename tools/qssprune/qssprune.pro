@@ -0,0 +1,18 @@
+# Build-time helper of tutorialCRUDMahasiswa.pro: prunes darkstyle.qss down to
+# the rules of the widget classes the application creates (helpers/stylesheet.h).
+#   qssprune <input.qss> <output.qss>
+
+TEMPLATE = app
+TARGET = qssprune
+
+QT -= gui widgets
+
+CONFIG += c++17 console release
+CONFIG -= app_bundle debug_and_release
+
+SOURCES += \
+    ../../helpers/stylesheet.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../helpers/stylesheet.h
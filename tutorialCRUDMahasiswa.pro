@@ -1,4 +1,4 @@
-QT       += core gui sql printsupport
+QT       += core gui sql printsupport concurrent
 QT       -= network svg xml dbus virtualkeyboard quick qml
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
@@ -20,22 +20,28 @@ VERSION += 1.0
 DEFINES += APP_NAME=\\\"CRUDMahasiswa\\\"
 DEFINES += APP_VERSION=\\\"$$VERSION\\\"
 
-include(modules/CSVExporter/CSVExporter.pri)
-include(modules/PDFExporter/PDFExporter.pri)
+# Database, model and exporters (also built headless, see CRUDMahasiswaHeadless.pro)
+include(core/core.pri)
+include(modules/PDFExporter/PDFExporterPreview.pri)
 
 SOURCES += \
     dialogs/AboutDialog/aboutdialog.cpp \
-    helpers/databasemanager.cpp \
+    dialogs/PerfHudDock/perfhuddock.cpp \
+    dialogs/QueryStatsDialog/querystatsdialog.cpp \
+    helpers/pixmapcache.cpp \
+    helpers/stylecoverage.cpp \
+    helpers/stylesheet.cpp \
     main.mm \
-    mainwindow.cpp \
-    models/tablemodel.cpp
+    mainwindow.cpp
 
 HEADERS += \
-    helpers/Environments.h \
     dialogs/AboutDialog/aboutdialog.h \
-    helpers/databasemanager.h \
-    mainwindow.h \
-    models/tablemodel.h
+    dialogs/PerfHudDock/perfhuddock.h \
+    dialogs/QueryStatsDialog/querystatsdialog.h \
+    helpers/pixmapcache.h \
+    helpers/stylecoverage.h \
+    helpers/stylesheet.h \
+    mainwindow.h
 
 FORMS += \
     dialogs/AboutDialog/aboutdialog.ui \
@@ -52,3 +58,35 @@ DISTFILES += \
 RESOURCES += \
     Res.qrc \
     darkcss/darkstyle.qrc
+
+# darkstyle.qss dipangkas saat build oleh tools/qssprune (lihat helpers/stylesheet.h),
+# hasilnya di-compile rcc menjadi resource :/qdarkstyle/dark/darkstyle.pruned.qss
+QSSPRUNE_DIR = $$OUT_PWD/qssprune
+QSSPRUNE = $$QSSPRUNE_DIR/qssprune
+win32: QSSPRUNE = $${QSSPRUNE}.exe
+
+qssprune_tool.target = $$QSSPRUNE
+qssprune_tool.commands = $(MKDIR) $$shell_path($$QSSPRUNE_DIR) && cd $$shell_path($$QSSPRUNE_DIR) \
+                         && $(QMAKE) $$shell_path($$PWD/tools/qssprune/qssprune.pro) && $(MAKE)
+qssprune_tool.depends = $$PWD/tools/qssprune/main.cpp $$PWD/helpers/stylesheet.cpp $$PWD/helpers/stylesheet.h
+QMAKE_EXTRA_TARGETS += qssprune_tool
+
+PRUNED_QSS_DIR = $$OUT_PWD/darkcss
+PRUNED_QRC = $$PRUNED_QSS_DIR/darkstyle_pruned.qrc
+PRUNED_QRC_CONTENT = \
+    "<RCC>" \
+    "    <qresource prefix='/qdarkstyle/dark'>" \
+    "        <file>darkstyle.pruned.qss</file>" \
+    "    </qresource>" \
+    "</RCC>"
+!write_file($$PRUNED_QRC, PRUNED_QRC_CONTENT): error("Cannot write $$PRUNED_QRC")
+
+qtPrepareTool(QMAKE_RCC, rcc)
+QSS_SOURCES = darkcss/darkstyle.qss
+qssprune.input = QSS_SOURCES
+qssprune.output = $$OUT_PWD/qrc_${QMAKE_FILE_BASE}_pruned.cpp
+qssprune.commands = $$shell_path($$QSSPRUNE) ${QMAKE_FILE_IN} $$shell_path($$PRUNED_QSS_DIR/darkstyle.pruned.qss) \
+                    && $$QMAKE_RCC -name darkstyle_pruned $$shell_path($$PRUNED_QRC) -o ${QMAKE_FILE_OUT}
+qssprune.depends = $$QSSPRUNE
+qssprune.variable_out = SOURCES
+QMAKE_EXTRA_COMPILERS += qssprune